@@ -2,6 +2,7 @@
 #define MLCORE_IBINARYOPERATOR_H
 
 #include <optional>
+#include <stdexcept>
 
 #include <AutoDiff/GraphNodes.hpp>
 
@@ -14,6 +15,9 @@ namespace mlCore::autoDiff::binaryOperators
 class BinaryOperator : public Node
 {
 public:
+	/// Derivatives with respect to the left and right input, present only for the inputs requiring them.
+	using RequiredDerivatives = std::pair<std::optional<Tensor>, std::optional<Tensor>>;
+
 	BinaryOperator(const NodePtr lhsInput, const NodePtr rhsInput)
 		: Node(std::vector<size_t>{})
 		, lhsInput_(lhsInput)
@@ -43,6 +47,72 @@ public:
 	 */
 	virtual std::pair<Tensor, Tensor> computeDirectDerivative() const = 0;
 
+	/**
+	 * @brief Computes the derivatives like computeDerivative, but only with respect to the selected inputs, so that no
+	 * work is spent on inputs not requiring gradient. The default implementation computes both of the derivatives and
+	 * drops the unneeded ones.
+	 * 
+	 * @param outerDerivative The derivative of outer expression with respect to the operator.
+	 * @param isLhsRequired Tells whether the derivative with respect to the left input should be computed.
+	 * @param isRhsRequired Tells whether the derivative with respect to the right input should be computed.
+	 * @return Derivatives with respect to the selected inputs.
+	 */
+	virtual RequiredDerivatives
+	computeRequiredDerivatives(const Tensor& outerDerivative, const bool isLhsRequired, const bool isRhsRequired) const
+	{
+		auto [lhsDerivative, rhsDerivative] = computeDerivative(outerDerivative);
+
+		RequiredDerivatives derivatives;
+
+		if(isLhsRequired)
+		{
+			derivatives.first = std::move(lhsDerivative);
+		}
+
+		if(isRhsRequired)
+		{
+			derivatives.second = std::move(rhsDerivative);
+		}
+
+		return derivatives;
+	}
+
+	/**
+	 * @brief Computes the value of the operator from the given values of its inputs, without modifying the node. Lets
+	 * the values of concurrent runs of the graph be kept outside of the nodes, see ExecutionContext. The default
+	 * implementation throws std::runtime_error, so operators not overriding it can be run only through updateValue.
+	 * 
+	 * @param lhsValue Value of the left input.
+	 * @param rhsValue Value of the right input.
+	 * @return Value of the operator.
+	 */
+	virtual Tensor computeValue(const Tensor& /*lhsValue*/, const Tensor& /*rhsValue*/) const
+	{
+		throw std::runtime_error("The operator cannot be computed from external values.");
+	}
+
+	/**
+	 * @brief Computes the derivatives like computeRequiredDerivatives, but from the given values of the inputs and of
+	 * the operator instead of the ones stored in the nodes. The default implementation throws std::runtime_error.
+	 * 
+	 * @param outerDerivative The derivative of outer expression with respect to the operator.
+	 * @param lhsValue Value of the left input.
+	 * @param rhsValue Value of the right input.
+	 * @param value Value of the operator computed from the inputs' values.
+	 * @param isLhsRequired Tells whether the derivative with respect to the left input should be computed.
+	 * @param isRhsRequired Tells whether the derivative with respect to the right input should be computed.
+	 * @return Derivatives with respect to the selected inputs.
+	 */
+	virtual RequiredDerivatives computeInputDerivatives(const Tensor& /*outerDerivative*/,
+														const Tensor& /*lhsValue*/,
+														const Tensor& /*rhsValue*/,
+														const Tensor& /*value*/,
+														bool /*isLhsRequired*/,
+														bool /*isRhsRequired*/) const
+	{
+		throw std::runtime_error("The operator cannot be differentiated with external values.");
+	}
+
 	std::pair<NodePtr, NodePtr> getInputs() const
 	{
 		return {lhsInput_, rhsInput_};
@@ -16,6 +16,18 @@ public:
 	std::pair<Tensor, Tensor> computeDerivative(const Tensor& outerDerivative) const override;
 
 	std::pair<Tensor, Tensor> computeDirectDerivative() const override;
+
+	RequiredDerivatives
+	computeRequiredDerivatives(const Tensor& outerDerivative, bool isLhsRequired, bool isRhsRequired) const override;
+
+	Tensor computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const override;
+
+	RequiredDerivatives computeInputDerivatives(const Tensor& outerDerivative,
+												const Tensor& lhsValue,
+												const Tensor& rhsValue,
+												const Tensor& value,
+												bool isLhsRequired,
+												bool isRhsRequired) const override;
 };
 
 using MatmulOperatorPtr = std::shared_ptr<MatmulOperator>;
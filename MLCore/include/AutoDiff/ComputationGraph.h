@@ -1,14 +1,45 @@
 #ifndef MLCORE_COMPUTATIONGRAPH_H
 #define MLCORE_COMPUTATIONGRAPH_H
 
+#include <AutoDiff/ExecutionContext.h>
+#include <AutoDiff/ExecutionPlan.h>
 #include <AutoDiff/GraphNodes.hpp>
+#include <AutoDiff/PlanCache.h>
+#include <MLCore/Allocators/IAllocator.hpp>
+#include <Utilities/ThreadPool.h>
+#include <functional>
 #include <map>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mlCore::autoDiff
 {
 
+/// Node paired with the gradient computed with respect to it.
+using NodeGradient = std::pair<NodePtr, std::reference_wrapper<const Tensor>>;
+
+/**
+ * @brief Rewrites applied to the ExecutionPlan when the graph is compiled, in the order of the fields. All of them are
+ * disabled by default.
+ */
+struct CompileOptions
+{
+	/// Computes the operators depending only on constants once, see ExecutionPlan::foldConstants.
+	bool foldConstants = false;
+	/// Removes the duplicated operators, see ExecutionPlan::eliminateCommonSubexpressions.
+	bool eliminateCommonSubexpressions = false;
+	/// Replaces the chains of elementwise operators with fused instructions, see ExecutionPlan::fuseElementwise.
+	bool fuseElementwise = false;
+
+	/// Tells whether any of the rewrites is enabled.
+	bool isRewriting() const noexcept
+	{
+		return foldConstants || eliminateCommonSubexpressions || fuseElementwise;
+	}
+};
+
 /**
  * @brief Class used to build tree of Nodes. Stores information about all of the parts 
  * used in complex operation and can therefore accurately compute gradients. 
@@ -40,20 +71,13 @@ public:
 	 * @brief Erases all graph structure nodes
 	 * 
 	 */
-	inline void reset() noexcept
-	{
-		nodes_.clear();
-		gradients_.clear();
-	}
+	void reset() noexcept;
 
 	/**
      * @brief Cleans the graph from cumulated gradient.
      * 
      */
-	inline void clearGradients()
-	{
-		gradients_.clear();
-	}
+	void clearGradients();
 
 	/**
 	 * @brief Enables adding nodes to the graph by friend Operations classes
@@ -74,14 +98,158 @@ public:
 	}
 
 	/**
-	 * @brief Tells if there is computed gradient with certain name
+	 * @brief Sets the allocator providing memory for the tensors created during forward passes and gradient computation.
+	 * Passing nullptr makes the graph use the allocator current for the calling thread, which is the default. The
+	 * cached plans are dropped, since their buffers are taken from the previous allocator.
+	 * 
+	 * @param allocator Allocator to be used, e.g. allocators::PoolAllocator.
+	 */
+	inline void setAllocator(allocators::AllocatorPtr allocator) noexcept
+	{
+		allocator_ = std::move(allocator);
+		planCache_.clear();
+	}
+
+	/// Gets the allocator set with setAllocator.
+	inline const allocators::AllocatorPtr& getAllocator() const noexcept
+	{
+		return allocator_;
+	}
+
+	/**
+	 * @brief Sets the pool running independent operators of the graph concurrently during forward passes and gradient
+	 * computation. Passing nullptr makes the operators run one after another, which is the default.
+	 * 
+	 * @param threadPool Pool used for the inter-op parallelism.
+	 */
+	inline void setInterOpThreadPool(std::shared_ptr<utilities::ThreadPool> threadPool) noexcept
+	{
+		interOpThreadPool_ = std::move(threadPool);
+	}
+
+	/// Gets the pool set with setInterOpThreadPool.
+	inline const std::shared_ptr<utilities::ThreadPool>& getInterOpThreadPool() const noexcept
+	{
+		return interOpThreadPool_;
+	}
+
+	/**
+	 * @brief Sets the pool the tensor kernels of the operators split their work onto, independently of the inter-op
+	 * pool. Passing nullptr makes the graph use the pool current for the calling thread, which is the default.
+	 * 
+	 * @param threadPool Pool used for the intra-op parallelism.
+	 */
+	inline void setIntraOpThreadPool(std::shared_ptr<utilities::ThreadPool> threadPool) noexcept
+	{
+		intraOpThreadPool_ = std::move(threadPool);
+	}
+
+	/// Gets the pool set with setIntraOpThreadPool.
+	inline const std::shared_ptr<utilities::ThreadPool>& getIntraOpThreadPool() const noexcept
+	{
+		return intraOpThreadPool_;
+	}
+
+	/**
+	 * @brief Sets the profiler recording the operators run by the forward passes and gradient computation, including
+	 * the ones run with contexts. The bytes allocated by the operators are counted only while the profiler is set.
+	 * Passing nullptr disables the profiling, which is the default and costs nothing more than a check per operator.
+	 * 
+	 * @param profiler Profiler collecting the events, which can be shared by many graphs.
+	 */
+	inline void setProfiler(std::shared_ptr<GraphProfiler> profiler) noexcept
+	{
+		profiler_ = std::move(profiler);
+
+		if(plan_)
+		{
+			plan_->setProfiler(profiler_);
+		}
+	}
+
+	/// Gets the profiler set with setProfiler.
+	inline const std::shared_ptr<GraphProfiler>& getProfiler() const noexcept
+	{
+		return profiler_;
+	}
+
+	/**
+	 * @brief Sets the rewrites applied to the plan by the next compilation. The compiled plan is dropped, so the graph
+	 * is compiled again before the next pass.
+	 * 
+	 * @param options Rewrites to be applied.
+	 */
+	inline void setCompileOptions(const CompileOptions& options) noexcept
+	{
+		compileOptions_ = options;
+		plan_.reset();
+	}
+
+	/// Gets the options set with setCompileOptions.
+	inline const CompileOptions& getCompileOptions() const noexcept
+	{
+		return compileOptions_;
+	}
+
+	/**
+	 * @brief Makes the forward passes keeping the values in the nodes run only the operators depending on the nodes
+	 * changed since the previous pass. The placeholders fed with values different from their current ones are changed,
+	 * while the other nodes have to be marked with Node::setValue or Node::markChanged, e.g. the variables updated by an
+	 * optimizer. Disabled by default.
+	 * 
+	 * @param isIncremental Tells whether the passes should be incremental.
+	 */
+	inline void setIncrementalForward(const bool isIncremental) noexcept
+	{
+		isIncrementalForward_ = isIncremental;
+		nodeVersions_.clear();
+	}
+
+	/// Tells whether the forward passes are incremental, see setIncrementalForward.
+	inline bool isIncrementalForward() const noexcept
+	{
+		return isIncrementalForward_;
+	}
+
+	/**
+	 * @brief Makes the passes keeping the values in the nodes drop the operators' values and gradients once they are no
+	 * longer needed, see ExecutionContext::setLivenessMode. The dropped values are replaced with empty scalars, so the
+	 * forward passes run all operators, even if they are incremental. The runs with contexts use the contexts' modes.
+	 * std::nullopt keeps all values, which is the default.
+	 *
+	 * Given a mode, the forward passes look up the ShapedPlan of the fed shapes, see getShapedPlan, and compute the
+	 * operators' values in its buffers. The values whose lifetimes do not overlap share a buffer and the next passes with
+	 * the same shapes, or shapes padded to the same bucket, reuse the buffers instead of allocating new memory.
+	 * 
+	 * @param mode Mode selecting the kept values.
+	 */
+	inline void setLivenessMode(const std::optional<LivenessMode> mode) noexcept
+	{
+		livenessMode_ = mode;
+
+		if(plan_)
+		{
+			plan_->setLivenessMode(livenessMode_);
+		}
+	}
+
+	/// Gets the mode set with setLivenessMode.
+	inline std::optional<LivenessMode> getLivenessMode() const noexcept
+	{
+		return livenessMode_;
+	}
+
+	/**
+	 * @brief Tells if there is computed gradient with certain name. The names are looked up in a table refreshed when
+	 * a name is not found in it, so the nodes can be renamed after being added to the graph.
 	 * 
 	 * @param nodeName 
 	 */
 	bool hasGradient(const std::string& nodeName) const;
 
 	/**
-	 * @brief Gets gradient connected with the node with given name
+	 * @brief Gets gradient connected with the node with given name. Throws std::runtime_error if there is no such
+	 * gradient.
 	 * 
 	 * @param nodeName
 	 */
@@ -95,41 +263,171 @@ public:
 	bool hasGradient(const size_t& nodeId) const;
 
 	/**
-	 * @brief Gets gradient connected with the node with given id
+	 * @brief Gets gradient connected with the node with given id. Throws std::runtime_error if there is no such gradient.
 	 * 
 	 * @param nodeId
 	 */
 	const Tensor& getGradientByNodeId(const size_t& nodeId) const;
 
+	/**
+	 * @brief Gets all of the computed gradients at once, in the order the nodes have been added to the graph. Meant for
+	 * optimizers updating many variables, which can avoid looking up each gradient separately.
+	 * 
+	 * @return Pairs of nodes and their gradients. The references are valid until the gradients are cleared or computed.
+	 */
+	std::vector<NodeGradient> getGradients() const;
+
+	/**
+	 * @brief Sorts the nodes and lowers them to the ExecutionPlan run by the forward and backward passes. The passes
+	 * compile the graph themselves if its structure has changed, so the function only needs to be called to take the
+	 * cost out of the first pass or to inspect the plan.
+	 *
+	 * @return Plan valid until the next node is added or the graph is reset.
+	 */
+	const ExecutionPlan& compile();
+
+	/**
+	 * @brief Estimates the memory of the operators' values for the next run, without running the graph. The shapes of
+	 * the values are inferred from the shapes of the leaves, see ExecutionPlan::inferShapes and
+	 * ExecutionPlan::estimateMemory. The estimates are cached, see getShapedPlan.
+	 * 
+	 * @param mode Tells whether the values are needed by the backward pass.
+	 * @param placeholderShapes Shapes of the placeholders' values fed in the next run. The other placeholders keep the
+	 * shapes of their current values.
+	 * @return Estimated peak and total numbers of bytes of the values, together with their sharing of the buffers.
+	 */
+	MemoryEstimate estimateMemory(LivenessMode mode,
+								  const std::map<PlaceholderPtr, std::vector<size_t>>& placeholderShapes = {});
+
+	/**
+	 * @brief Gets the inferred shapes, the memory estimate and the buffers for the shapes of the placeholders, looking
+	 * them up in the graph's PlanCache first. The leading dimensions of the given shapes are padded to the cache's
+	 * buckets, so the result is the one of the bucket. The cache is cleared whenever the graph's structure changes, while
+	 * the shapes of the other leaves are assumed to be fixed. The forward passes run with a liveness mode look up the
+	 * plans of the fed shapes the same way, see setLivenessMode.
+	 * 
+	 * @param mode Tells whether the values are needed by the backward pass.
+	 * @param placeholderShapes Shapes of the placeholders' values fed in the next run, e.g. of the batched inputs. The
+	 * other placeholders keep the shapes of their current values, which are not padded.
+	 * @return Plan valid until the next lookup or until the graph is changed.
+	 */
+	const ShapedPlan& getShapedPlan(LivenessMode mode,
+									const std::map<PlaceholderPtr, std::vector<size_t>>& placeholderShapes = {});
+
+	/**
+	 * @brief Sets the capacity and the batch buckets of the cache used by getShapedPlan and estimateMemory, dropping the
+	 * cached plans. By default the cache keeps 16 plans and pads no shapes.
+	 * 
+	 * @param options Options of the cache.
+	 */
+	inline void setPlanCacheOptions(PlanCacheOptions options)
+	{
+		planCache_.setOptions(std::move(options));
+	}
+
+	/// Gets the cache of the shape-dependent plans, e.g. to inspect its hits and misses.
+	inline const PlanCache& getPlanCache() const noexcept
+	{
+		return planCache_;
+	}
+
 	/**
 	 * @brief Goes through the graph starting from the primary leaves
 	 * 
 	 * @param feedDict Stores values that should fill chosen placeholders. If not given, placeholders keep their old values.
+	 * @param isFull Forces running all operators, even if the passes are incremental (see setIncrementalForward).
 	 */
-	void forwardPass(const std::map<PlaceholderPtr, Tensor>& feedDict = {});
+	void forwardPass(const std::map<PlaceholderPtr, Tensor>& feedDict = {}, bool isFull = false);
 
 	/**
 	 * @brief Goes through the graph starting from the root and perform backward propagation
 	 * 
-	 * @param root Starting node - the back-propagation will occur relatively to it
+	 * @param root Starting node - the back-propagation will occur relatively to it. Has to be a part of the graph.
+	 * @param wrt Nodes the gradients are requested for. Only the part of the graph between them and the root is visited.
+	 * If empty, the gradients are computed for all nodes requiring gradient (see Node::requiresGrad).
+	 */
+	void computeGradients(NodePtr root, const std::vector<NodePtr>& wrt = {});
+
+	/**
+	 * @brief Runs the forward pass keeping the values in the context instead of the nodes, so that many threads can run
+	 * the graph at once, each one with its own context. The graph has to be compiled beforehand and must not be
+	 * modified while it is run. Throws std::runtime_error if the graph is not compiled.
+	 * 
+	 * @param context Context keeping the values of the run. Can be reused by the next runs of the graph.
+	 * @param feedDict Values of the placeholders, set only in the context.
+	 */
+	void forwardPass(ExecutionContext& context, const std::map<PlaceholderPtr, Tensor>& feedDict = {}) const;
+
+	/**
+	 * @brief Performs back propagation using the values computed by forwardPass with the same context. The gradients
+	 * are accumulated in the context. Throws std::runtime_error if the graph is not compiled.
+	 * 
+	 * @param context Context the forward pass has been run with.
+	 * @param root Starting node - the back-propagation will occur relatively to it. Has to be a part of the graph.
+	 * @param wrt Nodes the gradients are requested for. If empty, the gradients are computed for all nodes requiring
+	 * gradient.
 	 */
-	void computeGradients(NodePtr root);
+	void computeGradients(ExecutionContext& context, NodePtr root, const std::vector<NodePtr>& wrt = {}) const;
 
 	/**
-	 * @brief Adds new node to the graph.
+	 * @brief Adds new node to the graph. A node added after its inputs is appended to the compiled plan, otherwise the
+	 * nodes are sorted again before the next pass. Adding a node which is already a part of the graph has no effect.
 	 * 
 	 * @param node Node to be added.
 	 */
 	void addNode(NodePtr node);
 
 private:
-	void _sortNodes();
+	/// Gives the node the next index in the graph and registers it in the lookup tables.
+	void _indexNode(const NodePtr& node);
+
+	/**
+	 * @brief Orders the nodes so that each one comes after its inputs. The inputs missing in the graph are indexed as
+	 * well.
+	 * 
+	 * @return Indices of the nodes in the topological order.
+	 */
+	std::vector<size_t> _sortNodes();
+
+	/// Gets the shaped plan of the placeholders' values fed to the forward pass, see getShapedPlan.
+	const ShapedPlan& _getFedShapedPlan(LivenessMode mode, const std::map<PlaceholderPtr, Tensor>& feedDict);
+
+	/// Gets the compiled plan for the runs not modifying the graph. Throws std::runtime_error if there is none.
+	const ExecutionPlan& _getCompiledPlan() const;
+
+	/// Gets the plan's slots of the root and of the nodes the gradients are requested for.
+	std::pair<size_t, std::vector<size_t>>
+	_getBackwardSlots(const ExecutionPlan& plan, const NodePtr& root, const std::vector<NodePtr>& wrt) const;
+
+	/// Gets index of the gradient's slot of the node with given name or std::nullopt if there is no such gradient.
+	std::optional<size_t> _findGradientByName(const std::string& nodeName) const;
+
+	/// Gets index of the gradient's slot of the node with given id or std::nullopt if there is no such gradient.
+	std::optional<size_t> _findGradientById(size_t nodeId) const;
+
+	/// Gets the slot keeping the gradient of the node with given index, i.e. the slot of its duplicate if it has been
+	/// removed from the compiled plan.
+	size_t _getGradientSlot(size_t nodeIndex) const;
 
 private:
 	bool isActive_ = false;
+	// nodes are kept in the order they have been added, their positions are the slots of the ExecutionPlan
 	std::vector<NodePtr> nodes_ = {};
-	std::map<NodePtr, Tensor> gradients_ = {};
-	bool areNodesSorted_ = true;
+	std::unordered_map<const Node*, size_t> nodeIndices_ = {};
+	std::unordered_map<uint64_t, size_t> idIndices_ = {};
+	mutable std::unordered_map<std::string, size_t> nameIndices_ = {};
+	std::vector<std::optional<Tensor>> gradients_ = {};
+	std::optional<ExecutionPlan> plan_ = std::nullopt;
+	PlanCache planCache_ = PlanCache();
+	CompileOptions compileOptions_ = {};
+	bool isIncrementalForward_ = false;
+	// versions of the nodes seen by the last incremental pass, empty if the next pass has to be full
+	std::vector<uint64_t> nodeVersions_ = {};
+	std::optional<LivenessMode> livenessMode_ = std::nullopt;
+	allocators::AllocatorPtr allocator_ = nullptr;
+	std::shared_ptr<utilities::ThreadPool> interOpThreadPool_ = nullptr;
+	std::shared_ptr<utilities::ThreadPool> intraOpThreadPool_ = nullptr;
+	std::shared_ptr<GraphProfiler> profiler_ = nullptr;
 };
 } // namespace mlCore::autoDiff
 
@@ -0,0 +1,137 @@
+#ifndef AUTODIFF_EXECUTIONCONTEXT_H
+#define AUTODIFF_EXECUTIONCONTEXT_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <AutoDiff/GraphNodes.hpp>
+
+namespace mlCore::autoDiff
+{
+class ExecutionPlan;
+enum class LivenessMode : uint8_t;
+
+/**
+ * @brief Selects the operators whose values are kept by the forward passes run with checkpointing, see
+ * ExecutionContext::setCheckpointing.
+ */
+enum class CheckpointPolicy : uint8_t
+{
+	/// All values are kept, no checkpointing is done.
+	NONE,
+	/// The values of the nodes given explicitly are kept.
+	MANUAL,
+	/// The values of every ceil(sqrt(n))-th of the n operators are kept.
+	SQRT_N
+};
+
+/**
+ * @brief State of a single run of a ComputationGraph, i.e. the values of the placeholders and operators and the computed
+ * gradients. The nodes are not modified by the runs using a context, so many threads can run the same compiled graph at
+ * once, each one with its own context. The values of variables and constants are read from the nodes.
+ *
+ * A context is bound to the graph's plan on its first run and can be reused by the next runs of the same graph. The
+ * buffers are then replaced in place, so combined with a pooling allocator the steady-state runs reuse the memory of the
+ * previous ones.
+ */
+class ExecutionContext
+{
+public:
+	ExecutionContext() = default;
+
+	ExecutionContext(const ExecutionContext&) = delete;			   // Copy ctor
+	ExecutionContext(ExecutionContext&&) = default;				   // Move ctor
+	ExecutionContext& operator=(const ExecutionContext&) = delete; // Copy assign
+	ExecutionContext& operator=(ExecutionContext&&) = default;	   // Move assign
+
+	~ExecutionContext() = default;
+
+	/**
+	 * @brief Sets the value of the placeholder used by the runs with the context. The placeholder's own value is not
+	 * modified. Throws std::runtime_error if the context has not been bound to a graph containing the placeholder.
+	 *
+	 * @param placeholder Placeholder to be fed.
+	 * @param value Value of the placeholder.
+	 */
+	void feed(const PlaceholderPtr& placeholder, Tensor value);
+
+	/**
+	 * @brief Gets the value of the node computed in the context. Variables, constants and placeholders not fed in the
+	 * context have their own values. Throws std::runtime_error if the node is an operator which has not been computed
+	 * in the context or is not a part of the bound graph.
+	 *
+	 * @param node Node of the graph the context is bound to.
+	 */
+	const Tensor& getValue(const NodePtr& node) const;
+
+	/// Tells whether there is a gradient computed in the context with respect to the node.
+	bool hasGradient(const NodePtr& node) const;
+
+	/// Gets the gradient computed in the context with respect to the node. Throws std::runtime_error if there is none.
+	const Tensor& getGradient(const NodePtr& node) const;
+
+	/// Drops the accumulated gradients.
+	void clearGradients();
+
+	/**
+	 * @brief Makes the forward passes drop the operators' values once they are no longer needed, so that the memory
+	 * of the dead values is reused by the next operators. In the inference mode only the graph's outputs are kept, which
+	 * makes the backward pass impossible. In the training mode the values read by the backward pass are kept as well,
+	 * until the last derivative reading them is computed. The backward passes keep then only the gradients of the
+	 * leaves and of the requested nodes, dropping the operators' ones once propagated. std::nullopt keeps all values and
+	 * gradients, which is the default.
+	 *
+	 * @param mode Mode selecting the kept values.
+	 */
+	void setLivenessMode(const std::optional<LivenessMode> mode) noexcept
+	{
+		livenessMode_ = mode;
+	}
+
+	/// Gets the mode set with setLivenessMode.
+	std::optional<LivenessMode> getLivenessMode() const noexcept
+	{
+		return livenessMode_;
+	}
+
+	/**
+	 * @brief Enables gradient checkpointing, which trades computation for memory. The forward passes keep only the
+	 * values of the checkpoints and of the graph's outputs and drop the other operators' values once their consumers
+	 * have run. The backward passes recompute the dropped values from the nearest kept ones, one segment between the
+	 * checkpoints at a time, and drop them again once the segment is differentiated. The backward passes with
+	 * checkpointing run the operators one after another, regardless of the inter-op pool.
+	 *
+	 * @param policy Policy choosing the checkpoints.
+	 * @param checkpoints Nodes whose values are kept by the MANUAL policy. Ignored by the other policies.
+	 */
+	void setCheckpointing(const CheckpointPolicy policy, std::vector<NodePtr> checkpoints = {})
+	{
+		checkpointPolicy_ = policy;
+		checkpoints_ = std::move(checkpoints);
+	}
+
+	/// Gets the policy set with setCheckpointing.
+	CheckpointPolicy getCheckpointPolicy() const noexcept
+	{
+		return checkpointPolicy_;
+	}
+
+private:
+	friend class ExecutionPlan;
+
+	/// Gets the slot of the node in the bound plan or std::nullopt if there is none.
+	std::optional<size_t> _findSlot(const NodePtr& node) const;
+
+private:
+	const ExecutionPlan* plan_ = nullptr;
+	// indexed by the plan's slots, the values are present only for the operators and the fed placeholders
+	std::vector<std::optional<Tensor>> values_ = {};
+	std::vector<std::optional<Tensor>> gradients_ = {};
+	std::optional<LivenessMode> livenessMode_ = std::nullopt;
+	CheckpointPolicy checkpointPolicy_ = CheckpointPolicy::NONE;
+	std::vector<NodePtr> checkpoints_ = {};
+};
+} // namespace mlCore::autoDiff
+
+#endif
@@ -0,0 +1,521 @@
+#ifndef AUTODIFF_EXECUTIONPLAN_H
+#define AUTODIFF_EXECUTIONPLAN_H
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <AutoDiff/ExecutionContext.h>
+#include <AutoDiff/GraphNodes.hpp>
+#include <AutoDiff/Profiler.h>
+#include <MLCore/Allocators/IAllocator.hpp>
+#include <Utilities/ThreadPool.h>
+
+namespace mlCore::autoDiff
+{
+
+/**
+ * @brief Operations performed by the ExecutionPlan's instructions. The built-in operators have their own codes, so that
+ * they are called without virtual dispatch. Other subclasses of the operators are run through their virtual methods.
+ */
+enum class OpCode : uint8_t
+{
+	ADD,
+	SUBTRACT,
+	MULTIPLY,
+	DIVIDE,
+	MATMUL,
+	POWER,
+	LN,
+	RELU,
+	SIGMOID,
+	CUSTOM_BINARY,
+	CUSTOM_UNARY,
+	/// Chain of elementwise operations run by a FusedKernel.
+	FUSED
+};
+
+/// Tells whether the operation takes two inputs.
+constexpr bool isBinary(const OpCode opCode) noexcept
+{
+	return opCode <= OpCode::POWER || opCode == OpCode::CUSTOM_BINARY;
+}
+
+/// Tells whether the operation computes each element of its value from the same elements of its inputs.
+constexpr bool isElementwise(const OpCode opCode) noexcept
+{
+	return (opCode != OpCode::MATMUL) && (opCode <= OpCode::SIGMOID);
+}
+
+/// Tells whether the operation is run by one of the built-in operators.
+constexpr bool isBuiltIn(const OpCode opCode) noexcept
+{
+	return opCode <= OpCode::SIGMOID;
+}
+
+/// Gets the name of the operation, e.g. "MATMUL".
+std::string_view getOpCodeName(OpCode opCode) noexcept;
+
+/// Gets the code of the operator or std::nullopt if the node is not an operator.
+std::optional<OpCode> getOpCode(const Node& node);
+
+/**
+ * @brief Infers the shape of the built-in operation's value from the shapes of its inputs, following the broadcasting
+ * and matrix multiplication rules. Unary operations ignore the second shape. Throws std::runtime_error if the shapes
+ * are incompatible or the operation is not a built-in one.
+ */
+std::vector<size_t> inferShape(OpCode opCode, const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape);
+
+/**
+ * @brief Adds the gradient to the accumulated one in place. Falls back to creating a new tensor if the gradient has to
+ * be broadcasted to a bigger shape.
+ */
+void accumulateGradient(Tensor& accumulated, const Tensor& gradient);
+
+/**
+ * @brief Selects how long the values of the operators are needed, see ExecutionPlan::estimateMemory.
+ */
+enum class LivenessMode : uint8_t
+{
+	/// Values are needed only until their consumers have run. Outputs of the graph are kept.
+	INFERENCE,
+	/// Values read by the backward pass are kept until the derivatives using them are computed.
+	TRAINING
+};
+
+/**
+ * @brief Estimate of the memory taken by the operators' values, computed from the values' lifetimes. It assigns the
+ * values to reusable buffers, where values whose lifetimes do not overlap share a buffer. The estimate itself allocates
+ * nothing - the buffers are lent to the values by the ShapedPlans of the PlanCache, see ComputationGraph::setLivenessMode.
+ * The leaves are not counted, since their values are owned by the nodes.
+ */
+struct MemoryEstimate
+{
+	/// Marks the slots having no buffer.
+	static constexpr size_t NO_BUFFER = std::numeric_limits<size_t>::max();
+
+	/// Index of the buffer of each slot.
+	std::vector<size_t> bufferIndices = {};
+	/// Size of each buffer, big enough for all values assigned to it.
+	std::vector<size_t> bufferBytes = {};
+	/// Biggest number of bytes taken by the values alive at the same time.
+	size_t peakBytes = 0;
+	/// Number of bytes taken by the values if each one is kept for the whole run.
+	size_t totalBytes = 0;
+
+	/// Gets the number of bytes taken by all buffers.
+	size_t getBuffersBytes() const noexcept
+	{
+		return std::accumulate(bufferBytes.cbegin(), bufferBytes.cend(), size_t(0));
+	}
+};
+
+/**
+ * @brief Single step of the ExecutionPlan. Computes the value of the node in the `output` slot from the values in the
+ * `inputs` slots. Unary operations use only the first input. Fused instructions keep the index of their kernel in the
+ * first input instead, see ExecutionPlan::getFusedKernels.
+ */
+struct Instruction
+{
+	OpCode opCode;
+	std::array<size_t, 2> inputs;
+	size_t output;
+};
+
+/**
+ * @brief Single operation of a FusedKernel. The operands are the kernel's registers - the first ones hold the kernel's
+ * inputs and each next one the result of the next step. Unary operations use only the first operand.
+ */
+struct FusedStep
+{
+	OpCode opCode;
+	std::array<size_t, 2> operands;
+	/// Operator replaced by the step.
+	const Node* node;
+};
+
+/**
+ * @brief Chain of elementwise operators run as a single instruction, see ExecutionPlan::fuseElementwise.
+ *
+ * The forward pass computes the result in one loop over blocks of elements, keeping the intermediate values of a block
+ * in small registers instead of tensors, and runs each step over the whole block, with the arithmetic operations done
+ * by the vectorized kernels. The backward pass computes the derivatives with respect to all inputs in one sweep as well,
+ * recomputing the intermediate values of each block instead of reading them from memory. Inputs which have to be
+ * broadcasted, e.g. a `[M]` bias added to a `[N, M]` tensor, are read in place with zero strides along the stretched
+ * dimensions, and their derivatives have the broadcasted shape, like the ones given by the replaced operators.
+ */
+class FusedKernel
+{
+public:
+	/**
+	 * @brief Creates the kernel.
+	 *
+	 * @param inputs Slots of the values loaded to the first registers.
+	 * @param steps Operations in the order of execution. The last one computes the kernel's value.
+	 */
+	FusedKernel(std::vector<size_t> inputs, std::vector<FusedStep> steps);
+
+	/// Gets the slots of the kernel's inputs.
+	const std::vector<size_t>& getInputs() const noexcept
+	{
+		return inputs_;
+	}
+
+	/// Gets the fused operations.
+	const std::vector<FusedStep>& getSteps() const noexcept
+	{
+		return steps_;
+	}
+
+	/**
+	 * @brief Computes the value of the last step.
+	 *
+	 * @param inputValues Values of the inputs, in the order of getInputs.
+	 */
+	Tensor computeValue(const std::vector<const Tensor*>& inputValues) const;
+
+	/**
+	 * @brief Computes the derivatives of the last step with respect to the selected inputs.
+	 *
+	 * @param outerDerivative The derivative of outer expression with respect to the kernel's value.
+	 * @param inputValues Values of the inputs, in the order of getInputs.
+	 * @param isRequired Tells for each input whether its derivative should be computed.
+	 * @return Derivatives present only for the selected inputs.
+	 */
+	std::vector<std::optional<Tensor>> computeInputDerivatives(const Tensor& outerDerivative,
+															   const std::vector<const Tensor*>& inputValues,
+															   const std::vector<bool>& isRequired) const;
+
+private:
+	std::vector<size_t> inputs_;
+	std::vector<FusedStep> steps_;
+};
+
+/**
+ * @brief Flat form of a sorted graph. Each node gets a slot, i.e. its index in the graph, and each operator an
+ * instruction referring to its inputs by their slots. The instructions are kept in the topological order and the passes
+ * are run by looping over them, so no casts nor shared pointers are involved once the plan is compiled.
+ *
+ * The plan refers to the nodes by raw pointers, so it is valid as long as the nodes are alive and the graph's structure
+ * is unchanged.
+ *
+ * Given an inter-op thread pool, the passes run the independent instructions concurrently. Each instruction is then
+ * started once the instructions it depends on have finished, which is tracked with per-instruction counters of pending
+ * dependencies.
+ *
+ * The passes either keep the values in the nodes or, given an ExecutionContext, read and write them only in the
+ * context, which lets many threads run the same plan at once.
+ */
+class ExecutionPlan
+{
+public:
+	ExecutionPlan() = default;
+
+	/**
+	 * @brief Lowers the nodes to the instructions.
+	 *
+	 * @param nodes Nodes of the graph. Each node's slot is its position in the vector.
+	 * @param order Positions of the nodes ordered so that each operator comes after its inputs.
+	 */
+	ExecutionPlan(const std::vector<NodePtr>& nodes, const std::vector<size_t>& order);
+
+	/**
+	 * @brief Places the node in the next slot. Lets the graph extend the plan instead of compiling it again.
+	 *
+	 * @param node Node whose inputs are already a part of the plan.
+	 */
+	void append(const NodePtr& node);
+
+	/// Gets the instructions in the order of execution.
+	const std::vector<Instruction>& getInstructions() const noexcept
+	{
+		return instructions_;
+	}
+
+	/// Gets the kernels of the fused instructions.
+	const std::vector<FusedKernel>& getFusedKernels() const noexcept
+	{
+		return fusedKernels_;
+	}
+
+	/// Gets the number of nodes in the plan.
+	size_t getSlotsCount() const noexcept
+	{
+		return slots_.size();
+	}
+
+	/// Gets the slot of the node or std::nullopt if the node is not a part of the plan.
+	std::optional<size_t> findSlot(const Node* node) const;
+
+	/**
+	 * @brief Updates the values of all operators, each after its inputs.
+	 *
+	 * @param interOpPool Pool running the independent operators concurrently. If nullptr, the instructions are run one
+	 * after another on the calling thread.
+	 * @param valueAllocators Allocators bound while the values are computed, indexed by the slots, e.g. the ones lending
+	 * the buffers of a ShapedPlan. The slots having nullptr, as well as all slots if the vector is empty, use the current
+	 * allocator.
+	 */
+	void runForward(const std::shared_ptr<utilities::ThreadPool>& interOpPool = nullptr,
+					const std::vector<allocators::AllocatorPtr>& valueAllocators = {}) const;
+
+	/**
+	 * @brief Updates the values of the selected operators like runForward, keeping the other ones. The selection has to
+	 * contain all consumers of the selected instructions, see markDirtyInstructions.
+	 *
+	 * @param isDirty Tells for each instruction whether it has to be run.
+	 * @param interOpPool Pool running the independent operators concurrently.
+	 */
+	void runForward(const std::vector<bool>& isDirty,
+					const std::shared_ptr<utilities::ThreadPool>& interOpPool = nullptr) const;
+
+	/**
+	 * @brief Selects the instructions whose values depend on the changed slots, i.e. the ones computing or reading the
+	 * changed slots together with all of their transitive consumers.
+	 *
+	 * @param isChanged Tells for each slot whether its value has changed since the last pass.
+	 * @return Flags indexed by the instructions.
+	 */
+	std::vector<bool> markDirtyInstructions(const std::vector<bool>& isChanged) const;
+
+	/**
+	 * @brief Computes the values of all operators like runForward, but keeps them in the context instead of the nodes.
+	 * The placeholders fed in the context take their values from it. Operators not overriding the methods computing from
+	 * external values (e.g. BinaryOperator::computeValue) cannot be run this way.
+	 *
+	 * @param context Context bound to the plan, see bindContext.
+	 * @param interOpPool Pool running the independent operators concurrently.
+	 */
+	void runForward(ExecutionContext& context, const std::shared_ptr<utilities::ThreadPool>& interOpPool = nullptr) const;
+
+	/**
+	 * @brief Computes gradients of the root's value with respect to the nodes it depends on. The operators are visited
+	 * in the reverse order, so each one propagates its gradient once, after it has been fully accumulated from all of
+	 * its outputs. Only the nodes lying between the root and the nodes requiring gradient are visited and the operators
+	 * compute the derivatives only for such inputs. Assumes that the values are updated.
+	 *
+	 * @param rootSlot Slot of the differentiated node.
+	 * @param wrtSlots Slots of the nodes the gradients are requested for. If empty, the nodes' requiresGrad flags are used.
+	 * Either way the operators with requiresGrad unset stop the backward pass.
+	 * @param interOpPool Pool running the independent operators concurrently. The order the gradients of a node are
+	 * summed in depends then on the timing, so the results may differ by rounding errors between the runs.
+	 * @return Gradients indexed by the slots. Nodes outside of the visited subgraph have no gradient. With a liveness
+	 * mode set (see setLivenessMode) neither have the operators not given in `wrtSlots`, since their gradients are
+	 * dropped once propagated, and the values read by the derivatives are dropped after their last reader.
+	 */
+	std::vector<std::optional<Tensor>> runBackward(size_t rootSlot,
+												   const std::vector<size_t>& wrtSlots = {},
+												   const std::shared_ptr<utilities::ThreadPool>& interOpPool = nullptr) const;
+
+	/**
+	 * @brief Computes gradients like runBackward, but from the values kept in the context. The gradients are added to
+	 * the ones accumulated in the context.
+	 *
+	 * @param context Context the forward pass has been run with.
+	 * @param rootSlot Slot of the differentiated node.
+	 * @param wrtSlots Slots of the nodes the gradients are requested for.
+	 * @param interOpPool Pool running the independent operators concurrently.
+	 */
+	void runBackward(ExecutionContext& context,
+					 size_t rootSlot,
+					 const std::vector<size_t>& wrtSlots = {},
+					 const std::shared_ptr<utilities::ThreadPool>& interOpPool = nullptr) const;
+
+	/**
+	 * @brief Prepares the context for running the plan. A context used by another plan loses its state, while the one
+	 * bound to this plan keeps it and is only extended by the slots appended since.
+	 *
+	 * @param context Context to be bound.
+	 */
+	void bindContext(ExecutionContext& context) const;
+
+	/**
+	 * @brief Computes the shapes of the nodes' values without running the operators. The leaves have the shapes of
+	 * their values unless given explicitly, the built-in operators' shapes follow their broadcasting and matrix
+	 * multiplication rules and the custom operators keep the shapes of their current values. Throws std::runtime_error
+	 * if the shapes of an operator's inputs are incompatible.
+	 *
+	 * @param leafShapes Shapes overriding the ones of the leaves' values, e.g. of the placeholders fed in the next run.
+	 * @return Shapes indexed by the slots.
+	 */
+	std::vector<std::vector<size_t>>
+	inferShapes(const std::unordered_map<size_t, std::vector<size_t>>& leafShapes = {}) const;
+
+	/**
+	 * @brief Estimates the memory of the operators' values before running the plan. Each value lives from the
+	 * instruction computing it to its last use, where the backward pass is assumed to visit the instructions in reverse
+	 * after the forward pass. The values are then assigned to buffers greedily, picking the smallest free buffer big
+	 * enough. Nothing is allocated, see MemoryEstimate.
+	 *
+	 * @param shapes Shapes of the slots' values, e.g. from inferShapes.
+	 * @param mode Tells whether the values are needed by the backward pass.
+	 */
+	MemoryEstimate estimateMemory(const std::vector<std::vector<size_t>>& shapes, LivenessMode mode) const;
+
+	/**
+	 * @brief Gets the value of the slot in the context. Leaves having no value in the context have their own values.
+	 * Throws std::runtime_error if the slot is an operator not computed in the context.
+	 */
+	const Tensor& getValue(const ExecutionContext& context, size_t slot) const;
+
+	/**
+	 * @brief Replaces the chains of elementwise operators with fused instructions, see FusedKernel. An operator is fused
+	 * into its consumer if the consumer is elementwise as well and is the only one reading the operator's value. The
+	 * operators with requiresGrad unset are not fused, so that they still stop the backward pass.
+	 *
+	 * The values and gradients of the operators inside the chains are no longer computed, so they must not be read nor
+	 * be the roots of the backward passes. Neither can the nodes appended later consume them.
+	 */
+	void fuseElementwise();
+
+	/**
+	 * @brief Computes the operators depending only on constants once, so that they become leaves keeping their values
+	 * in the nodes and are no longer run by the passes. The folded operators require no gradient. The values of the
+	 * constants must not change afterwards.
+	 */
+	void foldConstants();
+
+	/**
+	 * @brief Removes the operators computing the same operation on the same inputs as an earlier one. The operators are
+	 * looked up by their codes, input slots and requiresGrad flags, so whole duplicated subgraphs are removed, one level
+	 * after another. The operands of additions and multiplications are not ordered. Custom operators are kept, since
+	 * they may differ in their own state.
+	 *
+	 * The removed nodes are looked up as their duplicates, e.g. by findSlot and by the contexts. The passes keeping the
+	 * values in the nodes copy the duplicates' values to them at the end, so that they can still be read. The values
+	 * read by custom operators are not removed, since such operators read them from their own input nodes.
+	 */
+	void eliminateCommonSubexpressions();
+
+	/**
+	 * @brief Sets the profiler recording the runs of the instructions. Passing nullptr disables the profiling, which is
+	 * the default. The disabled profiler costs a single check per instruction.
+	 *
+	 * @param profiler Profiler shared by all passes, including the ones run concurrently with contexts.
+	 */
+	void setProfiler(std::shared_ptr<GraphProfiler> profiler) noexcept
+	{
+		profiler_ = std::move(profiler);
+	}
+
+	/// Gets the profiler set with setProfiler.
+	const std::shared_ptr<GraphProfiler>& getProfiler() const noexcept
+	{
+		return profiler_;
+	}
+
+	/**
+	 * @brief Makes the passes keeping the values in the nodes drop the operators' values once they are no longer needed,
+	 * like the contexts do, see ExecutionContext::setLivenessMode. The dropped values are replaced with empty scalars.
+	 * std::nullopt keeps all values, which is the default.
+	 *
+	 * @param mode Mode selecting the kept values.
+	 */
+	void setLivenessMode(const std::optional<LivenessMode> mode) noexcept
+	{
+		livenessMode_ = mode;
+	}
+
+	/// Gets the mode set with setLivenessMode.
+	std::optional<LivenessMode> getLivenessMode() const noexcept
+	{
+		return livenessMode_;
+	}
+
+private:
+	/// Appends the instruction computing the node in the slot, if the node is an operator.
+	void _lowerNode(size_t slot);
+
+	/// Tells for each slot whether the gradient with respect to it is needed, i.e. whether it leads to a node requiring
+	/// gradient.
+	std::vector<bool> _markRequiredGradients(const std::vector<size_t>& wrtSlots) const;
+
+	/// Runs the forward pass keeping the values in the context or, if it is nullptr, in the nodes. Only the dirty
+	/// instructions are run, all of them if the flags are not given. The values are allocated with the given allocators.
+	void _runForward(ExecutionContext* context,
+					 const std::shared_ptr<utilities::ThreadPool>& interOpPool,
+					 const std::vector<bool>* isDirty = nullptr,
+					 const std::vector<allocators::AllocatorPtr>* valueAllocators = nullptr) const;
+
+	/// Runs the backward pass reading the values from the context or, if it is nullptr, from the nodes.
+	std::vector<std::optional<Tensor>> _runBackward(ExecutionContext* context,
+													size_t rootSlot,
+													const std::vector<size_t>& wrtSlots,
+													const std::shared_ptr<utilities::ThreadPool>& interOpPool) const;
+
+	/**
+	 * @brief Tells for each instruction whether its output can be dropped once all of its consumers have run. Outputs
+	 * of the graph are never dropped, neither are the values read by the backward pass in the training mode.
+	 */
+	std::vector<bool> _markReleasedOutputs(LivenessMode mode) const;
+
+	/// Copies the values of the operators kept by eliminateCommonSubexpressions to the removed duplicates.
+	void _copyToDuplicates() const;
+
+	/// Drops the value of the slot from the context or, if it is nullptr, from the node and its removed duplicates.
+	void _releaseValue(ExecutionContext* context, size_t slot) const;
+
+	/// Computes the value of the instruction's output, keeping it in the context or, if it is nullptr, in the node.
+	void _computeForward(ExecutionContext* context, const Instruction& instruction) const;
+
+	/// Creates the profiler's event of the instruction started at given time, which has allocated given number of bytes.
+	ProfileEvent _makeEvent(ProfiledPass pass,
+							const Instruction& instruction,
+							std::chrono::nanoseconds start,
+							size_t allocatedBytes) const;
+
+	/// Computes the value of the instruction's output from the values kept in the context.
+	void _computeInContext(ExecutionContext& context, const Instruction& instruction) const;
+
+	/**
+	 * @brief Tells for each slot whether its value is a checkpoint of the context's policy. Throws std::runtime_error if
+	 * a manually selected checkpoint is not a part of the plan.
+	 */
+	std::vector<bool> _markCheckpoints(const ExecutionContext& context) const;
+
+	/**
+	 * @brief Recomputes the value of the slot dropped from the context, together with the dropped values it depends on.
+	 *
+	 * @param context Context run with checkpointing.
+	 * @param slot Slot whose value is needed.
+	 * @param rematerialized Slots recomputed so far, extended by the ones recomputed by the call.
+	 */
+	void _rematerialize(ExecutionContext& context, size_t slot, std::vector<size_t>& rematerialized) const;
+
+	/// Gets the distinct instructions computing the inputs of the instruction.
+	std::vector<size_t> _getInputProducers(const Instruction& instruction) const;
+
+	/// Gets the slots of the instruction's inputs, i.e. one or two for the operators and many for the fused ones.
+	std::span<const size_t> _getInputSlots(const Instruction& instruction) const;
+
+	/// Computes the producers and the consumers of all instructions again, after the instructions have been rewritten.
+	void _linkInstructions();
+
+	/// Marks the slots having no instruction computing them.
+	static constexpr size_t NO_PRODUCER = std::numeric_limits<size_t>::max();
+
+private:
+	std::vector<Node*> slots_ = {};
+	std::vector<Instruction> instructions_ = {};
+	std::unordered_map<const Node*, size_t> slotIndices_ = {};
+	// index of the instruction computing each slot and the distinct instructions consuming each instruction's output
+	std::vector<size_t> producers_ = {};
+	std::vector<std::vector<size_t>> consumers_ = {};
+	std::vector<FusedKernel> fusedKernels_ = {};
+	// tells for each slot whether it is an operator computed once by foldConstants
+	std::vector<bool> isFolded_ = {};
+	// slots removed by eliminateCommonSubexpressions paired with the slots computing their values
+	std::vector<std::pair<size_t, size_t>> duplicates_ = {};
+	std::shared_ptr<GraphProfiler> profiler_ = nullptr;
+	// liveness mode of the passes keeping the values in the nodes
+	std::optional<LivenessMode> livenessMode_ = std::nullopt;
+};
+} // namespace mlCore::autoDiff
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <MLCore/BasicTensor.h>
 #include <memory>
+#include <optional>
 
 /**
  * @brief Classes representing nodes in ComputationGraphs. Nodes hold tensors and can be linked to each other.
@@ -40,6 +41,66 @@ public:
 		return value_;
 	}
 
+	/**
+	 * @brief Replaces the value and marks it as changed, see markChanged.
+	 * 
+	 * @param value New value of the node.
+	 */
+	void setValue(Tensor value)
+	{
+		value_ = std::move(value);
+		markChanged();
+	}
+
+	/**
+	 * @brief Tells the incremental forward passes that the value has changed, e.g. after an optimizer has updated a
+	 * variable in place through getValue. The consumers of the node are then computed again by the next pass, see
+	 * ComputationGraph::setIncrementalForward.
+	 */
+	void markChanged() noexcept
+	{
+		version_++;
+	}
+
+	/// Gets the number of times the value has been marked as changed.
+	uint64_t getVersion() const noexcept
+	{
+		return version_;
+	}
+
+	/**
+	 * @brief Tells whether the value has not been computed yet, since the node has been built lazily (see
+	 * ConstructionMode::LAZY). The value is computed by the first forward pass keeping the values in the nodes.
+	 */
+	bool isDeferred() const noexcept
+	{
+		return isDeferred_;
+	}
+
+	/// Gets the shape inferred for the deferred value or std::nullopt if it depends on placeholders of unknown shapes.
+	const std::optional<std::vector<size_t>>& getDeferredShape() const noexcept
+	{
+		return deferredShape_;
+	}
+
+	/**
+	 * @brief Marks the value as not computed yet.
+	 * 
+	 * @param shape Shape inferred for the value, if known.
+	 */
+	void defer(std::optional<std::vector<size_t>> shape)
+	{
+		isDeferred_ = true;
+		deferredShape_ = std::move(shape);
+	}
+
+	/// Marks the deferred value as computed.
+	void resolve() noexcept
+	{
+		isDeferred_ = false;
+		deferredShape_.reset();
+	}
+
 	const uint64_t& getIndex() const
 	{
 		return index_;
@@ -55,11 +116,35 @@ public:
 		name_ = name;
 	}
 
+	/**
+	 * @brief Tells whether the gradients should be computed with respect to the node. Variables require gradient by
+	 * default, while placeholders and constants do not. Operators require gradient only if any of their inputs does, so
+	 * disabling it on an operator stops the backpropagation into its inputs.
+	 */
+	bool requiresGrad() const noexcept
+	{
+		return requiresGrad_;
+	}
+
+	void setRequiresGrad(const bool requiresGrad) noexcept
+	{
+		requiresGrad_ = requiresGrad;
+	}
+
 protected:
+	Node(const Tensor& tensor, const bool requiresGrad)
+		: index_(nodesCount_++)
+		, value_(tensor)
+		, requiresGrad_(requiresGrad){};
+
 	uint64_t index_;
 	static inline uint64_t nodesCount_ = 0;
 	Tensor value_;
 	std::string name_ = "";
+	bool requiresGrad_ = true;
+	uint64_t version_ = 0;
+	bool isDeferred_ = false;
+	std::optional<std::vector<size_t>> deferredShape_ = std::nullopt;
 };
 
 /**
@@ -76,7 +161,7 @@ public:
 };
 
 /**
- * @brief Its value cannot be assigned, changed. Computed derivative is always zero.
+ * @brief Its value cannot be assigned, changed. Does not require gradient.
  * 
  */
 class Constant : public Node
@@ -84,7 +169,7 @@ class Constant : public Node
 public:
 	Constant() = delete;
 	Constant(const Tensor& tensor)
-		: Node(tensor){};
+		: Node(tensor, false){};
 };
 
 /**
@@ -95,7 +180,7 @@ class Placeholder : public Node
 {
 public:
 	Placeholder(const std::vector<size_t>& shape = {})
-		: Node(shape){};
+		: Node(shape, false){};
 };
 
 } // namespace mlCore::autoDiff
@@ -10,6 +10,50 @@
 namespace mlCore::autoDiff
 {
 
+/**
+ * @brief Selects what the operations below do with the values of the created operators.
+ */
+enum class ConstructionMode : uint8_t
+{
+	/// The values are computed at once.
+	EAGER,
+	/// Only the shapes of the values are inferred, which reports incompatible shapes right away. The values are
+	/// deferred to the first forward pass, see Node::isDeferred. Placeholders having the default, empty shape are
+	/// treated as having unknown shapes, so the operators depending on them are checked by the forward pass.
+	LAZY
+};
+
+/// Gets the mode bound to the current thread with the innermost ConstructionModeScope, ConstructionMode::EAGER if none.
+ConstructionMode getCurrentConstructionMode() noexcept;
+
+/**
+ * @brief Binds a construction mode to the current thread for the lifetime of the object, so that the operations
+ * called on the thread within the scope build the operators in this mode.
+ */
+class ConstructionModeScope
+{
+public:
+	ConstructionModeScope() = delete; // Default constructor
+
+	/**
+	 * @brief Binds the mode to the current thread.
+	 *
+	 * @param mode Mode to be used.
+	 */
+	explicit ConstructionModeScope(ConstructionMode mode) noexcept;
+
+	ConstructionModeScope(const ConstructionModeScope&) = delete;			 // Copy constructor
+	ConstructionModeScope(ConstructionModeScope&&) = delete;				 // Move constructor
+	ConstructionModeScope& operator=(const ConstructionModeScope&) = delete; // Copy assignment
+	ConstructionModeScope& operator=(ConstructionModeScope&&) = delete;		 // Move assignment
+
+	/// Brings back the mode bound before the scope was created.
+	~ConstructionModeScope();
+
+private:
+	ConstructionMode previousMode_;
+};
+
 /// Concept for functions taking any number of shared pointers of types inheriting from Node and returning analogous type
 template <typename Operation, typename... NodePtrs>
 concept NodeOperation = requires(NodePtrs... inputNodes, Operation oper)
@@ -0,0 +1,137 @@
+#ifndef AUTODIFF_PLANCACHE_H
+#define AUTODIFF_PLANCACHE_H
+
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <AutoDiff/ExecutionPlan.h>
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::autoDiff
+{
+/**
+ * @brief Configuration of the PlanCache.
+ */
+struct PlanCacheOptions
+{
+	/// Maximal number of cached plans, at least one. The least recently used one is evicted to make room for a new one.
+	size_t capacity = 16;
+	/// Sizes the leading dimension of the batched placeholders' shapes is padded up to, e.g. the batch sizes served.
+	/// Leading dimensions bigger than all of them, as well as all of them if there are no buckets, are kept as they are.
+	std::vector<size_t> batchBuckets = {};
+};
+
+/**
+ * @brief Results of the shape-dependent planning of an ExecutionPlan for one set of the placeholders' shapes.
+ */
+struct ShapedPlan
+{
+	/// Shapes of the nodes' values indexed by the slots, see ExecutionPlan::inferShapes.
+	std::vector<std::vector<size_t>> shapes = {};
+	MemoryEstimate memoryEstimate = {};
+	/// Allocators lending the buffers of the estimate, indexed by the slots, see allocators::BufferAllocator. The slots
+	/// sharing a buffer share the allocator and the slots having no buffer have nullptr. The buffers are allocated on
+	/// their first use, so the plans which are only queried take no memory.
+	std::vector<allocators::AllocatorPtr> valueAllocators = {};
+};
+
+/**
+ * @brief Cache of the ShapedPlans of a single ExecutionPlan, keyed by the liveness mode and the shapes of the
+ * placeholders. Running or querying batches of varying sizes repeats the shape inference and the estimate only for the
+ * sets of shapes not seen recently, and the forward passes of the repeated shapes compute the values in the buffers
+ * allocated by the previous ones, see ComputationGraph::setLivenessMode.
+ *
+ * The shapes of the batched placeholders are padded to the configured buckets before the lookup, see padShape, so all
+ * batches falling into a bucket share the plan computed for the bucket's size, whose buffers fit each of them. The
+ * other leaves are assumed to keep their shapes, so the cache has to be cleared once they change or the plan is
+ * compiled again.
+ */
+class PlanCache
+{
+public:
+	/**
+	 * @brief Creates an empty cache.
+	 *
+	 * @param options Capacity and buckets of the cache.
+	 */
+	explicit PlanCache(PlanCacheOptions options = {});
+
+	/// Replaces the options, dropping all cached plans.
+	void setOptions(PlanCacheOptions options);
+
+	/// Gets the options with the buckets sorted.
+	const PlanCacheOptions& getOptions() const noexcept
+	{
+		return options_;
+	}
+
+	/// Pads the leading dimension of the shape up to the smallest bucket fitting it.
+	std::vector<size_t> padShape(std::vector<size_t> shape) const;
+
+	/**
+	 * @brief Gets the cached plan for the shapes or computes and caches a new one, evicting the least recently used one
+	 * if the cache is full.
+	 *
+	 * @param plan Plan the cached ones are computed for.
+	 * @param mode Liveness mode of the memory estimate.
+	 * @param placeholderShapes Shapes of all placeholders of the plan, indexed by their slots and already padded.
+	 * @param allocator Allocator the buffers of a new plan are taken from.
+	 * @return Plan valid until the next call or until the cache is cleared.
+	 */
+	const ShapedPlan& getPlan(const ExecutionPlan& plan,
+							  LivenessMode mode,
+							  const std::map<size_t, std::vector<size_t>>& placeholderShapes,
+							  const allocators::AllocatorPtr& allocator);
+
+	/// Drops all cached plans.
+	void clear() noexcept;
+
+	/// Gets the number of cached plans.
+	size_t getSize() const noexcept
+	{
+		return entries_.size();
+	}
+
+	/// Gets the number of lookups which have found a cached plan.
+	size_t getHitsCount() const noexcept
+	{
+		return nHits_;
+	}
+
+	/// Gets the number of lookups which have computed a new plan.
+	size_t getMissesCount() const noexcept
+	{
+		return nMisses_;
+	}
+
+private:
+	/// Set of shapes the plans are looked up by.
+	struct Key
+	{
+		LivenessMode mode;
+		std::vector<std::pair<size_t, std::vector<size_t>>> placeholderShapes;
+
+		bool operator==(const Key&) const = default;
+	};
+
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const noexcept;
+	};
+
+	using Entry = std::pair<Key, ShapedPlan>;
+
+private:
+	PlanCacheOptions options_;
+	// entries ordered from the most recently used one
+	std::list<Entry> entries_ = {};
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup_ = {};
+	size_t nHits_ = 0;
+	size_t nMisses_ = 0;
+};
+} // namespace mlCore::autoDiff
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef AUTODIFF_PROFILER_H
+#define AUTODIFF_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::autoDiff
+{
+/// Pass of the graph an instruction is run by.
+enum class ProfiledPass : uint8_t
+{
+	FORWARD,
+	BACKWARD
+};
+
+/**
+ * @brief Single run of an instruction recorded by the GraphProfiler.
+ */
+struct ProfileEvent
+{
+	ProfiledPass pass = ProfiledPass::FORWARD;
+	/// Id and name of the node computed by the instruction. The exports name the unnamed nodes after the operation and
+	/// the id, e.g. "MATMUL#12".
+	uint64_t nodeId = 0;
+	std::string nodeName = {};
+	/// Type of the operation, e.g. "MATMUL" or "FUSED".
+	std::string opName = {};
+	/// Index of the thread the instruction has been run on, in the order the threads have been seen by the profiler.
+	size_t threadIdx = 0;
+	/// Time since the profiler's creation at which the instruction has started.
+	std::chrono::nanoseconds start = {};
+	std::chrono::nanoseconds duration = {};
+	/// Bytes requested from the allocator by the instruction, including the threads helping its tensor kernels.
+	size_t allocatedBytes = 0;
+	/// Shapes of the inputs' values and of the output's value in the forward pass. In the backward pass the shapes of
+	/// the computed derivatives and of the output's gradient.
+	std::vector<std::vector<size_t>> inputShapes = {};
+	std::vector<size_t> outputShape = {};
+};
+
+/**
+ * @brief Allocator counting the bytes requested from the wrapped one. Bound by the profiled passes for the time of each
+ * instruction, so that the allocations of the instruction's thread and of the threads helping its kernels, which
+ * inherit the allocator, are counted together.
+ */
+class TrackingAllocator : public allocators::IAllocator
+{
+public:
+	/**
+	 * @brief Wraps the allocator.
+	 *
+	 * @param allocator Allocator serving the requests.
+	 */
+	explicit TrackingAllocator(allocators::AllocatorPtr allocator);
+
+	TrackingAllocator(const TrackingAllocator&) = delete;			 // Copy constructor
+	TrackingAllocator(TrackingAllocator&&) = delete;				 // Move constructor
+	TrackingAllocator& operator=(const TrackingAllocator&) = delete; // Copy assignment
+	TrackingAllocator& operator=(TrackingAllocator&&) = delete;		 // Move assignment
+
+	~TrackingAllocator() override = default;
+
+	void* allocate(size_t nBytes) override;
+
+	void deallocate(void* memory, size_t nBytes) override;
+
+	/// Gets the number of bytes allocated so far, not decreased by the deallocations.
+	size_t getAllocatedBytes() const noexcept
+	{
+		return allocatedBytes_.load(std::memory_order_relaxed);
+	}
+
+private:
+	allocators::AllocatorPtr allocator_;
+	std::atomic<size_t> allocatedBytes_;
+};
+
+/**
+ * @brief Collects the events of the instructions run by the passes of a ComputationGraph, see
+ * ComputationGraph::setProfiler. The events can be exported to the Chrome Trace Event format, viewed e.g. in
+ * chrome://tracing or Perfetto, or summarized per node and per operation type.
+ *
+ * The events are recorded by many threads at once if the graph runs the operators concurrently.
+ */
+class GraphProfiler
+{
+public:
+	GraphProfiler(); // Default constructor
+
+	GraphProfiler(const GraphProfiler&) = delete;			 // Copy constructor
+	GraphProfiler(GraphProfiler&&) = delete;				 // Move constructor
+	GraphProfiler& operator=(const GraphProfiler&) = delete; // Copy assignment
+	GraphProfiler& operator=(GraphProfiler&&) = delete;		 // Move assignment
+
+	~GraphProfiler() = default;
+
+	/// Gets the time elapsed since the profiler has been created.
+	std::chrono::nanoseconds now() const noexcept;
+
+	/**
+	 * @brief Records the event, assigning it the index of the calling thread.
+	 *
+	 * @param event Event of the instruction run on the calling thread.
+	 */
+	void record(ProfileEvent event);
+
+	/// Gets the copy of the events recorded so far.
+	std::vector<ProfileEvent> getEvents() const;
+
+	/// Drops all events recorded so far.
+	void clear();
+
+	/**
+	 * @brief Writes the events in the Chrome Trace Event format, i.e. a JSON object with the complete events
+	 * describing the instructions. The shapes and the allocated bytes are kept in the events' arguments.
+	 *
+	 * @param stream Stream the JSON is written to.
+	 */
+	void writeChromeTrace(std::ostream& stream) const;
+
+	/**
+	 * @brief Writes the text tables aggregating the events per operation type and per node, each sorted by the total
+	 * time spent in the instructions.
+	 *
+	 * @param stream Stream the tables are written to.
+	 */
+	void writeSummary(std::ostream& stream) const;
+
+private:
+	std::chrono::steady_clock::time_point startTime_;
+	mutable std::mutex eventsMutex_ = {};
+	std::vector<ProfileEvent> events_ = {};
+	std::unordered_map<std::thread::id, size_t> threadIndices_ = {};
+};
+} // namespace mlCore::autoDiff
+
+#endif
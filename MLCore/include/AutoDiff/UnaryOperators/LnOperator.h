@@ -20,6 +20,10 @@ public:
 	Tensor computeDerivative(const Tensor& outerDerivative) const override;
 
 	Tensor computeDirectDerivative() const override;
+
+	Tensor computeValue(const Tensor& inputValue) const override;
+
+	Tensor computeInputDerivative(const Tensor& outerDerivative, const Tensor& inputValue, const Tensor& value) const override;
 };
 
 using LnOperatorPtr = std::shared_ptr<LnOperator>;
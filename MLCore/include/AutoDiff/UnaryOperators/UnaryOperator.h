@@ -1,6 +1,8 @@
 #ifndef UNARYOPERATORS_IUNARYOPERATOR_H
 #define UNARYOPERATORS_IUNARYOPERATOR_H
 
+#include <stdexcept>
+
 #include <AutoDiff/GraphNodes.hpp>
 
 namespace mlCore::autoDiff::unaryOperators
@@ -39,6 +41,34 @@ public:
 	 */
 	virtual Tensor computeDirectDerivative() const = 0;
 
+	/**
+	 * @brief Computes the value of the operator from the given value of its input, without modifying the node. Lets the
+	 * values of concurrent runs of the graph be kept outside of the nodes, see ExecutionContext. The default
+	 * implementation throws std::runtime_error, so operators not overriding it can be run only through updateValue.
+	 * 
+	 * @param inputValue Value of the input.
+	 * @return Value of the operator.
+	 */
+	virtual Tensor computeValue(const Tensor& /*inputValue*/) const
+	{
+		throw std::runtime_error("The operator cannot be computed from external values.");
+	}
+
+	/**
+	 * @brief Computes the derivative like computeDerivative, but from the given values of the input and of the operator
+	 * instead of the ones stored in the nodes. The default implementation throws std::runtime_error.
+	 * 
+	 * @param outerDerivative Derivative of external expression with respect to the operator.
+	 * @param inputValue Value of the input.
+	 * @param value Value of the operator computed from the input's value.
+	 * @return Derivative of the operator with respect to the input.
+	 */
+	virtual Tensor
+	computeInputDerivative(const Tensor& /*outerDerivative*/, const Tensor& /*inputValue*/, const Tensor& /*value*/) const
+	{
+		throw std::runtime_error("The operator cannot be differentiated with external values.");
+	}
+
 	NodePtr getInput() const
 	{
 		return input_;
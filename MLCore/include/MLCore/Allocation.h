@@ -0,0 +1,59 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATION_H
+#define MLCORE_INCLUDE_MLCORE_ALLOCATION_H
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore
+{
+/**
+ * @brief Sets the allocator providing memory for the tensors created on threads having no allocator bound with
+ * AllocatorScope. Passing nullptr brings back the default allocators::HeapAllocator.
+ *
+ * Tensors keep the allocator they have been created with, so it can be changed at any time.
+ *
+ * @param allocator Allocator to be used.
+ */
+void setGlobalAllocator(allocators::AllocatorPtr allocator);
+
+/// Gets the allocator set with setGlobalAllocator.
+allocators::AllocatorPtr getGlobalAllocator();
+
+/// Gets the allocator used by the tensors created on the current thread, i.e. the one bound with the innermost
+/// AllocatorScope or the global one.
+allocators::AllocatorPtr getCurrentAllocator();
+
+/**
+ * @brief Binds an allocator to the current thread for the lifetime of the object. Tensors created on the thread within
+ * the scope get their memory from the bound allocator instead of the global one or the one bound by an outer scope.
+ *
+ * Unlike the thread pool, nullptr does not fall back to the global allocator, see the constructor. Passing
+ * getGlobalAllocator() or getCurrentAllocator() keeps using the global or the outer allocator respectively.
+ */
+class AllocatorScope
+{
+public:
+	AllocatorScope() = delete; // Default constructor
+
+	/**
+	 * @brief Binds the allocator to the current thread.
+	 *
+	 * @param allocator Allocator to be used. nullptr binds the default allocators::HeapAllocator, regardless of the
+	 * allocator set with setGlobalAllocator.
+	 */
+	explicit AllocatorScope(allocators::AllocatorPtr allocator);
+
+	AllocatorScope(const AllocatorScope&) = delete;			   // Copy constructor
+	AllocatorScope(AllocatorScope&&) = delete;				   // Move constructor
+	AllocatorScope& operator=(const AllocatorScope&) = delete; // Copy assignment
+	AllocatorScope& operator=(AllocatorScope&&) = delete;	   // Move assignment
+
+	/// Brings back the allocator bound before the scope was created.
+	~AllocatorScope();
+
+private:
+	allocators::AllocatorPtr previousAllocator_;
+};
+
+} // namespace mlCore
+
+#endif
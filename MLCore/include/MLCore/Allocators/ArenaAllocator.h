@@ -0,0 +1,76 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATORS_ARENAALLOCATOR_H
+#define MLCORE_INCLUDE_MLCORE_ALLOCATORS_ARENAALLOCATOR_H
+
+#include <mutex>
+#include <vector>
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::allocators
+{
+/**
+ * @brief Bump allocator carving blocks out of big chunks. Deallocation does not free anything - the whole memory is
+ * reused after `reset`, which makes the allocator suitable for the temporaries of a single step, e.g. one forward and
+ * backward pass.
+ *
+ */
+class ArenaAllocator : public IAllocator
+{
+public:
+	/**
+	 * @brief Creates an empty arena.
+	 *
+	 * @param chunkSize Size of the chunks requested from the heap. Bigger blocks are given a chunk of their own.
+	 */
+	explicit ArenaAllocator(size_t chunkSize = size_t(16) << 20);
+
+	ArenaAllocator(const ArenaAllocator&) = delete;			   // Copy constructor
+	ArenaAllocator(ArenaAllocator&&) = delete;				   // Move constructor
+	ArenaAllocator& operator=(const ArenaAllocator&) = delete; // Copy assignment
+	ArenaAllocator& operator=(ArenaAllocator&&) = delete;	   // Move assignment
+
+	~ArenaAllocator() override;
+
+	void* allocate(size_t nBytes) override;
+
+	void deallocate(void* memory, size_t nBytes) override;
+
+	/**
+	 * @brief Makes the whole memory available again. If the arena has grown, its chunks are merged into one, so that the
+	 * next steps fit in a single chunk. Throws std::runtime_error if any of the allocated blocks is still in use.
+	 *
+	 */
+	void reset();
+
+	/// Gets number of bytes handed out since the last reset, including the alignment padding.
+	size_t getUsedBytes() const;
+
+	/// Gets total size of the chunks.
+	size_t getCapacity() const;
+
+private:
+	/// Memory block obtained from the heap.
+	struct Chunk
+	{
+		std::byte* memory{};
+		size_t size{};
+	};
+
+	/// Requests a new chunk of at least `nBytes` bytes and makes it the current one.
+	void _addChunk(size_t nBytes);
+
+	/// Returns all chunks to the heap.
+	void _freeChunks() noexcept;
+
+private:
+	const size_t chunkSize_;
+
+	mutable std::mutex mutex_;
+	std::vector<Chunk> chunks_;
+	size_t currentOffset_;
+	size_t usedBytes_;
+	size_t nLiveBlocks_;
+};
+} // namespace mlCore::allocators
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATORS_BUFFERALLOCATOR_H
+#define MLCORE_INCLUDE_MLCORE_ALLOCATORS_BUFFERALLOCATOR_H
+
+#include <atomic>
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::allocators
+{
+/**
+ * @brief Allocator lending a single buffer of a fixed size to one block at a time, e.g. to the values planned to share
+ * the buffer because their lifetimes do not overlap. The requests which do not fit the buffer or come while it is lent
+ * are passed to the fallback allocator, so the buffer is only an optimization - blocks with overlapping lifetimes never
+ * share it.
+ *
+ * The buffer is taken from the fallback allocator on its first use and given back when the allocator is destroyed.
+ */
+class BufferAllocator : public IAllocator
+{
+public:
+	/**
+	 * @brief Creates the allocator without allocating the buffer yet.
+	 *
+	 * @param bufferBytes Size of the buffer.
+	 * @param fallback Allocator providing the buffer and serving the other requests.
+	 */
+	BufferAllocator(size_t bufferBytes, AllocatorPtr fallback);
+
+	BufferAllocator(const BufferAllocator&) = delete;			 // Copy constructor
+	BufferAllocator(BufferAllocator&&) = delete;				 // Move constructor
+	BufferAllocator& operator=(const BufferAllocator&) = delete; // Copy assignment
+	BufferAllocator& operator=(BufferAllocator&&) = delete;		 // Move assignment
+
+	/// Gives the buffer back to the fallback allocator.
+	~BufferAllocator() override;
+
+	void* allocate(size_t nBytes) override;
+
+	void deallocate(void* memory, size_t nBytes) override;
+
+	/// Gets size of the buffer.
+	size_t getBufferBytes() const noexcept
+	{
+		return bufferBytes_;
+	}
+
+	/// Tells whether the buffer is lent to a block.
+	bool isLent() const noexcept
+	{
+		return isLent_.load(std::memory_order_acquire);
+	}
+
+private:
+	const size_t bufferBytes_;
+	const AllocatorPtr fallback_;
+
+	std::atomic<void*> buffer_;
+	std::atomic<bool> isLent_;
+};
+} // namespace mlCore::allocators
+
+#endif
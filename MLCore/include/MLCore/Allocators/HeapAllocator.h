@@ -0,0 +1,30 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATORS_HEAPALLOCATOR_H
+#define MLCORE_INCLUDE_MLCORE_ALLOCATORS_HEAPALLOCATOR_H
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::allocators
+{
+/**
+ * @brief Allocator passing every request to the global aligned operator new. Used by default.
+ *
+ */
+class HeapAllocator : public IAllocator
+{
+public:
+	HeapAllocator() = default; // Default constructor
+
+	HeapAllocator(const HeapAllocator&) = delete;			 // Copy constructor
+	HeapAllocator(HeapAllocator&&) = delete;				 // Move constructor
+	HeapAllocator& operator=(const HeapAllocator&) = delete; // Copy assignment
+	HeapAllocator& operator=(HeapAllocator&&) = delete;		 // Move assignment
+
+	~HeapAllocator() override = default;
+
+	void* allocate(size_t nBytes) override;
+
+	void deallocate(void* memory, size_t nBytes) override;
+};
+} // namespace mlCore::allocators
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATORS_IALLOCATOR_HPP
+#define MLCORE_INCLUDE_MLCORE_ALLOCATORS_IALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+
+namespace mlCore::allocators
+{
+/// Alignment of the memory returned by the allocators. Allows aligned SIMD loads of any supported width.
+constexpr size_t kAllocationAlignment = 64;
+
+/**
+ * @brief Interface for classes providing memory for the tensors' elements. The allocators have to be thread-safe, since
+ * tensors can be created and destroyed on any thread.
+ *
+ */
+class IAllocator
+{
+public:
+	/**
+	 * @brief Allocates a block of memory aligned to kAllocationAlignment.
+	 *
+	 * @param nBytes Minimal size of the block.
+	 * @return Pointer to the beginning of the block.
+	 */
+	virtual void* allocate(size_t nBytes) = 0;
+
+	/**
+	 * @brief Gives back the block obtained from `allocate`.
+	 *
+	 * @param memory Pointer returned by `allocate`.
+	 * @param nBytes Size passed to `allocate`.
+	 */
+	virtual void deallocate(void* memory, size_t nBytes) = 0;
+
+	virtual ~IAllocator() = default;
+};
+
+using AllocatorPtr = std::shared_ptr<IAllocator>;
+} // namespace mlCore::allocators
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MLCORE_INCLUDE_MLCORE_ALLOCATORS_POOLALLOCATOR_H
+#define MLCORE_INCLUDE_MLCORE_ALLOCATORS_POOLALLOCATOR_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <MLCore/Allocators/IAllocator.hpp>
+
+namespace mlCore::allocators
+{
+/**
+ * @brief Allocator reusing the freed blocks. Requests are rounded up to power-of-two size classes and the freed blocks
+ * are kept on per-class free lists instead of being returned to the system.
+ *
+ * Each thread caches the blocks it frees, so that repeated allocations of the same size are served without locking.
+ * Blocks exceeding the per-thread limit go to a list shared by all threads. Blocks cached by other threads are
+ * released when these threads exit.
+ */
+class PoolAllocator : public IAllocator
+{
+public:
+	/**
+	 * @brief Creates an empty pool.
+	 *
+	 * @param maxThreadCachedBytes Maximal number of bytes cached by a single thread.
+	 * @param maxBlockSize Size of the biggest block kept by the pool. Bigger requests are passed to the heap.
+	 */
+	explicit PoolAllocator(size_t maxThreadCachedBytes = size_t(64) << 20, size_t maxBlockSize = size_t(256) << 20);
+
+	PoolAllocator(const PoolAllocator&) = delete;			 // Copy constructor
+	PoolAllocator(PoolAllocator&&) = delete;				 // Move constructor
+	PoolAllocator& operator=(const PoolAllocator&) = delete; // Copy assignment
+	PoolAllocator& operator=(PoolAllocator&&) = delete;		 // Move assignment
+
+	/// Releases the blocks cached on the shared list and by the calling thread.
+	~PoolAllocator() override;
+
+	void* allocate(size_t nBytes) override;
+
+	void deallocate(void* memory, size_t nBytes) override;
+
+	/// Releases the blocks cached on the shared list and by the calling thread.
+	void release();
+
+	/// Gets number of bytes kept on the shared list and by the calling thread.
+	size_t getCachedBytes() const;
+
+	/// Gets size of the block serving a request of `nBytes`.
+	static size_t getBlockSize(size_t nBytes) noexcept;
+
+private:
+	/// Gets index of the size class for a block of `blockSize` bytes.
+	static size_t _getSizeClass(size_t blockSize) noexcept;
+
+private:
+	const uint64_t id_;
+	const size_t maxThreadCachedBytes_;
+	const size_t maxBlockSize_;
+
+	mutable std::mutex sharedFreeListsMutex_;
+	std::vector<std::vector<void*>> sharedFreeLists_;
+};
+} // namespace mlCore::allocators
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef MLCORE_INCLUDE_MLCORE_BFLOAT16_H
+#define MLCORE_INCLUDE_MLCORE_BFLOAT16_H
+
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <iostream>
+
+namespace mlCore
+{
+/**
+ * @brief 16-bit brain floating point number, i.e. the upper half of a float. Keeps the range of float with 8 bits of
+ * precision, so that the tensors take half of the memory and bandwidth of the float ones.
+ *
+ * The type is meant for storage only - the arithmetic is computed in float and the results are rounded to the nearest
+ * representable value (ties to even). Conversion to float is exact and explicit, so that mixed expressions are always
+ * computed with BFloat16's operators.
+ */
+class BFloat16
+{
+public:
+	/// Constructs zero.
+	constexpr BFloat16() noexcept = default;
+
+	/// Rounds the value to the nearest BFloat16. Implicit, so that the type can be used like the built-in ones.
+	constexpr BFloat16(const float value) noexcept // NOLINT(google-explicit-constructor)
+		: bits_(_roundFromFloat(value))
+	{ }
+
+	/// Converts the value to float without loss of precision.
+	constexpr explicit operator float() const noexcept
+	{
+		return std::bit_cast<float>(static_cast<uint32_t>(bits_) << 16);
+	}
+
+	/// Gets the raw representation of the number.
+	constexpr uint16_t getBits() const noexcept
+	{
+		return bits_;
+	}
+
+	constexpr BFloat16& operator+=(const BFloat16 other) noexcept
+	{
+		return *this = BFloat16(float(*this) + float(other));
+	}
+
+	constexpr BFloat16& operator-=(const BFloat16 other) noexcept
+	{
+		return *this = BFloat16(float(*this) - float(other));
+	}
+
+	constexpr BFloat16& operator*=(const BFloat16 other) noexcept
+	{
+		return *this = BFloat16(float(*this) * float(other));
+	}
+
+	constexpr BFloat16& operator/=(const BFloat16 other) noexcept
+	{
+		return *this = BFloat16(float(*this) / float(other));
+	}
+
+	friend constexpr BFloat16 operator+(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) + float(rhs);
+	}
+
+	friend constexpr BFloat16 operator-(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) - float(rhs);
+	}
+
+	friend constexpr BFloat16 operator*(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) * float(rhs);
+	}
+
+	friend constexpr BFloat16 operator/(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) / float(rhs);
+	}
+
+	friend constexpr BFloat16 operator-(const BFloat16 value) noexcept
+	{
+		BFloat16 negated;
+		negated.bits_ = static_cast<uint16_t>(value.bits_ ^ kSignMask);
+
+		return negated;
+	}
+
+	friend constexpr bool operator==(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) == float(rhs);
+	}
+
+	friend constexpr std::partial_ordering operator<=>(const BFloat16 lhs, const BFloat16 rhs) noexcept
+	{
+		return float(lhs) <=> float(rhs);
+	}
+
+	friend std::ostream& operator<<(std::ostream& out, const BFloat16 value)
+	{
+		return out << float(value);
+	}
+
+private:
+	static constexpr uint16_t kSignMask = 0x8000;
+
+	/// Takes the upper half of the float rounded to the nearest even value. NaNs are kept quiet.
+	static constexpr uint16_t _roundFromFloat(const float value) noexcept
+	{
+		const auto bits = std::bit_cast<uint32_t>(value);
+
+		if((bits & 0x7fffffffU) > 0x7f800000U)
+		{
+			return static_cast<uint16_t>((bits >> 16) | 0x0040U);
+		}
+
+		const uint32_t roundingBias = 0x7fffU + ((bits >> 16) & 1U);
+
+		return static_cast<uint16_t>((bits + roundingBias) >> 16);
+	}
+
+	uint16_t bits_ = 0;
+};
+
+/// Type in which the math functions of the ValueType's elements are computed - float for BFloat16 and the ValueType
+/// itself for the other types.
+template <typename ValueType>
+struct ComputeType
+{
+	using Type = ValueType;
+};
+
+template <>
+struct ComputeType<BFloat16>
+{
+	using Type = float;
+};
+
+} // namespace mlCore
+
+#endif
@@ -12,15 +12,22 @@
 #include <vector>
 
 #include <LoggingLib/LoggingLib.hpp>
+#include <MLCore/BFloat16.h>
 #include <MLCore/Utilities.h>
 #include <MLCore/TensorInitializers/ITensorInitializer.hpp>
 #include <MLCore/TensorIterator.hpp>
 
 namespace mlCore
 {
+template <typename ValueType>
+class BasicTensorView;
+
 /**
  * @brief Class implements a concept of tensor, support basic operation, transposition etc.
  * 
+ * Copies of a tensor share its storage, which is duplicated only on the first modification of a tensor whose storage
+ * is shared (copy-on-write), so passing tensors by value costs O(1) until one of them is modified.
+ * 
  * @tparam ValueType Type of the underlying data
  */
 template <typename ValueType>
@@ -32,7 +39,13 @@ class BasicTensor
 	template <typename OperationsImplType>
 	friend class TensorOperationsImpl;
 
+	template <typename ViewValueType>
+	friend class BasicTensorView;
+
 public:
+	/// Type of the tensor's elements.
+	using ElementType = ValueType;
+
 	/**
 	 * @brief Constructs a new scalar-type tensor.
 	 * 
@@ -52,7 +65,7 @@ public:
 	BasicTensor(ValueType initVal);
 
 	/**
-	 * @brief Copy constructor.
+	 * @brief Copy constructor. The storage is shared with `other` until one of the tensors is modified.
 	 * 
 	 * @param other Tensor to copy.
 	 */
@@ -95,7 +108,7 @@ public:
 	~BasicTensor();
 
 	/**
-	 * @brief Copy assignment operator.
+	 * @brief Copy assignment operator. The storage is shared with `other` until one of the tensors is modified.
 	 * 
 	 * @param other Tensor to copy.
 	 * @return BasicTensor& 
@@ -128,15 +141,35 @@ public:
 		return length_;
 	}
 
+	/// Tells whether the tensor shares its storage with `other`, so both hold the same elements until one is modified.
+	bool sharesStorage(const BasicTensor& other) const noexcept
+	{
+		return storage_ && (storage_ == other.storage_);
+	}
+
 	/// Gets beginning tensor's iterator.
-	inline TensorIterator<ValueType> begin() const
+	inline TensorIterator<const ValueType> begin() const
 	{
-		return TensorIterator<ValueType>(data_);
+		return TensorIterator<const ValueType>(data_);
 	}
 
 	/// Gets ending tensor's iterator.
-	inline TensorIterator<ValueType> end() const
+	inline TensorIterator<const ValueType> end() const
+	{
+		return TensorIterator<const ValueType>(data_ + length_);
+	}
+
+	/// Gets beginning iterator allowing to modify the elements. Detaches the tensor from the storage shared with others.
+	inline TensorIterator<ValueType> begin()
 	{
+		_detachStorage();
+		return TensorIterator<ValueType>(data_);
+	}
+
+	/// Gets ending iterator allowing to modify the elements. Detaches the tensor from the storage shared with others.
+	inline TensorIterator<ValueType> end()
+	{
+		_detachStorage();
 		return TensorIterator<ValueType>(data_ + length_);
 	}
 
@@ -159,16 +192,28 @@ public:
 				bool wrapData = false);
 
 	/// Creates a product of adding `this` with `other` tensor.
-	BasicTensor operator+(const BasicTensor& other) const;
+	BasicTensor operator+(const BasicTensor& other) const&;
 
 	/// Creates a product of subtracting `other` tensor from `this`.
-	BasicTensor operator-(const BasicTensor& other) const;
+	BasicTensor operator-(const BasicTensor& other) const&;
 
 	/// Creates a product of multiplying `this` by `other` tensor.
-	BasicTensor operator*(const BasicTensor& other) const;
+	BasicTensor operator*(const BasicTensor& other) const&;
 
 	/// Creates a product of dividing `this` by `other` tensor.
-	BasicTensor operator/(const BasicTensor& other) const;
+	BasicTensor operator/(const BasicTensor& other) const&;
+
+	/// Same as above, but writes the result to the storage of the expiring `this` if possible.
+	BasicTensor operator+(const BasicTensor& other) &&;
+
+	/// Same as above, but writes the result to the storage of the expiring `this` if possible.
+	BasicTensor operator-(const BasicTensor& other) &&;
+
+	/// Same as above, but writes the result to the storage of the expiring `this` if possible.
+	BasicTensor operator*(const BasicTensor& other) &&;
+
+	/// Same as above, but writes the result to the storage of the expiring `this` if possible.
+	BasicTensor operator/(const BasicTensor& other) &&;
 
 	/// Adds `other` tensor to `this`.
 	BasicTensor& operator+=(const BasicTensor& other);
@@ -193,6 +238,14 @@ public:
 	 */
 	BasicTensor matmul(const BasicTensor& other) const;
 
+	/**
+	 * @brief Performs matrix multiplication operation on `this` and `other` view, e.g. a transposed tensor.
+	 * 
+	 * @param other View to matrix-multiply `this` by.
+	 * @return BasicTensor Product of matrix multiplication.
+	 */
+	BasicTensor matmul(const BasicTensorView<ValueType>& other) const;
+
 	/**
 	 * @brief Creates transposed version of `this`.
 	 * 
@@ -241,6 +294,8 @@ public:
 			}
 		}
 
+		_detachStorage();
+
 		InputIter collectionIter = first;
 		for(size_t i = 0; i < length_; i++)
 		{
@@ -274,17 +329,61 @@ private:
 	/// Checks if the given `shape` is compatible with the number of elements held by the tensor
 	void _checkShapeCompatible(const std::vector<size_t>& shape) const;
 
+	/// Allocates new storage for `length_` elements with the allocator returned by getCurrentAllocator.
+	void _allocate();
+
+	/// Makes the tensor the only owner of its storage, copying the elements if the storage is shared. Has to be called
+	/// before any modification of the elements.
+	void _detachStorage();
+
 private:
 	size_t length_;
 	std::vector<size_t> shape_;
+	std::shared_ptr<ValueType[]> storage_;
 	ValueType* data_;
 };
 
 template <typename TensorValueType>
 std::ostream& operator<<(std::ostream& out, const BasicTensor<TensorValueType>& tensor);
 
+/// Creates a product of adding `lhs` with `rhs` and writes it to the storage of the expiring `rhs` if possible.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator+(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Creates a product of subtracting `rhs` from `lhs` and writes it to the storage of the expiring `rhs` if possible.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator-(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Creates a product of multiplying `lhs` by `rhs` and writes it to the storage of the expiring `rhs` if possible.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator*(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Creates a product of dividing `lhs` by `rhs` and writes it to the storage of the expiring `rhs` if possible.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator/(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Resolves the ambiguity between the overloads reusing the storage of one of the expiring operands.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator+(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Resolves the ambiguity between the overloads reusing the storage of one of the expiring operands.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator-(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Resolves the ambiguity between the overloads reusing the storage of one of the expiring operands.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator*(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs);
+
+/// Resolves the ambiguity between the overloads reusing the storage of one of the expiring operands.
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator/(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs);
+
 using Tensor = BasicTensor<double>;
 using TensorPtr = std::shared_ptr<Tensor>;
+
+using FloatTensor = BasicTensor<float>;
+using Int32Tensor = BasicTensor<int32_t>;
+using BFloat16Tensor = BasicTensor<BFloat16>;
 } // namespace mlCore
 
 #endif
\ No newline at end of file
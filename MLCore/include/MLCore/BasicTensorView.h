@@ -0,0 +1,162 @@
+#ifndef MLCORE_BASICTENSORVIEW_H
+#define MLCORE_BASICTENSORVIEW_H
+
+#include <memory>
+#include <vector>
+
+#include <MLCore/BasicTensor.h>
+
+namespace mlCore
+{
+/**
+ * @brief Read-only strided view of a tensor's elements. The view shares storage with the tensor it has been created from
+ * and describes its elements with a shape, strides and a starting position, so that transposition, permutation,
+ * slicing, squeezing and broadcasting are performed without copying the data.
+ *
+ * The view keeps the storage alive, so it can outlive the tensor. Since the storage is shared, the tensor copies it on
+ * the first modification, so the view keeps describing the values the tensor had when the view was created.
+ *
+ * @tparam ValueType Type of the underlying data
+ */
+template <typename ValueType>
+class BasicTensorView
+{
+public:
+	BasicTensorView() = delete; // Default constructor
+
+	/**
+	 * @brief Creates a view covering the whole tensor. Allows passing tensors wherever views are expected.
+	 *
+	 * @param tensor Tensor whose storage is shared.
+	 */
+	BasicTensorView(const BasicTensor<ValueType>& tensor);
+
+	BasicTensorView(const BasicTensorView&) = default;			  // Copy constructor
+	BasicTensorView(BasicTensorView&&) = default;				  // Move constructor
+	BasicTensorView& operator=(const BasicTensorView&) = default; // Copy assignment
+	BasicTensorView& operator=(BasicTensorView&&) = default;	  // Move assignment
+
+	~BasicTensorView() = default;
+
+	/// Gets view's shape.
+	const std::vector<size_t>& shape() const noexcept
+	{
+		return shape_;
+	}
+
+	/// Gets distances (in elements) between consecutive elements along each dimension.
+	const std::vector<size_t>& strides() const noexcept
+	{
+		return strides_;
+	}
+
+	/// Gets number of view's dimensions.
+	size_t nDimensions() const noexcept
+	{
+		return shape_.size();
+	}
+
+	/// Gets number of view's elements.
+	size_t size() const noexcept;
+
+	/// Gets pointer to the first element of the view.
+	const ValueType* data() const noexcept
+	{
+		return data_;
+	}
+
+	/// Tells whether the elements are laid out in memory in row-major order without gaps.
+	bool isContiguous() const noexcept;
+
+	/**
+	 * @brief Gets the element at the given position. Throws std::out_of_range if the indices are invalid.
+	 *
+	 * @param indices Index along each dimension of the view.
+	 */
+	ValueType at(const std::vector<size_t>& indices) const;
+
+	/// Creates a view with the last two dimensions swapped. Requires at least two dimensions.
+	BasicTensorView transposed() const;
+
+	/**
+	 * @brief Creates a view with reordered dimensions.
+	 *
+	 * @param axes Permutation of the dimensions, i.e. dimension `i` of the result is dimension `axes[i]` of `this`.
+	 */
+	BasicTensorView permuted(const std::vector<size_t>& axes) const;
+
+	/**
+	 * @brief Creates a view containing only a range of indices along one dimension.
+	 *
+	 * @param axis Sliced dimension.
+	 * @param begin First index included in the slice.
+	 * @param end Index after the last one included in the slice.
+	 */
+	BasicTensorView sliced(size_t axis, size_t begin, size_t end) const;
+
+	/// Creates a view without the given dimension, which has to be of size 1.
+	BasicTensorView squeezed(size_t axis) const;
+
+	/// Creates a view with a new dimension of size 1 inserted before the given one.
+	BasicTensorView unsqueezed(size_t axis) const;
+
+	/**
+	 * @brief Creates a view stretched to the given shape according to the broadcasting rules. Stretched dimensions are
+	 * given zero strides.
+	 *
+	 * @param shape Target shape, having at least as many dimensions as `this`.
+	 */
+	BasicTensorView broadcastedTo(const std::vector<size_t>& shape) const;
+
+	/**
+	 * @brief Creates a view with a different shape and the same number of elements. Copies the data only if the view is
+	 * not contiguous.
+	 *
+	 * @param shape New shape.
+	 */
+	BasicTensorView reshaped(const std::vector<size_t>& shape) const;
+
+	/// Creates a contiguous tensor containing the view's elements.
+	BasicTensor<ValueType> contiguous() const;
+
+	/// Creates a product of adding `this` with `other` view.
+	BasicTensor<ValueType> operator+(const BasicTensorView& other) const;
+
+	/// Creates a product of subtracting `other` view from `this`.
+	BasicTensor<ValueType> operator-(const BasicTensorView& other) const;
+
+	/// Creates a product of multiplying `this` by `other` view.
+	BasicTensor<ValueType> operator*(const BasicTensorView& other) const;
+
+	/// Creates a product of dividing `this` by `other` view.
+	BasicTensor<ValueType> operator/(const BasicTensorView& other) const;
+
+	/**
+	 * @brief Performs matrix multiplication of `this` and `other` view. Transposed operands are read in place.
+	 *
+	 * @param other View to matrix-multiply `this` by.
+	 * @return Product of matrix multiplication.
+	 */
+	BasicTensor<ValueType> matmul(const BasicTensorView& other) const;
+
+private:
+	/// Creates view from its components.
+	BasicTensorView(std::shared_ptr<ValueType[]> storage,
+					const ValueType* data,
+					std::vector<size_t> shape,
+					std::vector<size_t> strides);
+
+	/// Throws std::out_of_range if the `axis` does not point to any of the view's dimensions.
+	void _checkAxis(size_t axis, size_t nDimensions) const;
+
+private:
+	std::shared_ptr<ValueType[]> storage_;
+	const ValueType* data_;
+	std::vector<size_t> shape_;
+	std::vector<size_t> strides_;
+};
+
+using TensorView = BasicTensorView<double>;
+} // namespace mlCore
+
+#endif
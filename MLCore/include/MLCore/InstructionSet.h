@@ -0,0 +1,62 @@
+#ifndef MLCORE_INCLUDE_MLCORE_INSTRUCTIONSET_H
+#define MLCORE_INCLUDE_MLCORE_INSTRUCTIONSET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mlCore
+{
+/**
+ * @brief Levels of SIMD instructions the tensor kernels can be run with. Higher levels contain the lower ones.
+ *
+ */
+enum class InstructionSet : uint8_t
+{
+	SCALAR,
+	SSE2,
+	AVX2,
+	AVX512
+};
+
+/**
+ * @brief Detects the most capable instruction set supported both by the host CPU and the operating system.
+ *
+ * @return Detected instruction set.
+ */
+InstructionSet detectInstructionSet();
+
+/**
+ * @brief Gets all instruction sets whose kernels can be run on the host, starting from the least capable one.
+ *
+ */
+std::vector<InstructionSet> getSupportedInstructionSets();
+
+/**
+ * @brief Gets the instruction set currently used by the tensor kernels.
+ *
+ * By default it is the detected one, unless `MLCORE_INSTRUCTION_SET` environment variable (scalar, sse2, avx2, avx512)
+ * specifies a lower level.
+ */
+InstructionSet getInstructionSet();
+
+/**
+ * @brief Forces the tensor kernels to use the given instruction set. Useful for benchmarking and testing particular code paths.
+ * Throws std::runtime_error if the host does not support the requested level.
+ *
+ * @param instructionSet Instruction set to use.
+ */
+void setInstructionSet(InstructionSet instructionSet);
+
+/**
+ * @brief Brings back the instruction set chosen at startup.
+ *
+ */
+void resetInstructionSet();
+
+/// Gets the lowercase name of the instruction set.
+std::string stringifyInstructionSet(InstructionSet instructionSet);
+
+} // namespace mlCore
+
+#endif
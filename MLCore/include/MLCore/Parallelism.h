@@ -0,0 +1,61 @@
+#ifndef MLCORE_INCLUDE_MLCORE_PARALLELISM_H
+#define MLCORE_INCLUDE_MLCORE_PARALLELISM_H
+
+#include <memory>
+
+#include <Utilities/ThreadPool.h>
+
+namespace mlCore
+{
+/**
+ * @brief Sets the thread pool used by the tensor kernels on threads having no pool bound with ThreadPoolScope.
+ * Passing nullptr makes the kernels run on the calling thread only, which is the default.
+ *
+ * @param threadPool Pool the kernels split their work onto.
+ */
+void setGlobalThreadPool(std::shared_ptr<utilities::ThreadPool> threadPool);
+
+/// Gets the pool set with setGlobalThreadPool.
+std::shared_ptr<utilities::ThreadPool> getGlobalThreadPool();
+
+/**
+ * @brief Gets the pool used by the tensor kernels called on the current thread, i.e. the one bound with the innermost
+ * ThreadPoolScope or the global one.
+ *
+ */
+std::shared_ptr<utilities::ThreadPool> getCurrentThreadPool();
+
+/**
+ * @brief Binds a thread pool to the current thread for the lifetime of the object. Tensor kernels called on the thread
+ * within the scope split their work onto the bound pool instead of the global one.
+ *
+ * The results of the kernels do not depend on the used pool nor on its size.
+ */
+class ThreadPoolScope
+{
+public:
+	ThreadPoolScope() = delete; // Default constructor
+
+	/**
+	 * @brief Binds the pool to the current thread.
+	 *
+	 * @param threadPool Pool to be used. nullptr makes the kernels run on the calling thread only.
+	 */
+	explicit ThreadPoolScope(std::shared_ptr<utilities::ThreadPool> threadPool);
+
+	ThreadPoolScope(const ThreadPoolScope&) = delete;			 // Copy constructor
+	ThreadPoolScope(ThreadPoolScope&&) = delete;				 // Move constructor
+	ThreadPoolScope& operator=(const ThreadPoolScope&) = delete; // Copy assignment
+	ThreadPoolScope& operator=(ThreadPoolScope&&) = delete;		 // Move assignment
+
+	/// Brings back the pool bound before the scope was created.
+	~ThreadPoolScope();
+
+private:
+	std::shared_ptr<utilities::ThreadPool> previousPool_;
+	bool hadPreviousPool_;
+};
+
+} // namespace mlCore
+
+#endif
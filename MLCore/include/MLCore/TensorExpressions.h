@@ -0,0 +1,475 @@
+#ifndef MLCORE_INCLUDE_MLCORE_TENSOREXPRESSIONS_H
+#define MLCORE_INCLUDE_MLCORE_TENSOREXPRESSIONS_H
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <MLCore/BasicTensor.h>
+
+/**
+ * @brief Lazy evaluation of elementwise tensor expressions.
+ *
+ * The operators of BasicTensor compute each step of an expression into a separate tensor. Wrapping one of the operands
+ * with `lazy` makes the operators build an expression tree instead, which is evaluated in a single loop over the
+ * result when converted to a BasicTensor, so no intermediate tensors are created:
+ *
+ * ```
+ * const Tensor result = -lazy(lhs) / (lazy(rhs) * rhs) + 1.0;
+ * ```
+ *
+ * The operands follow the same broadcasting rules as the BasicTensor's operators. The expressions hold copies of the
+ * tensors, which share the storage with the original ones, so they stay valid after the tensors go out of scope.
+ */
+namespace mlCore::expressions
+{
+namespace detail
+{
+/// Gets the shape of the broadcasting result. Throws std::runtime_error if the shapes are incompatible.
+std::vector<size_t> broadcastShapes(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape);
+
+/// Computes strides of a contiguous tensor along the dimensions of `outputShape`, with zero strides for the stretched
+/// dimensions.
+std::vector<size_t> computeStrides(const std::vector<size_t>& shape, const std::vector<size_t>& outputShape);
+
+/// Reads elements of a tensor having the shape of the result.
+template <typename ValueType>
+class ContiguousEvaluator
+{
+public:
+	explicit ContiguousEvaluator(const ValueType* data)
+		: data_(data)
+	{ }
+
+	ValueType operator[](const size_t pos) const
+	{
+		return data_[pos];
+	}
+
+	void step(size_t /*dim*/) { }
+
+	void rewind(size_t /*dim*/, size_t /*count*/) { }
+
+private:
+	const ValueType* data_;
+};
+
+/// Reads elements of a tensor stretched to the shape of the result. The position passed to the operator[] is relative
+/// to the beginning of the current row of the result.
+template <typename ValueType>
+class StridedEvaluator
+{
+public:
+	StridedEvaluator(const ValueType* data, std::vector<size_t> strides)
+		: data_(data)
+		, strides_(std::move(strides))
+		, rowStride_(strides_.back())
+		, offset_(0)
+	{ }
+
+	StridedEvaluator(const StridedEvaluator&) = default;			// Copy constructor
+	StridedEvaluator(StridedEvaluator&&) = default;					// Move constructor
+	StridedEvaluator& operator=(const StridedEvaluator&) = default; // Copy assignment
+	StridedEvaluator& operator=(StridedEvaluator&&) = default;		// Move assignment
+	~StridedEvaluator() = default;									// Destructor
+
+	ValueType operator[](const size_t pos) const
+	{
+		return data_[offset_ + pos * rowStride_];
+	}
+
+	/// Moves to the next index along the dimension.
+	void step(const size_t dim)
+	{
+		offset_ += strides_[dim];
+	}
+
+	/// Moves back by `count` indices along the dimension.
+	void rewind(const size_t dim, const size_t count)
+	{
+		offset_ -= count * strides_[dim];
+	}
+
+private:
+	const ValueType* data_;
+	std::vector<size_t> strides_;
+	size_t rowStride_;
+	size_t offset_;
+};
+
+/// Gives the same value for each element of the result.
+template <typename ValueType>
+class ScalarEvaluator
+{
+public:
+	explicit ScalarEvaluator(const ValueType value)
+		: value_(value)
+	{ }
+
+	ValueType operator[](size_t /*pos*/) const
+	{
+		return value_;
+	}
+
+	void step(size_t /*dim*/) { }
+
+	void rewind(size_t /*dim*/, size_t /*count*/) { }
+
+private:
+	ValueType value_;
+};
+
+/// Applies the operation to the elements given by the operand's evaluator.
+template <typename OperandEvaluator, typename Operation>
+class UnaryEvaluator
+{
+public:
+	explicit UnaryEvaluator(OperandEvaluator operand)
+		: operand_(std::move(operand))
+	{ }
+
+	auto operator[](const size_t pos) const
+	{
+		return Operation{}(operand_[pos]);
+	}
+
+	void step(const size_t dim)
+	{
+		operand_.step(dim);
+	}
+
+	void rewind(const size_t dim, const size_t count)
+	{
+		operand_.rewind(dim, count);
+	}
+
+private:
+	OperandEvaluator operand_;
+};
+
+/// Applies the operation to the elements given by the operands' evaluators.
+template <typename LhsEvaluator, typename RhsEvaluator, typename Operation>
+class BinaryEvaluator
+{
+public:
+	BinaryEvaluator(LhsEvaluator lhs, RhsEvaluator rhs)
+		: lhs_(std::move(lhs))
+		, rhs_(std::move(rhs))
+	{ }
+
+	auto operator[](const size_t pos) const
+	{
+		return Operation{}(lhs_[pos], rhs_[pos]);
+	}
+
+	void step(const size_t dim)
+	{
+		lhs_.step(dim);
+		rhs_.step(dim);
+	}
+
+	void rewind(const size_t dim, const size_t count)
+	{
+		lhs_.rewind(dim, count);
+		rhs_.rewind(dim, count);
+	}
+
+private:
+	LhsEvaluator lhs_;
+	RhsEvaluator rhs_;
+};
+} // namespace detail
+
+/**
+ * @brief Base of the expression tree's nodes. Each node provides:
+ * - `shape()` - shape of the node's result,
+ * - `isContiguousIn(outputShape)` - whether all tensors in the subtree have the shape of the output, so that they can be
+ * read with a single index,
+ * - `makeEvaluator<kContiguous>(outputShape)` - object computing the elements of the node's result.
+ *
+ * @tparam Derived Type of the node.
+ * @tparam ValueType Type of the elements.
+ */
+template <typename Derived, typename ValueType>
+class Expression
+{
+public:
+	/// Gets the node as its actual type.
+	const Derived& derived() const noexcept
+	{
+		return static_cast<const Derived&>(*this);
+	}
+
+	/**
+	 * @brief Computes the result of the whole expression in a single pass. If all of the tensors have the shape of the
+	 * result, the elements are computed in one flat loop, otherwise row by row with the stretched tensors walked with
+	 * precomputed strides.
+	 *
+	 * @return Tensor with the broadcasted shape of the operands.
+	 */
+	BasicTensor<ValueType> evaluate() const
+	{
+		const auto& outputShape = derived().shape();
+
+		BasicTensor<ValueType> result(outputShape);
+		ValueType* const output = &*result.begin();
+
+		if(derived().isContiguousIn(outputShape))
+		{
+			const auto evaluator = derived().template makeEvaluator<true>(outputShape);
+
+			for(size_t pos = 0; pos < result.size(); pos++)
+			{
+				output[pos] = evaluator[pos];
+			}
+
+			return result;
+		}
+
+		auto evaluator = derived().template makeEvaluator<false>(outputShape);
+
+		const size_t nOuterDims = outputShape.size() - 1;
+		const size_t rowLength = outputShape.back();
+		const size_t nRows = result.size() / rowLength;
+
+		std::vector<size_t> outerPath(nOuterDims, 0);
+
+		for(size_t row = 0; row < nRows; row++)
+		{
+			ValueType* const rowOutput = output + row * rowLength;
+
+			for(size_t pos = 0; pos < rowLength; pos++)
+			{
+				rowOutput[pos] = evaluator[pos];
+			}
+
+			for(size_t dim = nOuterDims - 1; dim < nOuterDims; dim--)
+			{
+				outerPath[dim]++;
+				evaluator.step(dim);
+
+				if(outerPath[dim] < outputShape[dim])
+				{
+					break;
+				}
+
+				evaluator.rewind(dim, outerPath[dim]);
+				outerPath[dim] = 0;
+			}
+		}
+
+		return result;
+	}
+
+	/// Evaluates the expression when assigned to a tensor.
+	operator BasicTensor<ValueType>() const // NOLINT(google-explicit-constructor)
+	{
+		return evaluate();
+	}
+};
+
+/// Leaf of the expression holding a tensor.
+template <typename ValueType>
+class TensorOperand : public Expression<TensorOperand<ValueType>, ValueType>
+{
+public:
+	explicit TensorOperand(BasicTensor<ValueType> tensor)
+		: tensor_(std::move(tensor))
+	{ }
+
+	const std::vector<size_t>& shape() const noexcept
+	{
+		return tensor_.shape();
+	}
+
+	bool isContiguousIn(const std::vector<size_t>& outputShape) const
+	{
+		return tensor_.shape() == outputShape;
+	}
+
+	template <bool kContiguous>
+	auto makeEvaluator(const std::vector<size_t>& outputShape) const
+	{
+		if constexpr(kContiguous)
+		{
+			return detail::ContiguousEvaluator<ValueType>(&*tensor_.begin());
+		}
+		else
+		{
+			return detail::StridedEvaluator<ValueType>(&*tensor_.begin(), detail::computeStrides(tensor_.shape(), outputShape));
+		}
+	}
+
+private:
+	BasicTensor<ValueType> tensor_;
+};
+
+/// Leaf of the expression holding a single value.
+template <typename ValueType>
+class ScalarOperand : public Expression<ScalarOperand<ValueType>, ValueType>
+{
+public:
+	explicit ScalarOperand(const ValueType value)
+		: value_(value)
+	{ }
+
+	const std::vector<size_t>& shape() const noexcept
+	{
+		static const std::vector<size_t> scalarShape{};
+		return scalarShape;
+	}
+
+	bool isContiguousIn(const std::vector<size_t>& /*outputShape*/) const noexcept
+	{
+		return true;
+	}
+
+	template <bool kContiguous>
+	auto makeEvaluator(const std::vector<size_t>& /*outputShape*/) const
+	{
+		return detail::ScalarEvaluator<ValueType>(value_);
+	}
+
+private:
+	ValueType value_;
+};
+
+/// Node applying an elementwise operation to a single operand.
+template <typename Operand, typename Operation, typename ValueType>
+class UnaryExpression : public Expression<UnaryExpression<Operand, Operation, ValueType>, ValueType>
+{
+public:
+	explicit UnaryExpression(Operand operand)
+		: operand_(std::move(operand))
+	{ }
+
+	const std::vector<size_t>& shape() const noexcept
+	{
+		return operand_.shape();
+	}
+
+	bool isContiguousIn(const std::vector<size_t>& outputShape) const
+	{
+		return operand_.isContiguousIn(outputShape);
+	}
+
+	template <bool kContiguous>
+	auto makeEvaluator(const std::vector<size_t>& outputShape) const
+	{
+		using OperandEvaluator = decltype(operand_.template makeEvaluator<kContiguous>(outputShape));
+
+		return detail::UnaryEvaluator<OperandEvaluator, Operation>(operand_.template makeEvaluator<kContiguous>(outputShape));
+	}
+
+private:
+	Operand operand_;
+};
+
+/// Node applying an elementwise operation to two operands. The shapes are checked when the node is created.
+template <typename Lhs, typename Rhs, typename Operation, typename ValueType>
+class BinaryExpression : public Expression<BinaryExpression<Lhs, Rhs, Operation, ValueType>, ValueType>
+{
+public:
+	BinaryExpression(Lhs lhs, Rhs rhs)
+		: lhs_(std::move(lhs))
+		, rhs_(std::move(rhs))
+		, shape_(detail::broadcastShapes(lhs_.shape(), rhs_.shape()))
+	{ }
+
+	const std::vector<size_t>& shape() const noexcept
+	{
+		return shape_;
+	}
+
+	bool isContiguousIn(const std::vector<size_t>& outputShape) const
+	{
+		return lhs_.isContiguousIn(outputShape) && rhs_.isContiguousIn(outputShape);
+	}
+
+	template <bool kContiguous>
+	auto makeEvaluator(const std::vector<size_t>& outputShape) const
+	{
+		using LhsEvaluator = decltype(lhs_.template makeEvaluator<kContiguous>(outputShape));
+		using RhsEvaluator = decltype(rhs_.template makeEvaluator<kContiguous>(outputShape));
+
+		return detail::BinaryEvaluator<LhsEvaluator, RhsEvaluator, Operation>(
+			lhs_.template makeEvaluator<kContiguous>(outputShape), rhs_.template makeEvaluator<kContiguous>(outputShape));
+	}
+
+private:
+	Lhs lhs_;
+	Rhs rhs_;
+	std::vector<size_t> shape_;
+};
+
+/// Starts a lazily evaluated expression with the tensor.
+template <typename ValueType>
+TensorOperand<ValueType> lazy(BasicTensor<ValueType> tensor)
+{
+	return TensorOperand<ValueType>(std::move(tensor));
+}
+
+/// Creates a node negating the expression.
+template <typename Operand, typename ValueType>
+UnaryExpression<Operand, std::negate<ValueType>, ValueType> operator-(const Expression<Operand, ValueType>& operand)
+{
+	return UnaryExpression<Operand, std::negate<ValueType>, ValueType>(operand.derived());
+}
+
+// NOLINTBEGIN
+
+// Defines the operator for each combination of an expression with another expression, a tensor or a single value. The
+// tensors are taken by value, so that the operators are preferred over the BasicTensor's ones converting the expression
+#define EXPRESSION_OPERATOR(op, Operation)                                                                                       \
+	template <typename Lhs, typename Rhs, typename ValueType>                                                                    \
+	BinaryExpression<Lhs, Rhs, Operation<ValueType>, ValueType> operator op(const Expression<Lhs, ValueType>& lhs,               \
+																			const Expression<Rhs, ValueType>& rhs)               \
+	{                                                                                                                            \
+		return BinaryExpression<Lhs, Rhs, Operation<ValueType>, ValueType>(lhs.derived(), rhs.derived());                        \
+	}                                                                                                                            \
+                                                                                                                                 \
+	template <typename Lhs, typename ValueType>                                                                                  \
+	BinaryExpression<Lhs, TensorOperand<ValueType>, Operation<ValueType>, ValueType> operator op(                                \
+		const Expression<Lhs, ValueType>& lhs, BasicTensor<ValueType> rhs)                                                       \
+	{                                                                                                                            \
+		return BinaryExpression<Lhs, TensorOperand<ValueType>, Operation<ValueType>, ValueType>(                                 \
+			lhs.derived(), TensorOperand<ValueType>(std::move(rhs)));                                                            \
+	}                                                                                                                            \
+                                                                                                                                 \
+	template <typename Rhs, typename ValueType>                                                                                  \
+	BinaryExpression<TensorOperand<ValueType>, Rhs, Operation<ValueType>, ValueType> operator op(                                \
+		BasicTensor<ValueType> lhs, const Expression<Rhs, ValueType>& rhs)                                                       \
+	{                                                                                                                            \
+		return BinaryExpression<TensorOperand<ValueType>, Rhs, Operation<ValueType>, ValueType>(                                 \
+			TensorOperand<ValueType>(std::move(lhs)), rhs.derived());                                                            \
+	}                                                                                                                            \
+                                                                                                                                 \
+	template <typename Lhs, typename ValueType>                                                                                  \
+	BinaryExpression<Lhs, ScalarOperand<ValueType>, Operation<ValueType>, ValueType> operator op(                                \
+		const Expression<Lhs, ValueType>& lhs, const std::type_identity_t<ValueType> rhs)                                        \
+	{                                                                                                                            \
+		return BinaryExpression<Lhs, ScalarOperand<ValueType>, Operation<ValueType>, ValueType>(lhs.derived(),                   \
+																								ScalarOperand<ValueType>(rhs));  \
+	}                                                                                                                            \
+                                                                                                                                 \
+	template <typename Rhs, typename ValueType>                                                                                  \
+	BinaryExpression<ScalarOperand<ValueType>, Rhs, Operation<ValueType>, ValueType> operator op(                                \
+		const std::type_identity_t<ValueType> lhs, const Expression<Rhs, ValueType>& rhs)                                        \
+	{                                                                                                                            \
+		return BinaryExpression<ScalarOperand<ValueType>, Rhs, Operation<ValueType>, ValueType>(ScalarOperand<ValueType>(lhs),   \
+																								rhs.derived());                  \
+	}
+
+EXPRESSION_OPERATOR(+, std::plus)
+EXPRESSION_OPERATOR(-, std::minus)
+EXPRESSION_OPERATOR(*, std::multiplies)
+EXPRESSION_OPERATOR(/, std::divides)
+
+#undef EXPRESSION_OPERATOR
+
+// NOLINTEND
+
+} // namespace mlCore::expressions
+
+#endif
@@ -4,7 +4,7 @@ namespace mlCore::autoDiff::binaryOperators
 {
 void AddOperator::updateValue()
 {
-	value_ = lhsInput_->getValue() + rhsInput_->getValue();
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> AddOperator::computeDerivative(const Tensor& outerDerivative) const
@@ -18,4 +18,39 @@ std::pair<Tensor, Tensor> AddOperator::computeDirectDerivative() const
 
 	return {Tensor(leftInput->getValue().shape(), 1.0), Tensor(rightInput->getValue().shape(), 1.0)};
 }
+
+BinaryOperator::RequiredDerivatives AddOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																			const bool isLhsRequired,
+																			const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor AddOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return lhsValue + rhsValue;
+}
+
+BinaryOperator::RequiredDerivatives AddOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																		 const Tensor& /*lhsValue*/,
+																		 const Tensor& /*rhsValue*/,
+																		 const Tensor& /*value*/,
+																		 const bool isLhsRequired,
+																		 const bool isRhsRequired) const
+{
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first = outerDerivative;
+	}
+
+	if(isRhsRequired)
+	{
+		derivatives.second = outerDerivative;
+	}
+
+	return derivatives;
+}
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
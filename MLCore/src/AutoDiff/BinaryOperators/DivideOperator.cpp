@@ -1,17 +1,24 @@
 #include <AutoDiff/BinaryOperators/DivideOperator.h>
 
+#include <MLCore/TensorExpressions.h>
+
 namespace mlCore::autoDiff::binaryOperators
 {
 void DivideOperator::updateValue()
 {
-	value_ = lhsInput_->getValue() / rhsInput_->getValue();
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> DivideOperator::computeDerivative(const Tensor& outerDerivative) const
 {
-	auto [leftDerivative, rightDerivative] = computeDirectDerivative();
+	using expressions::lazy;
+
+	const auto& [leftInputNode, rightInputNode] = getInputs();
+	const auto& leftValue = leftInputNode->getValue();
+	const auto& rightValue = rightInputNode->getValue();
 
-	return {leftDerivative * outerDerivative, rightDerivative * outerDerivative};
+	// whole chains are evaluated in a single pass, without the intermediate tensors
+	return {1.0 / lazy(rightValue) * outerDerivative, -lazy(leftValue) / (lazy(rightValue) * rightValue) * outerDerivative};
 }
 
 std::pair<Tensor, Tensor> DivideOperator::computeDirectDerivative() const
@@ -20,6 +27,45 @@ std::pair<Tensor, Tensor> DivideOperator::computeDirectDerivative() const
 	const auto& leftValue = leftInputNode->getValue();
 	const auto& rightValue = rightInputNode->getValue();
 
-	return {(Tensor(rightValue.shape(), 1.0) / rightValue), -leftValue / (rightValue * rightValue)};
+	using expressions::lazy;
+
+	return {1.0 / lazy(rightValue), -lazy(leftValue) / (lazy(rightValue) * rightValue)};
+}
+
+BinaryOperator::RequiredDerivatives DivideOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																			   const bool isLhsRequired,
+																			   const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor DivideOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return lhsValue / rhsValue;
+}
+
+BinaryOperator::RequiredDerivatives DivideOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																			const Tensor& lhsValue,
+																			const Tensor& rhsValue,
+																			const Tensor& /*value*/,
+																			const bool isLhsRequired,
+																			const bool isRhsRequired) const
+{
+	using expressions::lazy;
+
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first = Tensor(1.0 / lazy(rhsValue) * outerDerivative);
+	}
+
+	if(isRhsRequired)
+	{
+		derivatives.second = Tensor(-lazy(lhsValue) / (lazy(rhsValue) * rhsValue) * outerDerivative);
+	}
+
+	return derivatives;
 }
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include <AutoDiff/BinaryOperators/MatmulOperator.h>
 
+#include <MLCore/BasicTensorView.h>
+
 namespace mlCore::autoDiff::binaryOperators
 {
 void MatmulOperator::updateValue()
 {
-	value_ = lhsInput_->getValue().matmul(rhsInput_->getValue());
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> MatmulOperator::computeDerivative(const Tensor& outerDerivative) const
@@ -13,7 +15,9 @@ std::pair<Tensor, Tensor> MatmulOperator::computeDerivative(const Tensor& outerD
 	const auto& leftValue = leftInputNode->getValue();
 	const auto& rightValue = rightInputNode->getValue();
 
-	return {outerDerivative.matmul(rightValue.transposed()), leftValue.transposed().matmul(outerDerivative)};
+	// the transposed inputs are read in place instead of being copied
+	return {outerDerivative.matmul(TensorView(rightValue).transposed()),
+			TensorView(leftValue).transposed().matmul(outerDerivative)};
 }
 
 std::pair<Tensor, Tensor> MatmulOperator::computeDirectDerivative() const
@@ -24,6 +28,42 @@ std::pair<Tensor, Tensor> MatmulOperator::computeDirectDerivative() const
 
 	const Tensor onesWithOutputShape(value_.shape(), 1.0);
 
-	return {onesWithOutputShape.matmul(rightValue.transposed()), leftValue.transposed().matmul(onesWithOutputShape)};
+	return {onesWithOutputShape.matmul(TensorView(rightValue).transposed()),
+			TensorView(leftValue).transposed().matmul(onesWithOutputShape)};
+}
+
+BinaryOperator::RequiredDerivatives MatmulOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																			   const bool isLhsRequired,
+																			   const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor MatmulOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return lhsValue.matmul(rhsValue);
+}
+
+BinaryOperator::RequiredDerivatives MatmulOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																			const Tensor& lhsValue,
+																			const Tensor& rhsValue,
+																			const Tensor& /*value*/,
+																			const bool isLhsRequired,
+																			const bool isRhsRequired) const
+{
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first = outerDerivative.matmul(TensorView(rhsValue).transposed());
+	}
+
+	if(isRhsRequired)
+	{
+		derivatives.second = TensorView(lhsValue).transposed().matmul(outerDerivative);
+	}
+
+	return derivatives;
 }
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
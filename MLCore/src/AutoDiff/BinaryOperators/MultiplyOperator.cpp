@@ -4,7 +4,7 @@ namespace mlCore::autoDiff::binaryOperators
 {
 void MultiplyOperator::updateValue()
 {
-	value_ = lhsInput_->getValue() * rhsInput_->getValue();
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> MultiplyOperator::computeDerivative(const Tensor& outerDerivative) const
@@ -22,4 +22,39 @@ std::pair<Tensor, Tensor> MultiplyOperator::computeDirectDerivative() const
 
 	return {rightValue, leftValue};
 }
+
+BinaryOperator::RequiredDerivatives MultiplyOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																				 const bool isLhsRequired,
+																				 const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor MultiplyOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return lhsValue * rhsValue;
+}
+
+BinaryOperator::RequiredDerivatives MultiplyOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																			  const Tensor& lhsValue,
+																			  const Tensor& rhsValue,
+																			  const Tensor& /*value*/,
+																			  const bool isLhsRequired,
+																			  const bool isRhsRequired) const
+{
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first = rhsValue * outerDerivative;
+	}
+
+	if(isRhsRequired)
+	{
+		derivatives.second = lhsValue * outerDerivative;
+	}
+
+	return derivatives;
+}
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
@@ -5,7 +5,7 @@ namespace mlCore::autoDiff::binaryOperators
 {
 void PowerOperator::updateValue()
 {
-	value_ = TensorOperations::power(lhsInput_->getValue(), rhsInput_->getValue());
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> PowerOperator::computeDerivative(const Tensor& outerDerivative) const
@@ -24,4 +24,41 @@ std::pair<Tensor, Tensor> PowerOperator::computeDirectDerivative() const
 	return {TensorOperations::power(leftValue, rightValue - Tensor(rightValue.shape(), 1)) * rightValue,
 			TensorOperations::ln(leftValue) * TensorOperations::power(leftValue, rightValue)};
 }
+
+BinaryOperator::RequiredDerivatives PowerOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																			  const bool isLhsRequired,
+																			  const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor PowerOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return TensorOperations::power(lhsValue, rhsValue);
+}
+
+BinaryOperator::RequiredDerivatives PowerOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																		   const Tensor& lhsValue,
+																		   const Tensor& rhsValue,
+																		   const Tensor& value,
+																		   const bool isLhsRequired,
+																		   const bool isRhsRequired) const
+{
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first =
+			TensorOperations::power(lhsValue, rhsValue - Tensor(rhsValue.shape(), 1)) * rhsValue * outerDerivative;
+	}
+
+	// skipped for constant exponents, which saves computing the logarithm
+	if(isRhsRequired)
+	{
+		derivatives.second = TensorOperations::ln(lhsValue) * value * outerDerivative;
+	}
+
+	return derivatives;
+}
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
@@ -4,7 +4,7 @@ namespace mlCore::autoDiff::binaryOperators
 {
 void SubtractOperator::updateValue()
 {
-	value_ = lhsInput_->getValue() - rhsInput_->getValue();
+	value_ = computeValue(lhsInput_->getValue(), rhsInput_->getValue());
 }
 
 std::pair<Tensor, Tensor> SubtractOperator::computeDerivative(const Tensor& outerDerivative) const
@@ -18,4 +18,39 @@ std::pair<Tensor, Tensor> SubtractOperator::computeDirectDerivative() const
 
 	return {Tensor(lhs->getValue().shape(), 1.0), Tensor(rhs->getValue().shape(), -1.0)};
 }
+
+BinaryOperator::RequiredDerivatives SubtractOperator::computeRequiredDerivatives(const Tensor& outerDerivative,
+																				 const bool isLhsRequired,
+																				 const bool isRhsRequired) const
+{
+	return computeInputDerivatives(
+		outerDerivative, lhsInput_->getValue(), rhsInput_->getValue(), value_, isLhsRequired, isRhsRequired);
+}
+
+Tensor SubtractOperator::computeValue(const Tensor& lhsValue, const Tensor& rhsValue) const
+{
+	return lhsValue - rhsValue;
+}
+
+BinaryOperator::RequiredDerivatives SubtractOperator::computeInputDerivatives(const Tensor& outerDerivative,
+																			  const Tensor& /*lhsValue*/,
+																			  const Tensor& /*rhsValue*/,
+																			  const Tensor& /*value*/,
+																			  const bool isLhsRequired,
+																			  const bool isRhsRequired) const
+{
+	RequiredDerivatives derivatives;
+
+	if(isLhsRequired)
+	{
+		derivatives.first = outerDerivative;
+	}
+
+	if(isRhsRequired)
+	{
+		derivatives.second = -outerDerivative;
+	}
+
+	return derivatives;
+}
 } // namespace mlCore::autoDiff::binaryOperators
\ No newline at end of file
@@ -1,41 +1,159 @@
 #include <AutoDiff/ComputationGraph.h>
 
-#include <set>
+#include <fmt/format.h>
 
 #include <AutoDiff/BinaryOperators/BinaryOperator.h>
 #include <AutoDiff/UnaryOperators/UnaryOperator.h>
+#include <MLCore/Allocation.h>
+#include <MLCore/Parallelism.h>
 
 namespace mlCore::autoDiff
 {
+namespace
+{
+/// Calls the callback with each input of the node.
+template <typename Callback>
+void forEachInput(const Node& node, Callback&& callback)
+{
+	if(const auto* const binaryOper = dynamic_cast<const binaryOperators::BinaryOperator*>(&node))
+	{
+		const auto [lhs, rhs] = binaryOper->getInputs();
+
+		callback(lhs);
+		callback(rhs);
+	}
+	else if(const auto* const unaryOper = dynamic_cast<const unaryOperators::UnaryOperator*>(&node))
+	{
+		callback(unaryOper->getInput());
+	}
+}
+
+/// Tells whether the tensors have the same shapes and values. The values of the tensors sharing storage are not compared.
+bool areEqual(const Tensor& lhs, const Tensor& rhs)
+{
+	return (lhs.shape() == rhs.shape()) &&
+		   (lhs.sharesStorage(rhs) || std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+}
+} // namespace
+
+void ComputationGraph::reset() noexcept
+{
+	nodes_.clear();
+	nodeIndices_.clear();
+	idIndices_.clear();
+	nameIndices_.clear();
+	gradients_.clear();
+	plan_.reset();
+	nodeVersions_.clear();
+}
+
+void ComputationGraph::clearGradients()
+{
+	std::fill(gradients_.begin(), gradients_.end(), std::nullopt);
+}
 
 bool ComputationGraph::hasGradient(const size_t& nodeId) const
 {
-	return std::find_if(gradients_.begin(), gradients_.end(), [&nodeId](const std::pair<NodePtr, Tensor>& nodeGrad) {
-			   return nodeGrad.first->getIndex() == nodeId;
-		   }) == gradients_.end();
+	return _findGradientById(nodeId).has_value();
 }
 
 bool ComputationGraph::hasGradient(const std::string& nodeName) const
 {
-	return std::find_if(gradients_.begin(), gradients_.end(), [&nodeName](const std::pair<NodePtr, Tensor>& nodeGrad) {
-			   return nodeGrad.first->getName() == nodeName;
-		   }) == gradients_.end();
+	return _findGradientByName(nodeName).has_value();
 }
 
 const Tensor& ComputationGraph::getGradientByNodeId(const size_t& nodeId) const
 {
-	return std::find_if(gradients_.begin(),
-						gradients_.end(),
-						[&nodeId](const std::pair<NodePtr, Tensor>& nodeGrad) { return nodeGrad.first->getIndex() == nodeId; })
-		->second;
+	if(const auto slot = _findGradientById(nodeId))
+	{
+		return *gradients_[*slot];
+	}
+
+	throw std::runtime_error(fmt::format("There is no gradient computed for node with id {}.", nodeId));
 }
 
 const Tensor& ComputationGraph::getGradientByNodeName(const std::string& nodeName) const
 {
-	return std::find_if(gradients_.begin(),
-						gradients_.end(),
-						[&nodeName](const std::pair<NodePtr, Tensor>& nodeGrad) { return nodeGrad.first->getName() == nodeName; })
-		->second;
+	if(const auto slot = _findGradientByName(nodeName))
+	{
+		return *gradients_[*slot];
+	}
+
+	throw std::runtime_error(fmt::format("There is no gradient computed for node with name '{}'.", nodeName));
+}
+
+std::vector<NodeGradient> ComputationGraph::getGradients() const
+{
+	std::vector<NodeGradient> nodeGradients;
+
+	// the nodes removed from the compiled plan share the gradients of their duplicates
+	for(size_t nodeIndex = 0; nodeIndex < gradients_.size(); nodeIndex++)
+	{
+		if(const auto& gradient = gradients_[_getGradientSlot(nodeIndex)])
+		{
+			nodeGradients.emplace_back(nodes_[nodeIndex], std::cref(*gradient));
+		}
+	}
+
+	return nodeGradients;
+}
+
+std::optional<size_t> ComputationGraph::_findGradientById(const size_t nodeId) const
+{
+	if(const auto index = idIndices_.find(nodeId); index != idIndices_.end())
+	{
+		if(const size_t slot = _getGradientSlot(index->second); gradients_[slot])
+		{
+			return slot;
+		}
+	}
+
+	return std::nullopt;
+}
+
+size_t ComputationGraph::_getGradientSlot(const size_t nodeIndex) const
+{
+	if(plan_)
+	{
+		return plan_->findSlot(nodes_[nodeIndex].get()).value_or(nodeIndex);
+	}
+
+	return nodeIndex;
+}
+
+std::optional<size_t> ComputationGraph::_findGradientByName(const std::string& nodeName) const
+{
+	const auto findIndex = [this, &nodeName]() -> std::optional<size_t> {
+		if(const auto index = nameIndices_.find(nodeName);
+		   index != nameIndices_.end() && nodes_[index->second]->getName() == nodeName)
+		{
+			return index->second;
+		}
+
+		return std::nullopt;
+	};
+
+	auto index = findIndex();
+
+	// the nodes could have been renamed since they were registered
+	if(!index)
+	{
+		nameIndices_.clear();
+
+		for(size_t nodeIndex = 0; nodeIndex < nodes_.size(); nodeIndex++)
+		{
+			nameIndices_.emplace(nodes_[nodeIndex]->getName(), nodeIndex);
+		}
+
+		index = findIndex();
+	}
+
+	if(index && gradients_[_getGradientSlot(*index)])
+	{
+		return _getGradientSlot(*index);
+	}
+
+	return std::nullopt;
 }
 
 void ComputationGraph::addNode(const NodePtr node)
@@ -46,132 +164,322 @@ void ComputationGraph::addNode(const NodePtr node)
 		return;
 	}
 
-	areNodesSorted_ = false;
+	if(nodeIndices_.contains(node.get()))
+	{
+		return;
+	}
+
+	bool areInputsContained = true;
+
+	forEachInput(*node, [this, &areInputsContained](const NodePtr& input) {
+		areInputsContained = areInputsContained && nodeIndices_.contains(input.get());
+	});
+
+	_indexNode(node);
+
+	// a node added after its inputs keeps the order valid, so the compiled plan can be extended unless it is rewritten
+	if(plan_ && areInputsContained && !compileOptions_.isRewriting())
+	{
+		plan_->append(node);
+		planCache_.clear();
+	}
+	else
+	{
+		plan_.reset();
+	}
+}
+
+void ComputationGraph::_indexNode(const NodePtr& node)
+{
+	const size_t index = nodes_.size();
+
 	nodes_.push_back(node);
+	nodeIndices_.emplace(node.get(), index);
+	idIndices_.emplace(node->getIndex(), index);
+	nameIndices_.emplace(node->getName(), index);
+	gradients_.emplace_back();
 }
 
-void ComputationGraph::_sortNodes()
+std::vector<size_t> ComputationGraph::_sortNodes()
 {
+	// the inputs which have not been added explicitly are indexed as well, so that the whole trees can be run
+	std::vector<std::pair<size_t, size_t>> edges;
 
-	std::set<NodePtr> nodesWithParent;
+	for(size_t nodeIndex = 0; nodeIndex < nodes_.size(); nodeIndex++)
+	{
+		forEachInput(*nodes_[nodeIndex], [this, &edges, nodeIndex](const NodePtr& input) {
+			if(!nodeIndices_.contains(input.get()))
+			{
+				_indexNode(input);
+			}
 
-	for(const auto& node : nodes_)
+			edges.emplace_back(nodeIndices_.at(input.get()), nodeIndex);
+		});
+	}
+
+	std::vector<size_t> nPendingInputs(nodes_.size(), 0);
+	std::vector<std::vector<size_t>> consumers(nodes_.size());
+
+	for(const auto& [input, consumer] : edges)
 	{
-		if(const auto castedBinaryOp = std::dynamic_pointer_cast<binaryOperators::BinaryOperator>(node))
-		{
-			const auto& [lhs, rhs] = castedBinaryOp->getInputs();
+		nPendingInputs[consumer]++;
+		consumers[input].push_back(consumer);
+	}
+
+	// Kahn's algorithm - the nodes are emitted once all of their inputs have been emitted
+	std::vector<size_t> order;
+	order.reserve(nodes_.size());
 
-			nodesWithParent.insert(lhs);
-			nodesWithParent.insert(rhs);
+	for(size_t nodeIndex = 0; nodeIndex < nodes_.size(); nodeIndex++)
+	{
+		if(nPendingInputs[nodeIndex] == 0)
+		{
+			order.push_back(nodeIndex);
 		}
-		else if(const auto castedUnaryOp = std::dynamic_pointer_cast<unaryOperators::UnaryOperator>(node))
+	}
+
+	for(size_t orderPos = 0; orderPos < order.size(); orderPos++)
+	{
+		for(const auto consumer : consumers[order[orderPos]])
 		{
-			nodesWithParent.insert(castedUnaryOp->getInput());
+			if(--nPendingInputs[consumer] == 0)
+			{
+				order.push_back(consumer);
+			}
 		}
 	}
 
-	std::set<NodePtr> orphanedNodes;
+	if(order.size() != nodes_.size())
+	{
+		LOG_ERROR("ComputationGraph", "Cannot sort the nodes, since the graph contains a cycle.");
+	}
+
+	return order;
+}
 
-	std::set_difference(nodes_.cbegin(),
-						nodes_.cend(),
-						nodesWithParent.cbegin(),
-						nodesWithParent.cend(),
-						std::inserter(orphanedNodes, orphanedNodes.end()));
+const ExecutionPlan& ComputationGraph::compile()
+{
+	if(!plan_)
+	{
+		const auto order = _sortNodes();
 
-	std::vector<NodePtr> newNodes;
+		plan_.emplace(nodes_, order);
+		plan_->setProfiler(profiler_);
+		plan_->setLivenessMode(livenessMode_);
+		planCache_.clear();
+		nodeVersions_.clear();
 
-	// recursively goes down the tree in a DFS manner and adds nodes to newNodes so that all inputs can be assigned before the operators
-	std::function<void(const NodePtr)> traverseTree;
-	traverseTree = [&traverseTree, &newNodes](const NodePtr node) {
-		if(const auto castedBinaryOp = std::dynamic_pointer_cast<binaryOperators::BinaryOperator>(node))
+		if(compileOptions_.foldConstants)
 		{
-			const auto& [lhs, rhs] = castedBinaryOp->getInputs();
-			traverseTree(lhs);
-			traverseTree(rhs);
+			plan_->foldConstants();
 		}
-		else if(const auto castedUnaryOp = std::dynamic_pointer_cast<unaryOperators::UnaryOperator>(node))
+
+		if(compileOptions_.eliminateCommonSubexpressions)
 		{
-			traverseTree(castedUnaryOp->getInput());
+			plan_->eliminateCommonSubexpressions();
 		}
 
-		if(std::find(newNodes.begin(), newNodes.end(), node) == newNodes.end())
+		if(compileOptions_.fuseElementwise)
 		{
-			newNodes.push_back(node);
+			plan_->fuseElementwise();
 		}
-	};
-
-	for(const auto& orphanedNode : orphanedNodes)
-	{
-		traverseTree(orphanedNode);
 	}
 
-	nodes_ = newNodes;
+	return *plan_;
+}
 
-	areNodesSorted_ = true;
+MemoryEstimate ComputationGraph::estimateMemory(const LivenessMode mode,
+												const std::map<PlaceholderPtr, std::vector<size_t>>& placeholderShapes)
+{
+	return getShapedPlan(mode, placeholderShapes).memoryEstimate;
 }
 
-void ComputationGraph::forwardPass(const std::map<PlaceholderPtr, Tensor>& feedDict)
+const ShapedPlan& ComputationGraph::getShapedPlan(const LivenessMode mode,
+												  const std::map<PlaceholderPtr, std::vector<size_t>>& placeholderShapes)
 {
-	if(!areNodesSorted_)
+	const auto& plan = compile();
+
+	std::unordered_map<const Node*, const std::vector<size_t>*> givenShapes;
+
+	for(const auto& [placeholder, shape] : placeholderShapes)
 	{
-		_sortNodes();
+		givenShapes.emplace(placeholder.get(), &shape);
 	}
 
+	// all placeholders make up the key, since the ones not given may have been fed with other shapes since
+	std::map<size_t, std::vector<size_t>> leafShapes;
+
 	for(const auto& node : nodes_)
 	{
-		if(const auto placeholder = std::dynamic_pointer_cast<Placeholder>(node);
-		   placeholder && (feedDict.find(placeholder) != feedDict.end()))
+		if(!dynamic_cast<const Placeholder*>(node.get()))
 		{
-			placeholder->getValue() = feedDict.at(placeholder);
+			continue;
 		}
-		else if(const auto binaryOper = std::dynamic_pointer_cast<binaryOperators::BinaryOperator>(node))
+
+		// only the given shapes are batched, the other placeholders may hold e.g. parameters fed once
+		const auto givenShape = givenShapes.find(node.get());
+		auto shape = (givenShape != givenShapes.end()) ? planCache_.padShape(*givenShape->second) : node->getValue().shape();
+
+		leafShapes.emplace(*plan.findSlot(node.get()), std::move(shape));
+	}
+
+	return planCache_.getPlan(plan, mode, leafShapes, allocator_ ? allocator_ : getCurrentAllocator());
+}
+
+const ShapedPlan& ComputationGraph::_getFedShapedPlan(const LivenessMode mode,
+													  const std::map<PlaceholderPtr, Tensor>& feedDict)
+{
+	std::map<PlaceholderPtr, std::vector<size_t>> placeholderShapes;
+
+	for(const auto& [placeholder, value] : feedDict)
+	{
+		placeholderShapes.emplace(placeholder, value.shape());
+	}
+
+	return getShapedPlan(mode, placeholderShapes);
+}
+
+void ComputationGraph::forwardPass(const std::map<PlaceholderPtr, Tensor>& feedDict, const bool isFull)
+{
+	const AllocatorScope allocatorScope(allocator_ ? allocator_ : getCurrentAllocator());
+	const ThreadPoolScope threadPoolScope(intraOpThreadPool_ ? intraOpThreadPool_ : getCurrentThreadPool());
+
+	const auto& plan = compile();
+
+	for(const auto& [placeholder, value] : feedDict)
+	{
+		if(plan.findSlot(placeholder.get()) && !(isIncrementalForward_ && areEqual(placeholder->getValue(), value)))
 		{
-			binaryOper->updateValue();
+			placeholder->setValue(value);
 		}
-		else if(const auto unaryOper = std::dynamic_pointer_cast<unaryOperators::UnaryOperator>(node))
+	}
+
+	// the values dropped by the previous pass cannot be reused, while the buffers of the previous passes can
+	if(livenessMode_)
+	{
+		plan.runForward(interOpThreadPool_, _getFedShapedPlan(*livenessMode_, feedDict).valueAllocators);
+	}
+	else if(!isIncrementalForward_ || isFull || nodeVersions_.empty())
+	{
+		plan.runForward(interOpThreadPool_);
+	}
+	else
+	{
+		// the nodes added since the last pass are computed as well
+		std::vector<bool> isChanged(nodes_.size(), true);
+
+		for(size_t nodeIndex = 0; nodeIndex < nodeVersions_.size(); nodeIndex++)
 		{
-			unaryOper->updateValue();
+			isChanged[nodeIndex] = nodes_[nodeIndex]->getVersion() != nodeVersions_[nodeIndex];
 		}
+
+		plan.runForward(plan.markDirtyInstructions(isChanged), interOpThreadPool_);
 	}
-}
 
-void ComputationGraph::computeGradients(const NodePtr root)
-{
-	if(!areNodesSorted_)
+	if(isIncrementalForward_)
 	{
-		_sortNodes();
+		nodeVersions_.resize(nodes_.size());
+
+		std::transform(nodes_.cbegin(), nodes_.cend(), nodeVersions_.begin(), [](const NodePtr& node) {
+			return node->getVersion();
+		});
 	}
+}
+
+void ComputationGraph::computeGradients(const NodePtr root, const std::vector<NodePtr>& wrt)
+{
+	const AllocatorScope allocatorScope(allocator_ ? allocator_ : getCurrentAllocator());
+	const ThreadPoolScope threadPoolScope(intraOpThreadPool_ ? intraOpThreadPool_ : getCurrentThreadPool());
+
+	const auto& plan = compile();
+
+	const auto [rootSlot, wrtSlots] = _getBackwardSlots(plan, root, wrt);
+
+	auto gradients = plan.runBackward(rootSlot, wrtSlots, interOpThreadPool_);
 
-	std::function<void(const NodePtr, const Tensor&)> backPropagate;
+	// the plan's slots are the indices of the nodes
+	for(size_t slot = 0; slot < gradients.size(); slot++)
+	{
+		if(!gradients[slot])
+		{
+			continue;
+		}
 
-	// traverses the nodes tree and computes gradient in regard of every node
-	backPropagate = [&backPropagate, this](const NodePtr node, const Tensor& cumulatedGradient) {
-		if(this->gradients_.find(node) == this->gradients_.end())
+		if(auto& accumulated = gradients_[slot])
 		{
-			this->gradients_.emplace(node, cumulatedGradient);
+			accumulateGradient(*accumulated, *gradients[slot]);
 		}
 		else
 		{
-			auto& grad = this->gradients_.at(node);
-			grad = grad + cumulatedGradient;
+			accumulated = std::move(gradients[slot]);
 		}
+	}
+}
 
-		if(const auto castedUnary = std::dynamic_pointer_cast<unaryOperators::UnaryOperator>(node))
+void ComputationGraph::forwardPass(ExecutionContext& context, const std::map<PlaceholderPtr, Tensor>& feedDict) const
+{
+	const AllocatorScope allocatorScope(allocator_ ? allocator_ : getCurrentAllocator());
+	const ThreadPoolScope threadPoolScope(intraOpThreadPool_ ? intraOpThreadPool_ : getCurrentThreadPool());
+
+	const auto& plan = _getCompiledPlan();
+
+	plan.bindContext(context);
+
+	for(const auto& [placeholder, value] : feedDict)
+	{
+		if(plan.findSlot(placeholder.get()))
 		{
-			const auto input = castedUnary->getInput();
-			const auto derivative = castedUnary->computeDerivative(cumulatedGradient);
-			backPropagate(input, cumulatedGradient);
+			context.feed(placeholder, value);
 		}
-		else if(const auto castedBinary = std::dynamic_pointer_cast<binaryOperators::BinaryOperator>(node))
-		{
-			const auto [lInput, rInput] = castedBinary->getInputs();
-			const auto [lDerivative, rDerivative] = castedBinary->computeDerivative(cumulatedGradient);
+	}
+
+	plan.runForward(context, interOpThreadPool_);
+}
+
+void ComputationGraph::computeGradients(ExecutionContext& context,
+										const NodePtr root,
+										const std::vector<NodePtr>& wrt) const
+{
+	const AllocatorScope allocatorScope(allocator_ ? allocator_ : getCurrentAllocator());
+	const ThreadPoolScope threadPoolScope(intraOpThreadPool_ ? intraOpThreadPool_ : getCurrentThreadPool());
+
+	const auto& plan = _getCompiledPlan();
 
-			backPropagate(lInput, lDerivative);
-			backPropagate(rInput, rDerivative);
+	const auto [rootSlot, wrtSlots] = _getBackwardSlots(plan, root, wrt);
+
+	plan.runBackward(context, rootSlot, wrtSlots, interOpThreadPool_);
+}
+
+const ExecutionPlan& ComputationGraph::_getCompiledPlan() const
+{
+	if(!plan_)
+	{
+		throw std::runtime_error("Cannot run the graph with a context before it is compiled.");
+	}
+
+	return *plan_;
+}
+
+std::pair<size_t, std::vector<size_t>> ComputationGraph::_getBackwardSlots(const ExecutionPlan& plan,
+																		   const NodePtr& root,
+																		   const std::vector<NodePtr>& wrt) const
+{
+	const auto getSlot = [&plan](const NodePtr& node) {
+		const auto slot = plan.findSlot(node.get());
+
+		if(!slot)
+		{
+			LOG_ERROR("ComputationGraph", "Cannot compute gradients for node " << node->getIndex() << " outside of the graph.");
 		}
+
+		return *slot;
 	};
 
-	backPropagate(root, Tensor(root->getValue().shape(), 1.0));
+	std::vector<size_t> wrtSlots;
+	wrtSlots.reserve(wrt.size());
+
+	std::transform(wrt.cbegin(), wrt.cend(), std::back_inserter(wrtSlots), getSlot);
+
+	return {getSlot(root), std::move(wrtSlots)};
 }
 } // namespace mlCore::autoDiff
\ No newline at end of file
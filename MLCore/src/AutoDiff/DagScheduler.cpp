@@ -0,0 +1,150 @@
+#include <AutoDiff/DagScheduler.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <MLCore/Allocation.h>
+#include <MLCore/Parallelism.h>
+
+namespace mlCore::autoDiff
+{
+namespace
+{
+/// State of a single runDag call, shared between the caller and the helping jobs.
+struct DagState
+{
+	DagState(const size_t nTasks,
+			 std::vector<size_t> readyTasks,
+			 std::function<void(size_t)> task,
+			 std::function<void(size_t, std::vector<size_t>&)> release)
+		: nRemaining(nTasks)
+		, readyTasks(std::move(readyTasks))
+		, task(std::move(task))
+		, release(std::move(release))
+	{ }
+
+	/// Tells whether no more tasks will be started.
+	bool isFinished() const noexcept
+	{
+		return (nRemaining == 0) || exception;
+	}
+
+	std::mutex mutex{};
+	std::condition_variable changed{};
+
+	size_t nRemaining;
+	size_t nRunning = 0;
+	std::vector<size_t> readyTasks;
+	std::exception_ptr exception = nullptr;
+
+	const std::function<void(size_t)> task;
+	const std::function<void(size_t, std::vector<size_t>&)> release;
+};
+
+/// Runs the ready tasks until all of them are finished.
+void runDagTasks(DagState& state)
+{
+	std::unique_lock<std::mutex> lock(state.mutex);
+
+	while(true)
+	{
+		state.changed.wait(lock, [&state]() { return !state.readyTasks.empty() || state.isFinished(); });
+
+		if(state.isFinished())
+		{
+			return;
+		}
+
+		const size_t taskIdx = state.readyTasks.back();
+		state.readyTasks.pop_back();
+		state.nRunning++;
+
+		lock.unlock();
+
+		std::exception_ptr exception = nullptr;
+
+		try
+		{
+			state.task(taskIdx);
+		}
+		catch(...)
+		{
+			exception = std::current_exception();
+		}
+
+		lock.lock();
+
+		state.nRunning--;
+		state.nRemaining--;
+
+		if(exception && !state.exception)
+		{
+			state.exception = exception;
+		}
+
+		if(!state.exception)
+		{
+			state.release(taskIdx, state.readyTasks);
+		}
+
+		state.changed.notify_all();
+	}
+}
+} // namespace
+
+void runDag(const std::shared_ptr<utilities::ThreadPool>& threadPool,
+			const size_t nTasks,
+			std::vector<size_t> readyTasks,
+			const std::function<void(size_t)>& task,
+			const std::function<void(size_t, std::vector<size_t>&)>& release)
+{
+	const auto state = std::make_shared<DagState>(nTasks, std::move(readyTasks), task, release);
+
+	if(threadPool && threadPool->isRunning() && (nTasks > 1))
+	{
+		const size_t nHelpers = std::min(threadPool->size(), nTasks - 1);
+
+		// the jobs must not own the pools, otherwise a pool could be destroyed by its own worker - the pools are alive
+		// anyway as long as the tasks are being run
+		const std::shared_ptr<utilities::ThreadPool> intraOpPool(std::shared_ptr<utilities::ThreadPool>(),
+																 getCurrentThreadPool().get());
+		const auto allocator = getCurrentAllocator();
+
+		for(size_t helperIdx = 0; helperIdx < nHelpers; helperIdx++)
+		{
+			try
+			{
+				threadPool->addJob([state, intraOpPool, allocator]() {
+					const AllocatorScope allocatorScope(allocator);
+					const ThreadPoolScope threadPoolScope(intraOpPool);
+
+					runDagTasks(*state);
+				});
+			}
+			catch(const std::runtime_error&)
+			{
+				// the pool has been terminated in the meantime - the remaining tasks are run by the caller
+				break;
+			}
+		}
+	}
+
+	runDagTasks(*state);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->changed.wait(lock, [&state]() { return state->nRunning == 0; });
+
+	if(state->exception)
+	{
+		std::rethrow_exception(state->exception);
+	}
+
+	if(state->nRemaining != 0)
+	{
+		throw std::runtime_error("Cannot run the tasks - some of them have never become ready.");
+	}
+}
+
+} // namespace mlCore::autoDiff
@@ -0,0 +1,510 @@
+#include <AutoDiff/ExecutionPlan.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+#include <MLCore/KernelDispatch.h>
+#include <MLCore/TensorExpressions.h>
+
+namespace mlCore::autoDiff
+{
+namespace
+{
+/// Number of elements whose registers are computed by each step at once.
+constexpr size_t kBlockSize = 256;
+
+/// Elements of the tensors stretched to the shape of the result of broadcasting them, walked row by row.
+struct BroadcastWalk
+{
+	std::vector<size_t> resultShape;
+	std::vector<size_t> walkedShape;
+	std::vector<expressions::detail::StridedEvaluator<double>> evaluators;
+};
+
+/**
+ * @brief Prepares walking the elements of the tensors broadcasted to a common shape. The stretched dimensions of each
+ * tensor are read with zero strides, so no tensor is expanded. Tensors having the same shapes are walked as a single row.
+ *
+ * @param tensors Tensors to walk.
+ */
+BroadcastWalk walkBroadcast(const std::vector<const Tensor*>& tensors)
+{
+	BroadcastWalk walk{.resultShape = tensors.front()->shape(), .walkedShape = {}, .evaluators = {}};
+
+	for(const auto* const tensor : tensors)
+	{
+		walk.resultShape = expressions::detail::broadcastShapes(walk.resultShape, tensor->shape());
+	}
+
+	const bool isFlat = std::all_of(tensors.cbegin(), tensors.cend(), [&walk](const Tensor* const tensor) {
+		return tensor->shape() == walk.resultShape;
+	});
+
+	if(isFlat)
+	{
+		walk.walkedShape = {tensors.front()->size()};
+	}
+	else
+	{
+		walk.walkedShape = walk.resultShape;
+	}
+
+	walk.evaluators.reserve(tensors.size());
+
+	for(const auto* const tensor : tensors)
+	{
+		walk.evaluators.emplace_back(&*tensor->begin(),
+									 isFlat ? std::vector<size_t>{1}
+											: expressions::detail::computeStrides(tensor->shape(), walk.resultShape));
+	}
+
+	return walk;
+}
+
+/**
+ * @brief Runs `rowLoop(rowPos, rowLength)` for each row of the walk, where `rowPos` is position of the row's first
+ * element in the result. The evaluators are moved to the row before each call.
+ *
+ * @param walk Walk prepared by walkBroadcast.
+ * @param rowLoop Callable processing the elements of a single row.
+ */
+template <typename RowLoop>
+void forEachRow(BroadcastWalk& walk, RowLoop&& rowLoop)
+{
+	const auto& shape = walk.walkedShape;
+	const size_t nOuterDims = shape.size() - 1;
+	const size_t rowLength = shape.back();
+	const size_t nRows = std::accumulate(shape.cbegin(), shape.cend() - 1, size_t{1}, std::multiplies<>());
+
+	std::vector<size_t> outerPath(nOuterDims, 0);
+
+	for(size_t row = 0; row < nRows; row++)
+	{
+		rowLoop(row * rowLength, rowLength);
+
+		for(size_t dim = nOuterDims - 1; dim < nOuterDims; dim--)
+		{
+			outerPath[dim]++;
+
+			for(auto& evaluator : walk.evaluators)
+			{
+				evaluator.step(dim);
+			}
+
+			if(outerPath[dim] < shape[dim])
+			{
+				break;
+			}
+
+			for(auto& evaluator : walk.evaluators)
+			{
+				evaluator.rewind(dim, outerPath[dim]);
+			}
+
+			outerPath[dim] = 0;
+		}
+	}
+}
+
+/**
+ * @brief Runs `blockLoop(blockPos, blockLength)` for each block of elements of the walk's rows, where `blockPos` is
+ * position of the block's first element in the result.
+ *
+ * @param walk Walk prepared by walkBroadcast.
+ * @param blockLoop Callable processing up to kBlockSize elements of a single row.
+ */
+template <typename BlockLoop>
+void forEachBlock(BroadcastWalk& walk, BlockLoop&& blockLoop)
+{
+	forEachRow(walk, [&blockLoop](const size_t rowPos, const size_t rowLength) {
+		for(size_t blockStart = 0; blockStart < rowLength; blockStart += kBlockSize)
+		{
+			blockLoop(rowPos, blockStart, std::min(kBlockSize, rowLength - blockStart));
+		}
+	});
+}
+
+/// Copies a block of elements read by the evaluator, starting at `blockStart` of the current row, to the register.
+void loadBlock(const expressions::detail::StridedEvaluator<double>& evaluator,
+			   const size_t blockStart,
+			   const size_t blockLength,
+			   double* const block)
+{
+	for(size_t pos = 0; pos < blockLength; pos++)
+	{
+		block[pos] = evaluator[blockStart + pos];
+	}
+}
+
+/**
+ * @brief Computes the values of the steps' registers for a block of elements, each step over the whole block. The
+ * arithmetic operations are run by the vectorized kernels.
+ *
+ * @param steps Steps of the kernel.
+ * @param nInputs Number of the kernel's inputs, whose registers are loaded already.
+ * @param kernels Kernels of the current instruction set.
+ * @param registers Blocks of kBlockSize elements, one per register.
+ * @param blockLength Number of the elements in the block.
+ */
+void runSteps(const std::vector<FusedStep>& steps,
+			  const size_t nInputs,
+			  const KernelTable<double>& kernels,
+			  double* const registers,
+			  const size_t blockLength)
+{
+	for(size_t stepIdx = 0; stepIdx < steps.size(); stepIdx++)
+	{
+		const auto& step = steps[stepIdx];
+		const double* const lhs = registers + step.operands[0] * kBlockSize;
+		const double* const rhs = registers + step.operands[1] * kBlockSize;
+		double* const value = registers + (nInputs + stepIdx) * kBlockSize;
+
+		switch(step.opCode)
+		{
+		case OpCode::ADD:
+			kernels.getBinary(ElementwiseOperation::ADD)(blockLength, lhs, rhs, value);
+			break;
+		case OpCode::SUBTRACT:
+			kernels.getBinary(ElementwiseOperation::SUBTRACT)(blockLength, lhs, rhs, value);
+			break;
+		case OpCode::MULTIPLY:
+			kernels.getBinary(ElementwiseOperation::MULTIPLY)(blockLength, lhs, rhs, value);
+			break;
+		case OpCode::DIVIDE:
+			kernels.getBinary(ElementwiseOperation::DIVIDE)(blockLength, lhs, rhs, value);
+			break;
+		case OpCode::POWER:
+			for(size_t pos = 0; pos < blockLength; pos++)
+			{
+				value[pos] = std::pow(lhs[pos], rhs[pos]);
+			}
+			break;
+		case OpCode::LN:
+			for(size_t pos = 0; pos < blockLength; pos++)
+			{
+				value[pos] = std::log(lhs[pos]);
+			}
+			break;
+		case OpCode::RELU:
+			for(size_t pos = 0; pos < blockLength; pos++)
+			{
+				value[pos] = (lhs[pos] > 0) ? lhs[pos] : 0.0;
+			}
+			break;
+		case OpCode::SIGMOID:
+			for(size_t pos = 0; pos < blockLength; pos++)
+			{
+				value[pos] = 1.0 / (1.0 + std::exp(-lhs[pos]));
+			}
+			break;
+		default:
+			throw std::runtime_error("Cannot run a non-elementwise operation in a fused kernel.");
+		}
+	}
+}
+} // namespace
+
+FusedKernel::FusedKernel(std::vector<size_t> inputs, std::vector<FusedStep> steps)
+	: inputs_(std::move(inputs))
+	, steps_(std::move(steps))
+{ }
+
+Tensor FusedKernel::computeValue(const std::vector<const Tensor*>& inputValues) const
+{
+	const size_t nInputs = inputs_.size();
+	const auto& kernels = getKernelTable<double>();
+
+	auto walk = walkBroadcast(inputValues);
+
+	Tensor value(walk.resultShape);
+	double* const valueData = &*value.begin();
+
+	std::vector<double> registers((nInputs + steps_.size()) * kBlockSize);
+	const double* const valueBlock = registers.data() + (registers.size() - kBlockSize);
+
+	forEachBlock(walk, [&](const size_t rowPos, const size_t blockStart, const size_t blockLength) {
+		for(size_t inputIdx = 0; inputIdx < nInputs; inputIdx++)
+		{
+			loadBlock(walk.evaluators[inputIdx], blockStart, blockLength, registers.data() + inputIdx * kBlockSize);
+		}
+
+		runSteps(steps_, nInputs, kernels, registers.data(), blockLength);
+
+		std::copy(valueBlock, valueBlock + blockLength, valueData + rowPos + blockStart);
+	});
+
+	return value;
+}
+
+std::vector<std::optional<Tensor>> FusedKernel::computeInputDerivatives(const Tensor& outerDerivative,
+																		const std::vector<const Tensor*>& inputValues,
+																		const std::vector<bool>& isRequired) const
+{
+	const size_t nInputs = inputs_.size();
+	const size_t nRegisters = nInputs + steps_.size();
+
+	// the derivatives are propagated only to the registers leading to the required inputs
+	std::vector<bool> isRegisterRequired(isRequired);
+	isRegisterRequired.resize(nRegisters);
+
+	for(size_t stepIdx = 0; stepIdx < steps_.size(); stepIdx++)
+	{
+		const auto& [lhs, rhs] = steps_[stepIdx].operands;
+
+		isRegisterRequired[nInputs + stepIdx] = isRegisterRequired[lhs] || isRegisterRequired[rhs];
+	}
+
+	// the outer derivative is walked together with the inputs, since it may be broadcasted by the kernel's consumer
+	std::vector<const Tensor*> walkedValues(inputValues);
+	walkedValues.push_back(&outerDerivative);
+
+	auto walk = walkBroadcast(walkedValues);
+	const auto& outerEvaluator = walk.evaluators.back();
+
+	// like the replaced operators, the kernel gives the derivatives of the stretched inputs in the broadcasted shape
+	std::vector<std::optional<Tensor>> derivatives(nInputs);
+	std::vector<double*> derivativesData(nInputs, nullptr);
+
+	for(size_t inputIdx = 0; inputIdx < nInputs; inputIdx++)
+	{
+		if(isRequired[inputIdx])
+		{
+			derivativesData[inputIdx] = &*derivatives[inputIdx].emplace(walk.resultShape).begin();
+		}
+	}
+
+	const auto& kernels = getKernelTable<double>();
+	const auto accumulate = kernels.getBinary(ElementwiseOperation::ADD);
+	const auto multiply = kernels.getBinary(ElementwiseOperation::MULTIPLY);
+	const auto divide = kernels.getBinary(ElementwiseOperation::DIVIDE);
+
+	std::vector<double> registers(nRegisters * kBlockSize);
+	std::vector<double> adjoints(nRegisters * kBlockSize);
+	std::vector<double> scratch(kBlockSize);
+
+	const auto blockOf = [](std::vector<double>& blocks, const size_t reg) { return blocks.data() + reg * kBlockSize; };
+
+	forEachBlock(walk, [&](const size_t rowPos, const size_t blockStart, const size_t blockLength) {
+		for(size_t inputIdx = 0; inputIdx < nInputs; inputIdx++)
+		{
+			loadBlock(walk.evaluators[inputIdx], blockStart, blockLength, blockOf(registers, inputIdx));
+		}
+
+		runSteps(steps_, nInputs, kernels, registers.data(), blockLength);
+
+		std::fill(adjoints.begin(), adjoints.end(), 0.0);
+		loadBlock(outerEvaluator, blockStart, blockLength, blockOf(adjoints, nRegisters - 1));
+
+		// the adjoints of the registers not leading to the required inputs are not propagated
+		for(size_t stepIdx = steps_.size(); stepIdx-- > 0;)
+		{
+			if(!isRegisterRequired[nInputs + stepIdx])
+			{
+				continue;
+			}
+
+			const auto& step = steps_[stepIdx];
+			const auto& [lhs, rhs] = step.operands;
+			const double* const adjoint = blockOf(adjoints, nInputs + stepIdx);
+			const double* const lhsValue = blockOf(registers, lhs);
+			const double* const rhsValue = blockOf(registers, rhs);
+			const double* const value = blockOf(registers, nInputs + stepIdx);
+			double* const lhsAdjoint = isRegisterRequired[lhs] ? blockOf(adjoints, lhs) : nullptr;
+			double* const rhsAdjoint = isRegisterRequired[rhs] ? blockOf(adjoints, rhs) : nullptr;
+
+			switch(step.opCode)
+			{
+			case OpCode::ADD:
+			case OpCode::SUBTRACT:
+				if(lhsAdjoint)
+				{
+					accumulate(blockLength, lhsAdjoint, adjoint, lhsAdjoint);
+				}
+				if(rhsAdjoint)
+				{
+					kernels.getBinary((step.opCode == OpCode::ADD) ? ElementwiseOperation::ADD : ElementwiseOperation::SUBTRACT)(
+						blockLength, rhsAdjoint, adjoint, rhsAdjoint);
+				}
+				break;
+			case OpCode::MULTIPLY:
+				if(lhsAdjoint)
+				{
+					multiply(blockLength, adjoint, rhsValue, scratch.data());
+					accumulate(blockLength, lhsAdjoint, scratch.data(), lhsAdjoint);
+				}
+				if(rhsAdjoint)
+				{
+					multiply(blockLength, adjoint, lhsValue, scratch.data());
+					accumulate(blockLength, rhsAdjoint, scratch.data(), rhsAdjoint);
+				}
+				break;
+			case OpCode::DIVIDE:
+				if(lhsAdjoint)
+				{
+					divide(blockLength, adjoint, rhsValue, scratch.data());
+					accumulate(blockLength, lhsAdjoint, scratch.data(), lhsAdjoint);
+				}
+				if(rhsAdjoint)
+				{
+					for(size_t pos = 0; pos < blockLength; pos++)
+					{
+						rhsAdjoint[pos] -= adjoint[pos] * lhsValue[pos] / (rhsValue[pos] * rhsValue[pos]);
+					}
+				}
+				break;
+			case OpCode::POWER:
+				if(lhsAdjoint)
+				{
+					for(size_t pos = 0; pos < blockLength; pos++)
+					{
+						lhsAdjoint[pos] += adjoint[pos] * rhsValue[pos] * std::pow(lhsValue[pos], rhsValue[pos] - 1);
+					}
+				}
+
+				// skipped for constant exponents, which saves computing the logarithm
+				if(rhsAdjoint)
+				{
+					for(size_t pos = 0; pos < blockLength; pos++)
+					{
+						rhsAdjoint[pos] += adjoint[pos] * std::log(lhsValue[pos]) * value[pos];
+					}
+				}
+				break;
+			case OpCode::LN:
+				divide(blockLength, adjoint, lhsValue, scratch.data());
+				accumulate(blockLength, lhsAdjoint, scratch.data(), lhsAdjoint);
+				break;
+			case OpCode::RELU:
+				for(size_t pos = 0; pos < blockLength; pos++)
+				{
+					lhsAdjoint[pos] += (lhsValue[pos] > 0) ? adjoint[pos] : 0.0;
+				}
+				break;
+			case OpCode::SIGMOID:
+				for(size_t pos = 0; pos < blockLength; pos++)
+				{
+					lhsAdjoint[pos] += adjoint[pos] * value[pos] * (1 - value[pos]);
+				}
+				break;
+			default:
+				throw std::runtime_error("Cannot differentiate a non-elementwise operation in a fused kernel.");
+			}
+		}
+
+		for(size_t inputIdx = 0; inputIdx < nInputs; inputIdx++)
+		{
+			if(derivativesData[inputIdx])
+			{
+				const double* const inputAdjoint = blockOf(adjoints, inputIdx);
+
+				std::copy(inputAdjoint, inputAdjoint + blockLength, derivativesData[inputIdx] + rowPos + blockStart);
+			}
+		}
+	});
+
+	return derivatives;
+}
+
+void ExecutionPlan::fuseElementwise()
+{
+	const size_t nInstructions = instructions_.size();
+
+	// the operators read only by a single elementwise consumer are computed in the consumer's kernel
+	std::vector<bool> isFusedIntoConsumer(nInstructions, false);
+
+	for(size_t instructionIdx = 0; instructionIdx < nInstructions; instructionIdx++)
+	{
+		const auto& instruction = instructions_[instructionIdx];
+		const auto& consumers = consumers_[instructionIdx];
+
+		isFusedIntoConsumer[instructionIdx] = isElementwise(instruction.opCode) && (consumers.size() == 1) &&
+											  isElementwise(instructions_[consumers.front()].opCode) &&
+											  slots_[instruction.output]->requiresGrad();
+	}
+
+	std::vector<Instruction> instructions;
+
+	for(size_t instructionIdx = 0; instructionIdx < nInstructions; instructionIdx++)
+	{
+		const auto& instruction = instructions_[instructionIdx];
+
+		if(isFusedIntoConsumer[instructionIdx])
+		{
+			continue;
+		}
+
+		// the chain ending with the instruction, gathered from the consumers to the producers
+		std::vector<size_t> chain{instructionIdx};
+
+		for(size_t chainPos = 0; chainPos < chain.size(); chainPos++)
+		{
+			for(const auto producer : _getInputProducers(instructions_[chain[chainPos]]))
+			{
+				if(isFusedIntoConsumer[producer])
+				{
+					chain.push_back(producer);
+				}
+			}
+		}
+
+		if(chain.size() == 1)
+		{
+			instructions.push_back(instruction);
+			continue;
+		}
+
+		std::sort(chain.begin(), chain.end());
+
+		const auto isInChain = [this, &chain](const size_t slot) {
+			return std::binary_search(chain.cbegin(), chain.cend(), producers_[slot]);
+		};
+
+		std::vector<size_t> inputs;
+
+		for(const auto member : chain)
+		{
+			for(const auto input : _getInputSlots(instructions_[member]))
+			{
+				if(!isInChain(input) && std::find(inputs.cbegin(), inputs.cend(), input) == inputs.cend())
+				{
+					inputs.push_back(input);
+				}
+			}
+		}
+
+		const auto getRegister = [&inputs, &chain, this](const size_t slot) {
+			if(const auto input = std::find(inputs.cbegin(), inputs.cend(), slot); input != inputs.cend())
+			{
+				return static_cast<size_t>(input - inputs.cbegin());
+			}
+
+			const auto member = std::lower_bound(chain.cbegin(), chain.cend(), producers_[slot]);
+
+			return inputs.size() + static_cast<size_t>(member - chain.cbegin());
+		};
+
+		std::vector<FusedStep> steps;
+
+		for(const auto member : chain)
+		{
+			const auto& memberInstruction = instructions_[member];
+			const size_t lhs = getRegister(memberInstruction.inputs[0]);
+			const size_t rhs = isBinary(memberInstruction.opCode) ? getRegister(memberInstruction.inputs[1]) : lhs;
+
+			steps.push_back(
+				{.opCode = memberInstruction.opCode, .operands = {lhs, rhs}, .node = slots_[memberInstruction.output]});
+		}
+
+		const size_t kernelIdx = fusedKernels_.size();
+		fusedKernels_.emplace_back(std::move(inputs), std::move(steps));
+
+		instructions.push_back({.opCode = OpCode::FUSED, .inputs = {kernelIdx, kernelIdx}, .output = instruction.output});
+	}
+
+	instructions_ = std::move(instructions);
+
+	_linkInstructions();
+}
+} // namespace mlCore::autoDiff
@@ -0,0 +1,74 @@
+#include <AutoDiff/ExecutionContext.h>
+
+#include <fmt/format.h>
+
+#include <AutoDiff/ExecutionPlan.h>
+
+namespace mlCore::autoDiff
+{
+void ExecutionContext::feed(const PlaceholderPtr& placeholder, Tensor value)
+{
+	const auto slot = _findSlot(placeholder);
+
+	if(!slot)
+	{
+		throw std::runtime_error(
+			fmt::format("Cannot feed placeholder {} which is not a part of the context's graph.", placeholder->getIndex()));
+	}
+
+	values_[*slot] = std::move(value);
+}
+
+const Tensor& ExecutionContext::getValue(const NodePtr& node) const
+{
+	const auto slot = _findSlot(node);
+
+	if(!slot)
+	{
+		throw std::runtime_error(
+			fmt::format("Cannot get value of node {} which is not a part of the context's graph.", node->getIndex()));
+	}
+
+	return plan_->getValue(*this, *slot);
+}
+
+bool ExecutionContext::hasGradient(const NodePtr& node) const
+{
+	const auto slot = _findSlot(node);
+
+	return slot && gradients_[*slot];
+}
+
+const Tensor& ExecutionContext::getGradient(const NodePtr& node) const
+{
+	const auto slot = _findSlot(node);
+
+	if(!slot || !gradients_[*slot])
+	{
+		throw std::runtime_error(fmt::format("There is no gradient computed for node with id {}.", node->getIndex()));
+	}
+
+	return *gradients_[*slot];
+}
+
+void ExecutionContext::clearGradients()
+{
+	std::fill(gradients_.begin(), gradients_.end(), std::nullopt);
+}
+
+std::optional<size_t> ExecutionContext::_findSlot(const NodePtr& node) const
+{
+	if(!plan_)
+	{
+		return std::nullopt;
+	}
+
+	// the plan could have been extended since the context was last run
+	if(const auto slot = plan_->findSlot(node.get()); slot && *slot < values_.size())
+	{
+		return slot;
+	}
+
+	return std::nullopt;
+}
+} // namespace mlCore::autoDiff
@@ -0,0 +1,1438 @@
+#include <AutoDiff/ExecutionPlan.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <typeinfo>
+
+#include <fmt/format.h>
+
+#include <AutoDiff/BinaryOperators/AddOperator.h>
+#include <AutoDiff/BinaryOperators/DivideOperator.h>
+#include <AutoDiff/BinaryOperators/MatmulOperator.h>
+#include <AutoDiff/BinaryOperators/MultiplyOperator.h>
+#include <AutoDiff/BinaryOperators/PowerOperator.h>
+#include <AutoDiff/BinaryOperators/SubtractOperator.h>
+#include <AutoDiff/DagScheduler.h>
+#include <AutoDiff/UnaryOperators/LnOperator.h>
+#include <AutoDiff/UnaryOperators/ReluOperator.h>
+#include <AutoDiff/UnaryOperators/SigmoidOperator.h>
+#include <LoggingLib/LoggingLib.hpp>
+#include <MLCore/Allocation.h>
+#include <MLCore/TensorExpressions.h>
+#include <MLCore/Utilities.h>
+
+namespace mlCore::autoDiff
+{
+std::string_view getOpCodeName(const OpCode opCode) noexcept
+{
+	switch(opCode)
+	{
+	case OpCode::ADD:
+		return "ADD";
+	case OpCode::SUBTRACT:
+		return "SUBTRACT";
+	case OpCode::MULTIPLY:
+		return "MULTIPLY";
+	case OpCode::DIVIDE:
+		return "DIVIDE";
+	case OpCode::MATMUL:
+		return "MATMUL";
+	case OpCode::POWER:
+		return "POWER";
+	case OpCode::LN:
+		return "LN";
+	case OpCode::RELU:
+		return "RELU";
+	case OpCode::SIGMOID:
+		return "SIGMOID";
+	case OpCode::CUSTOM_BINARY:
+		return "CUSTOM_BINARY";
+	case OpCode::CUSTOM_UNARY:
+		return "CUSTOM_UNARY";
+	case OpCode::FUSED:
+		return "FUSED";
+	}
+
+	return "UNKNOWN";
+}
+
+std::optional<OpCode> getOpCode(const Node& node)
+{
+	const auto& type = typeid(node);
+
+	if(type == typeid(binaryOperators::AddOperator))
+	{
+		return OpCode::ADD;
+	}
+	if(type == typeid(binaryOperators::SubtractOperator))
+	{
+		return OpCode::SUBTRACT;
+	}
+	if(type == typeid(binaryOperators::MultiplyOperator))
+	{
+		return OpCode::MULTIPLY;
+	}
+	if(type == typeid(binaryOperators::DivideOperator))
+	{
+		return OpCode::DIVIDE;
+	}
+	if(type == typeid(binaryOperators::MatmulOperator))
+	{
+		return OpCode::MATMUL;
+	}
+	if(type == typeid(binaryOperators::PowerOperator))
+	{
+		return OpCode::POWER;
+	}
+	if(type == typeid(unaryOperators::LnOperator))
+	{
+		return OpCode::LN;
+	}
+	if(type == typeid(unaryOperators::ReluOperator))
+	{
+		return OpCode::RELU;
+	}
+	if(type == typeid(unaryOperators::SigmoidOperator))
+	{
+		return OpCode::SIGMOID;
+	}
+	if(dynamic_cast<const binaryOperators::BinaryOperator*>(&node))
+	{
+		return OpCode::CUSTOM_BINARY;
+	}
+	if(dynamic_cast<const unaryOperators::UnaryOperator*>(&node))
+	{
+		return OpCode::CUSTOM_UNARY;
+	}
+
+	return std::nullopt;
+}
+
+namespace
+{
+/// Calls the visitor with the node casted to the operator's type given by the code. The built-in operators are final,
+/// so their methods are called directly.
+template <typename Visitor>
+void visitOperator(const OpCode opCode, Node* const node, Visitor&& visitor)
+{
+	switch(opCode)
+	{
+	case OpCode::ADD:
+		visitor(static_cast<binaryOperators::AddOperator*>(node));
+		break;
+	case OpCode::SUBTRACT:
+		visitor(static_cast<binaryOperators::SubtractOperator*>(node));
+		break;
+	case OpCode::MULTIPLY:
+		visitor(static_cast<binaryOperators::MultiplyOperator*>(node));
+		break;
+	case OpCode::DIVIDE:
+		visitor(static_cast<binaryOperators::DivideOperator*>(node));
+		break;
+	case OpCode::MATMUL:
+		visitor(static_cast<binaryOperators::MatmulOperator*>(node));
+		break;
+	case OpCode::POWER:
+		visitor(static_cast<binaryOperators::PowerOperator*>(node));
+		break;
+	case OpCode::LN:
+		visitor(static_cast<unaryOperators::LnOperator*>(node));
+		break;
+	case OpCode::RELU:
+		visitor(static_cast<unaryOperators::ReluOperator*>(node));
+		break;
+	case OpCode::SIGMOID:
+		visitor(static_cast<unaryOperators::SigmoidOperator*>(node));
+		break;
+	case OpCode::CUSTOM_BINARY:
+		visitor(static_cast<binaryOperators::BinaryOperator*>(node));
+		break;
+	case OpCode::CUSTOM_UNARY:
+		visitor(static_cast<unaryOperators::UnaryOperator*>(node));
+		break;
+	case OpCode::FUSED:
+		throw std::runtime_error("Cannot visit the operator of a fused instruction, which is run by its kernel.");
+	}
+}
+
+/// Tells whether the derivatives of the operation are computed from the values of its inputs.
+constexpr bool readsInputsBackward(const OpCode opCode) noexcept
+{
+	return (opCode != OpCode::ADD) && (opCode != OpCode::SUBTRACT) && (opCode != OpCode::SIGMOID);
+}
+
+/// Tells whether the derivatives of the operation are computed from its own value.
+constexpr bool readsOutputBackward(const OpCode opCode) noexcept
+{
+	return (opCode == OpCode::POWER) || (opCode == OpCode::SIGMOID) || (opCode == OpCode::CUSTOM_BINARY) ||
+		   (opCode == OpCode::CUSTOM_UNARY);
+}
+
+/// Gets the shape of the matrix multiplication's result, following the rules of BasicTensor::matmul.
+std::vector<size_t> getMatmulShape(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape)
+{
+	const auto throwIncompatible = [&lhsShape, &rhsShape]() {
+		throw std::runtime_error(fmt::format("Cannot infer shape of matrix multiplication for shapes '{}' and '{}'.",
+											 stringifyVector(lhsShape),
+											 stringifyVector(rhsShape)));
+	};
+
+	if(lhsShape.empty() || rhsShape.size() < 2)
+	{
+		throwIncompatible();
+	}
+
+	const size_t nDims = std::max(lhsShape.size(), rhsShape.size());
+
+	std::vector<size_t> paddedLhs(nDims - lhsShape.size(), 1);
+	paddedLhs.insert(paddedLhs.end(), lhsShape.cbegin(), lhsShape.cend());
+
+	std::vector<size_t> paddedRhs(nDims - rhsShape.size(), 1);
+	paddedRhs.insert(paddedRhs.end(), rhsShape.cbegin(), rhsShape.cend());
+
+	if(paddedLhs[nDims - 1] != paddedRhs[nDims - 2])
+	{
+		throwIncompatible();
+	}
+
+	std::vector<size_t> shape(nDims);
+
+	for(size_t dim = 0; dim < nDims - 2; dim++)
+	{
+		if((paddedLhs[dim] != paddedRhs[dim]) && (paddedLhs[dim] != 1) && (paddedRhs[dim] != 1))
+		{
+			throwIncompatible();
+		}
+
+		shape[dim] = (paddedLhs[dim] == 1) ? paddedRhs[dim] : paddedLhs[dim];
+	}
+
+	shape[nDims - 2] = paddedLhs[nDims - 2];
+	shape[nDims - 1] = paddedRhs[nDims - 1];
+
+	return shape;
+}
+
+/// Gets the shape of the fused kernel's value, broadcasting the shapes of the registers step by step.
+std::vector<size_t> inferFusedShape(const FusedKernel& kernel, const std::vector<std::vector<size_t>>& shapes)
+{
+	std::vector<std::vector<size_t>> registerShapes;
+
+	for(const auto input : kernel.getInputs())
+	{
+		registerShapes.push_back(shapes[input]);
+	}
+
+	for(const auto& step : kernel.getSteps())
+	{
+		const auto& [lhs, rhs] = step.operands;
+
+		registerShapes.push_back(inferShape(step.opCode, registerShapes[lhs], registerShapes[rhs]));
+	}
+
+	return registerShapes.back();
+}
+} // namespace
+
+std::vector<size_t> inferShape(const OpCode opCode, const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape)
+{
+	switch(opCode)
+	{
+	case OpCode::ADD:
+	case OpCode::SUBTRACT:
+	case OpCode::MULTIPLY:
+	case OpCode::DIVIDE:
+	case OpCode::POWER:
+		return expressions::detail::broadcastShapes(lhsShape, rhsShape);
+	case OpCode::MATMUL:
+		return getMatmulShape(lhsShape, rhsShape);
+	case OpCode::LN:
+	case OpCode::RELU:
+	case OpCode::SIGMOID:
+		return lhsShape;
+	default:
+		throw std::runtime_error("Cannot infer shape of an operation which is not a built-in one.");
+	}
+}
+
+void accumulateGradient(Tensor& accumulated, const Tensor& gradient)
+{
+	if(accumulated.shape() == gradient.shape())
+	{
+		accumulated += gradient;
+	}
+	else
+	{
+		accumulated = accumulated + gradient;
+	}
+}
+
+ExecutionPlan::ExecutionPlan(const std::vector<NodePtr>& nodes, const std::vector<size_t>& order)
+{
+	slots_.reserve(nodes.size());
+	slotIndices_.reserve(nodes.size());
+	producers_.reserve(nodes.size());
+
+	for(const auto& node : nodes)
+	{
+		slotIndices_.emplace(node.get(), slots_.size());
+		slots_.push_back(node.get());
+		producers_.push_back(NO_PRODUCER);
+	}
+
+	isFolded_.assign(nodes.size(), false);
+
+	for(const auto slot : order)
+	{
+		_lowerNode(slot);
+	}
+}
+
+void ExecutionPlan::append(const NodePtr& node)
+{
+	const size_t slot = slots_.size();
+
+	slotIndices_.emplace(node.get(), slot);
+	slots_.push_back(node.get());
+	producers_.push_back(NO_PRODUCER);
+	isFolded_.push_back(false);
+
+	_lowerNode(slot);
+}
+
+void ExecutionPlan::_lowerNode(const size_t slot)
+{
+	const Node& node = *slots_[slot];
+
+	const auto getInputSlot = [this, &node](const NodePtr& input) {
+		if(const auto inputSlot = findSlot(input.get()))
+		{
+			return *inputSlot;
+		}
+
+		throw std::runtime_error(
+			fmt::format("Cannot compile the graph - input of node {} is not a part of the graph.", node.getIndex()));
+	};
+
+	const auto opCode = getOpCode(node);
+
+	if(!opCode)
+	{
+		return;
+	}
+
+	Instruction instruction{.opCode = *opCode, .inputs = {slot, slot}, .output = slot};
+
+	if(isBinary(*opCode))
+	{
+		const auto [lhs, rhs] = static_cast<const binaryOperators::BinaryOperator&>(node).getInputs();
+
+		instruction.inputs = {getInputSlot(lhs), getInputSlot(rhs)};
+	}
+	else
+	{
+		instruction.inputs[0] = getInputSlot(static_cast<const unaryOperators::UnaryOperator&>(node).getInput());
+	}
+
+	const size_t instructionIdx = instructions_.size();
+
+	for(const auto producer : _getInputProducers(instruction))
+	{
+		consumers_[producer].push_back(instructionIdx);
+	}
+
+	instructions_.push_back(instruction);
+	consumers_.emplace_back();
+	producers_[slot] = instructionIdx;
+}
+
+std::vector<size_t> ExecutionPlan::_getInputProducers(const Instruction& instruction) const
+{
+	std::vector<size_t> producers;
+
+	for(const auto input : _getInputSlots(instruction))
+	{
+		const size_t producer = producers_[input];
+
+		if(producer != NO_PRODUCER && std::find(producers.cbegin(), producers.cend(), producer) == producers.cend())
+		{
+			producers.push_back(producer);
+		}
+	}
+
+	return producers;
+}
+
+std::span<const size_t> ExecutionPlan::_getInputSlots(const Instruction& instruction) const
+{
+	if(instruction.opCode == OpCode::FUSED)
+	{
+		return fusedKernels_[instruction.inputs[0]].getInputs();
+	}
+
+	return {instruction.inputs.data(), isBinary(instruction.opCode) ? size_t(2) : size_t(1)};
+}
+
+void ExecutionPlan::_linkInstructions()
+{
+	std::fill(producers_.begin(), producers_.end(), NO_PRODUCER);
+	consumers_.assign(instructions_.size(), {});
+
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		const auto& instruction = instructions_[instructionIdx];
+
+		producers_[instruction.output] = instructionIdx;
+
+		// the fused operators are computed by the kernel as well, even though their values are never stored
+		if(instruction.opCode == OpCode::FUSED)
+		{
+			for(const auto& step : fusedKernels_[instruction.inputs[0]].getSteps())
+			{
+				producers_[*findSlot(step.node)] = instructionIdx;
+			}
+		}
+
+		for(const auto producer : _getInputProducers(instruction))
+		{
+			consumers_[producer].push_back(instructionIdx);
+		}
+	}
+}
+
+std::optional<size_t> ExecutionPlan::findSlot(const Node* const node) const
+{
+	if(const auto slot = slotIndices_.find(node); slot != slotIndices_.end())
+	{
+		return slot->second;
+	}
+
+	return std::nullopt;
+}
+
+void ExecutionPlan::runForward(const std::shared_ptr<utilities::ThreadPool>& interOpPool,
+							   const std::vector<allocators::AllocatorPtr>& valueAllocators) const
+{
+	_runForward(nullptr, interOpPool, nullptr, valueAllocators.empty() ? nullptr : &valueAllocators);
+	_copyToDuplicates();
+}
+
+void ExecutionPlan::runForward(const std::vector<bool>& isDirty,
+							   const std::shared_ptr<utilities::ThreadPool>& interOpPool) const
+{
+	_runForward(nullptr, interOpPool, &isDirty);
+	_copyToDuplicates();
+}
+
+void ExecutionPlan::_copyToDuplicates() const
+{
+	for(const auto& [duplicate, computed] : duplicates_)
+	{
+		slots_[duplicate]->getValue() = slots_[computed]->getValue();
+		slots_[duplicate]->resolve();
+	}
+}
+
+void ExecutionPlan::_releaseValue(ExecutionContext* const context, const size_t slot) const
+{
+	if(context)
+	{
+		context->values_[slot].reset();
+		return;
+	}
+
+	slots_[slot]->getValue() = Tensor();
+
+	// the duplicates share the storage of the value
+	for(const auto& [duplicate, computed] : duplicates_)
+	{
+		if(computed == slot)
+		{
+			slots_[duplicate]->getValue() = Tensor();
+		}
+	}
+}
+
+std::vector<bool> ExecutionPlan::markDirtyInstructions(const std::vector<bool>& isChanged) const
+{
+	std::vector<bool> isDirty(instructions_.size(), false);
+	std::vector<bool> isSlotDirty(isChanged);
+
+	// the instructions are sorted, so the changes reach all consumers in a single sweep
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		const auto& instruction = instructions_[instructionIdx];
+		const auto inputs = _getInputSlots(instruction);
+
+		isDirty[instructionIdx] =
+			isSlotDirty[instruction.output] ||
+			std::any_of(inputs.begin(), inputs.end(), [&isSlotDirty](const size_t input) { return isSlotDirty[input]; });
+
+		isSlotDirty[instruction.output] = isDirty[instructionIdx];
+	}
+
+	return isDirty;
+}
+
+void ExecutionPlan::runForward(ExecutionContext& context, const std::shared_ptr<utilities::ThreadPool>& interOpPool) const
+{
+	bindContext(context);
+
+	_runForward(&context, interOpPool);
+}
+
+void ExecutionPlan::bindContext(ExecutionContext& context) const
+{
+	if(context.plan_ != this)
+	{
+		context.values_.clear();
+		context.gradients_.clear();
+		context.plan_ = this;
+	}
+
+	context.values_.resize(slots_.size());
+	context.gradients_.resize(slots_.size());
+}
+
+const Tensor& ExecutionPlan::getValue(const ExecutionContext& context, const size_t slot) const
+{
+	if(const auto& value = context.values_[slot])
+	{
+		return *value;
+	}
+
+	if(producers_[slot] != NO_PRODUCER)
+	{
+		throw std::runtime_error(
+			fmt::format("Cannot get value of node {} which has not been computed or has been released in the context.",
+						slots_[slot]->getIndex()));
+	}
+
+	return slots_[slot]->getValue();
+}
+
+void ExecutionPlan::_runForward(ExecutionContext* const context,
+								const std::shared_ptr<utilities::ThreadPool>& interOpPool,
+								const std::vector<bool>* const isDirty,
+								const std::vector<allocators::AllocatorPtr>* const valueAllocators) const
+{
+	const auto isRun = [isDirty](const size_t instructionIdx) { return !isDirty || (*isDirty)[instructionIdx]; };
+
+	const auto livenessMode = context ? context->livenessMode_ : livenessMode_;
+
+	// the values are dropped by the last of their consumers, whichever it is
+	auto isReleased = livenessMode ? _markReleasedOutputs(*livenessMode) : std::vector<bool>(instructions_.size(), false);
+
+	if(context && (context->checkpointPolicy_ != CheckpointPolicy::NONE))
+	{
+		const auto isCheckpoint = _markCheckpoints(*context);
+
+		for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+		{
+			const bool isDropped = !consumers_[instructionIdx].empty() && !isCheckpoint[instructions_[instructionIdx].output];
+
+			isReleased[instructionIdx] = isReleased[instructionIdx] || isDropped;
+		}
+	}
+	std::vector<std::atomic<size_t>> nPendingReleases(instructions_.size());
+
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		nPendingReleases[instructionIdx] = consumers_[instructionIdx].size();
+	}
+
+	const auto releaseInputs = [this, context, &isReleased, &nPendingReleases](const Instruction& instruction) {
+		for(const auto producer : _getInputProducers(instruction))
+		{
+			if(isReleased[producer] && (--nPendingReleases[producer] == 0))
+			{
+				_releaseValue(context, instructions_[producer].output);
+			}
+		}
+	};
+
+	const bool isReleasing = std::find(isReleased.cbegin(), isReleased.cend(), true) != isReleased.cend();
+
+	const auto runInstruction = [this, context, isReleasing, valueAllocators, &releaseInputs](const Instruction& instruction) {
+		std::optional<AllocatorScope> valueAllocatorScope;
+
+		if(valueAllocators && (*valueAllocators)[instruction.output])
+		{
+			valueAllocatorScope.emplace((*valueAllocators)[instruction.output]);
+		}
+
+		if(!profiler_)
+		{
+			_computeForward(context, instruction);
+		}
+		else
+		{
+			const auto allocator = std::make_shared<TrackingAllocator>(getCurrentAllocator());
+			const auto start = profiler_->now();
+
+			{
+				const AllocatorScope allocatorScope(allocator);
+
+				_computeForward(context, instruction);
+			}
+
+			auto event = _makeEvent(ProfiledPass::FORWARD, instruction, start, allocator->getAllocatedBytes());
+
+			const auto valueOf = [this, context](const size_t slot) -> const Tensor& {
+				return context ? getValue(*context, slot) : slots_[slot]->getValue();
+			};
+
+			for(const auto input : _getInputSlots(instruction))
+			{
+				event.inputShapes.push_back(valueOf(input).shape());
+			}
+
+			event.outputShape = valueOf(instruction.output).shape();
+			profiler_->record(std::move(event));
+		}
+
+		if(isReleasing)
+		{
+			releaseInputs(instruction);
+		}
+	};
+
+	if(!interOpPool)
+	{
+		for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+		{
+			if(isRun(instructionIdx))
+			{
+				runInstruction(instructions_[instructionIdx]);
+			}
+		}
+
+		return;
+	}
+
+	// the consumers of the run instructions are run as well, so only the run producers are waited for
+	std::vector<size_t> nPendingProducers(instructions_.size());
+	std::vector<size_t> readyInstructions;
+	size_t nRunInstructions = 0;
+
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		if(!isRun(instructionIdx))
+		{
+			continue;
+		}
+
+		const auto producers = _getInputProducers(instructions_[instructionIdx]);
+
+		nPendingProducers[instructionIdx] = static_cast<size_t>(std::count_if(producers.cbegin(), producers.cend(), isRun));
+		nRunInstructions++;
+
+		if(nPendingProducers[instructionIdx] == 0)
+		{
+			readyInstructions.push_back(instructionIdx);
+		}
+	}
+
+	runDag(
+		interOpPool,
+		nRunInstructions,
+		std::move(readyInstructions),
+		[this, &runInstruction](const size_t instructionIdx) { runInstruction(instructions_[instructionIdx]); },
+		[this, &nPendingProducers](const size_t instructionIdx, std::vector<size_t>& readyInstructions) {
+			for(const auto consumer : consumers_[instructionIdx])
+			{
+				if(--nPendingProducers[consumer] == 0)
+				{
+					readyInstructions.push_back(consumer);
+				}
+			}
+		});
+}
+
+std::vector<std::optional<Tensor>> ExecutionPlan::runBackward(const size_t rootSlot,
+															  const std::vector<size_t>& wrtSlots,
+															  const std::shared_ptr<utilities::ThreadPool>& interOpPool) const
+{
+	return _runBackward(nullptr, rootSlot, wrtSlots, interOpPool);
+}
+
+void ExecutionPlan::runBackward(ExecutionContext& context,
+								const size_t rootSlot,
+								const std::vector<size_t>& wrtSlots,
+								const std::shared_ptr<utilities::ThreadPool>& interOpPool) const
+{
+	bindContext(context);
+
+	auto gradients = _runBackward(&context, rootSlot, wrtSlots, interOpPool);
+
+	for(size_t slot = 0; slot < gradients.size(); slot++)
+	{
+		if(!gradients[slot])
+		{
+			continue;
+		}
+
+		if(auto& accumulated = context.gradients_[slot])
+		{
+			accumulateGradient(*accumulated, *gradients[slot]);
+		}
+		else
+		{
+			accumulated = std::move(gradients[slot]);
+		}
+	}
+}
+
+std::vector<std::optional<Tensor>> ExecutionPlan::_runBackward(ExecutionContext* const context,
+															   const size_t rootSlot,
+															   const std::vector<size_t>& wrtSlots,
+															   const std::shared_ptr<utilities::ThreadPool>& interOpPool) const
+{
+	std::vector<std::optional<Tensor>> gradients(slots_.size());
+
+	const auto isRequired = _markRequiredGradients(wrtSlots);
+
+	if(!isRequired[rootSlot])
+	{
+		return gradients;
+	}
+
+	const auto valueOf = [this, context](const size_t slot) -> const Tensor& {
+		return context ? getValue(*context, slot) : slots_[slot]->getValue();
+	};
+
+	// the values not read by the derivatives may have been released from the context
+	const Tensor unreadValue;
+
+	const auto inputValueOf = [&valueOf, &unreadValue](const Instruction& instruction, const size_t slot) -> const Tensor& {
+		return readsInputsBackward(instruction.opCode) ? valueOf(slot) : unreadValue;
+	};
+
+	const auto outputValueOf = [&valueOf, &unreadValue](const Instruction& instruction) -> const Tensor& {
+		return readsOutputBackward(instruction.opCode) ? valueOf(instruction.output) : unreadValue;
+	};
+
+	// the values recomputed from the checkpoints, dropped once they are no longer read
+	std::vector<size_t> rematerialized;
+
+	if(context && (context->checkpointPolicy_ != CheckpointPolicy::NONE))
+	{
+		_rematerialize(*context, rootSlot, rematerialized);
+	}
+
+	gradients[rootSlot].emplace(valueOf(rootSlot).shape(), 1.0);
+
+	// the first gradient of the slot is moved in and the next ones are added to it
+	const auto accumulate = [&gradients](const size_t slot, std::optional<Tensor>&& gradient) {
+		if(!gradient)
+		{
+			return;
+		}
+
+		if(auto& slotGradient = gradients[slot])
+		{
+			accumulateGradient(*slotGradient, *gradient);
+		}
+		else
+		{
+			slotGradient = std::move(gradient);
+		}
+	};
+
+	// propagates the output's gradient to the required inputs, passing the derivatives to the accumulating function
+	const auto propagateInstruction = [&](const Instruction& instruction, const auto& accumulateInput) {
+		const auto& outerDerivative = gradients[instruction.output];
+
+		if(!outerDerivative)
+		{
+			return;
+		}
+
+		if(instruction.opCode == OpCode::FUSED)
+		{
+			const auto inputs = _getInputSlots(instruction);
+			std::vector<const Tensor*> inputValues(inputs.size());
+			std::vector<bool> isInputRequired(inputs.size());
+
+			for(size_t inputIdx = 0; inputIdx < inputs.size(); inputIdx++)
+			{
+				inputValues[inputIdx] = &valueOf(inputs[inputIdx]);
+				isInputRequired[inputIdx] = isRequired[inputs[inputIdx]];
+			}
+
+			auto derivatives = fusedKernels_[instruction.inputs[0]].computeInputDerivatives(
+				*outerDerivative, inputValues, isInputRequired);
+
+			for(size_t inputIdx = 0; inputIdx < inputs.size(); inputIdx++)
+			{
+				accumulateInput(inputs[inputIdx], std::move(derivatives[inputIdx]));
+			}
+
+			return;
+		}
+
+		const auto& inputs = instruction.inputs;
+
+		// the built-in operators read the values of the slots, like in forward pass, while the custom ones may rely on
+		// their own state
+		const bool isExternal = context || isBuiltIn(instruction.opCode);
+
+		visitOperator(instruction.opCode, slots_[instruction.output], [&](const auto* const oper) {
+			using Operator = std::remove_cvref_t<decltype(*oper)>;
+
+			if constexpr(std::is_base_of_v<binaryOperators::BinaryOperator, Operator>)
+			{
+				const bool isLhsRequired = isRequired[inputs[0]];
+				const bool isRhsRequired = isRequired[inputs[1]];
+
+				auto [lhsDerivative, rhsDerivative] =
+					isExternal ? oper->computeInputDerivatives(*outerDerivative,
+															   inputValueOf(instruction, inputs[0]),
+															   inputValueOf(instruction, inputs[1]),
+															   outputValueOf(instruction),
+															   isLhsRequired,
+															   isRhsRequired)
+							   : oper->computeRequiredDerivatives(*outerDerivative, isLhsRequired, isRhsRequired);
+
+				accumulateInput(inputs[0], std::move(lhsDerivative));
+				accumulateInput(inputs[1], std::move(rhsDerivative));
+			}
+			else if(isRequired[inputs[0]])
+			{
+				accumulateInput(inputs[0],
+								isExternal ? oper->computeInputDerivative(*outerDerivative,
+																	      inputValueOf(instruction, inputs[0]),
+																	      outputValueOf(instruction))
+										   : oper->computeDerivative(*outerDerivative));
+			}
+		});
+	};
+
+	const auto propagate = [&](const Instruction& instruction, const auto& accumulateInput) {
+		if(!profiler_)
+		{
+			propagateInstruction(instruction, accumulateInput);
+			return;
+		}
+
+		if(!gradients[instruction.output])
+		{
+			return;
+		}
+
+		const auto outputShape = gradients[instruction.output]->shape();
+		const auto allocator = std::make_shared<TrackingAllocator>(getCurrentAllocator());
+		const auto start = profiler_->now();
+		std::vector<std::vector<size_t>> derivativeShapes;
+
+		{
+			const AllocatorScope allocatorScope(allocator);
+
+			propagateInstruction(
+				instruction, [&derivativeShapes, &accumulateInput](const size_t slot, std::optional<Tensor>&& derivative) {
+					if(derivative)
+					{
+						derivativeShapes.push_back(derivative->shape());
+					}
+
+					accumulateInput(slot, std::move(derivative));
+				});
+		}
+
+		auto event = _makeEvent(ProfiledPass::BACKWARD, instruction, start, allocator->getAllocatedBytes());
+
+		event.inputShapes = std::move(derivativeShapes);
+		event.outputShape = outputShape;
+		profiler_->record(std::move(event));
+	};
+
+	// only the instructions the root's gradient reaches are run
+	std::vector<bool> isReached(slots_.size(), false);
+	std::vector<bool> isActive(instructions_.size(), false);
+	isReached[rootSlot] = true;
+
+	for(size_t instructionIdx = instructions_.size(); instructionIdx-- > 0;)
+	{
+		const auto& instruction = instructions_[instructionIdx];
+
+		if(!isReached[instruction.output])
+		{
+			continue;
+		}
+
+		isActive[instructionIdx] = true;
+
+		for(const auto input : _getInputSlots(instruction))
+		{
+			isReached[input] = isReached[input] || isRequired[input];
+		}
+	}
+
+	// calls the callback with the instructions whose values are read by the instruction's derivatives
+	const auto forEachReadProducer = [this](const size_t instructionIdx, const auto& callback) {
+		const auto& instruction = instructions_[instructionIdx];
+
+		if(readsInputsBackward(instruction.opCode))
+		{
+			for(const auto producer : _getInputProducers(instruction))
+			{
+				callback(producer);
+			}
+		}
+
+		if(readsOutputBackward(instruction.opCode))
+		{
+			callback(instructionIdx);
+		}
+	};
+
+	// with a liveness mode the values are dropped after their last reader and the gradients of the operators once they
+	// have been propagated, unless they have been requested or are the graph's outputs
+	const auto livenessMode = context ? context->livenessMode_ : livenessMode_;
+	std::vector<std::atomic<size_t>> nPendingReaders(livenessMode ? instructions_.size() : 0);
+	std::vector<bool> isRequested(slots_.size(), false);
+
+	if(livenessMode)
+	{
+		for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+		{
+			if(isActive[instructionIdx])
+			{
+				forEachReadProducer(instructionIdx, [&nPendingReaders](const size_t producer) { nPendingReaders[producer]++; });
+			}
+		}
+
+		for(const auto slot : wrtSlots)
+		{
+			isRequested[slot] = true;
+		}
+	}
+
+	const auto runInstruction = [&](const size_t instructionIdx, const auto& accumulateInput) {
+		propagate(instructions_[instructionIdx], accumulateInput);
+
+		if(!livenessMode)
+		{
+			return;
+		}
+
+		if(const size_t output = instructions_[instructionIdx].output; !isRequested[output])
+		{
+			gradients[output].reset();
+		}
+
+		forEachReadProducer(instructionIdx, [this, context, &nPendingReaders](const size_t producer) {
+			if(!consumers_[producer].empty() && (--nPendingReaders[producer] == 0))
+			{
+				_releaseValue(context, instructions_[producer].output);
+			}
+		});
+	};
+
+	if(context && (context->checkpointPolicy_ != CheckpointPolicy::NONE))
+	{
+		if(interOpPool)
+		{
+			// reported once, since the passes are usually run in a loop
+			static std::once_flag warningFlag;
+
+			std::call_once(warningFlag, []() {
+				LOG_WARN("ExecutionPlan",
+						 "The backward pass with checkpointing ignores the inter-op thread pool and runs the operators one "
+						 "after another.");
+			});
+		}
+
+		const auto isCheckpoint = _markCheckpoints(*context);
+
+		// drops the recomputed values computed after the instruction, which are not read by the remaining ones
+		const auto dropRematerialized = [this, context, &rematerialized](const size_t instructionIdx) {
+			const auto isDropped = [this, instructionIdx](const size_t slot) { return producers_[slot] > instructionIdx; };
+			const auto dropped = std::stable_partition(rematerialized.begin(), rematerialized.end(), std::not_fn(isDropped));
+
+			for(auto slot = dropped; slot != rematerialized.end(); slot++)
+			{
+				context->values_[*slot].reset();
+			}
+
+			rematerialized.erase(dropped, rematerialized.end());
+		};
+
+		for(size_t instructionIdx = instructions_.size(); instructionIdx-- > 0;)
+		{
+			const auto& instruction = instructions_[instructionIdx];
+
+			// the segment following the checkpoint has been differentiated
+			if(isCheckpoint[instruction.output])
+			{
+				dropRematerialized(instructionIdx);
+			}
+
+			if(!gradients[instruction.output])
+			{
+				continue;
+			}
+
+			if(readsInputsBackward(instruction.opCode))
+			{
+				for(const auto input : _getInputSlots(instruction))
+				{
+					_rematerialize(*context, input, rematerialized);
+				}
+			}
+
+			if(readsOutputBackward(instruction.opCode))
+			{
+				_rematerialize(*context, instruction.output, rematerialized);
+			}
+
+			runInstruction(instructionIdx, accumulate);
+		}
+
+		for(const auto slot : rematerialized)
+		{
+			context->values_[slot].reset();
+		}
+
+		return gradients;
+	}
+
+	if(!interOpPool)
+	{
+		for(size_t instructionIdx = instructions_.size(); instructionIdx-- > 0;)
+		{
+			if(isActive[instructionIdx])
+			{
+				runInstruction(instructionIdx, accumulate);
+			}
+		}
+
+		return gradients;
+	}
+
+	// each active instruction is scheduled after all of its active consumers
+	std::vector<size_t> activeInstructions;
+	std::vector<size_t> nPendingConsumers(instructions_.size(), 0);
+	std::vector<size_t> readyInstructions;
+
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		if(!isActive[instructionIdx])
+		{
+			continue;
+		}
+
+		activeInstructions.push_back(instructionIdx);
+
+		const auto& consumers = consumers_[instructionIdx];
+		const auto isConsumerActive = [&isActive](const size_t consumer) { return isActive[consumer]; };
+
+		nPendingConsumers[instructionIdx] =
+			static_cast<size_t>(std::count_if(consumers.cbegin(), consumers.cend(), isConsumerActive));
+
+		if(nPendingConsumers[instructionIdx] == 0)
+		{
+			readyInstructions.push_back(instructionIdx);
+		}
+	}
+
+	// the inputs shared by concurrently run instructions are accumulated one at a time
+	std::vector<std::mutex> slotMutexes(slots_.size());
+
+	const auto accumulateLocked = [&accumulate, &slotMutexes](const size_t slot, std::optional<Tensor>&& gradient) {
+		const std::lock_guard<std::mutex> lock(slotMutexes[slot]);
+
+		accumulate(slot, std::move(gradient));
+	};
+
+	runDag(
+		interOpPool,
+		activeInstructions.size(),
+		std::move(readyInstructions),
+		[&runInstruction, &accumulateLocked](const size_t instructionIdx) { runInstruction(instructionIdx, accumulateLocked); },
+		[this, &isActive, &nPendingConsumers](const size_t instructionIdx, std::vector<size_t>& readyInstructions) {
+			for(const auto producer : _getInputProducers(instructions_[instructionIdx]))
+			{
+				if(isActive[producer] && --nPendingConsumers[producer] == 0)
+				{
+					readyInstructions.push_back(producer);
+				}
+			}
+		});
+
+	return gradients;
+}
+
+std::vector<std::vector<size_t>>
+ExecutionPlan::inferShapes(const std::unordered_map<size_t, std::vector<size_t>>& leafShapes) const
+{
+	std::vector<std::vector<size_t>> shapes(slots_.size());
+
+	for(size_t slot = 0; slot < slots_.size(); slot++)
+	{
+		if(producers_[slot] != NO_PRODUCER)
+		{
+			continue;
+		}
+
+		const auto leafShape = leafShapes.find(slot);
+		shapes[slot] = (leafShape != leafShapes.end()) ? leafShape->second : slots_[slot]->getValue().shape();
+	}
+
+	for(const auto& instruction : instructions_)
+	{
+		if(instruction.opCode == OpCode::FUSED)
+		{
+			shapes[instruction.output] = inferFusedShape(fusedKernels_[instruction.inputs[0]], shapes);
+			continue;
+		}
+
+		auto& shape = shapes[instruction.output];
+
+		if(instruction.opCode == OpCode::CUSTOM_BINARY || instruction.opCode == OpCode::CUSTOM_UNARY)
+		{
+			shape = slots_[instruction.output]->getValue().shape();
+		}
+		else
+		{
+			shape = inferShape(instruction.opCode, shapes[instruction.inputs[0]], shapes[instruction.inputs[1]]);
+		}
+	}
+
+	return shapes;
+}
+
+MemoryEstimate ExecutionPlan::estimateMemory(const std::vector<std::vector<size_t>>& shapes, const LivenessMode mode) const
+{
+	const size_t nInstructions = instructions_.size();
+	const bool isTraining = (mode == LivenessMode::TRAINING);
+
+	// the forward pass takes the first steps and the backward pass, visiting the instructions in reverse, the next ones
+	const size_t nSteps = isTraining ? 2 * nInstructions : nInstructions;
+	const auto getBackwardStep = [nInstructions](const size_t instructionIdx) {
+		return 2 * nInstructions - 1 - instructionIdx;
+	};
+
+	std::vector<std::vector<size_t>> releasedInstructions(nSteps);
+	std::vector<size_t> valuesBytes(nInstructions);
+
+	for(size_t instructionIdx = 0; instructionIdx < nInstructions; instructionIdx++)
+	{
+		const auto& consumers = consumers_[instructionIdx];
+
+		// the outputs of the graph are kept until the end of the run
+		size_t lastUse = consumers.empty() ? nSteps - 1 : 0;
+
+		for(const auto consumer : consumers)
+		{
+			lastUse = std::max(lastUse, consumer);
+
+			if(isTraining && readsInputsBackward(instructions_[consumer].opCode))
+			{
+				lastUse = std::max(lastUse, getBackwardStep(consumer));
+			}
+		}
+
+		if(isTraining && readsOutputBackward(instructions_[instructionIdx].opCode))
+		{
+			lastUse = std::max(lastUse, getBackwardStep(instructionIdx));
+		}
+
+		releasedInstructions[lastUse].push_back(instructionIdx);
+
+		const auto& shape = shapes[instructions_[instructionIdx].output];
+		valuesBytes[instructionIdx] =
+			std::accumulate(shape.cbegin(), shape.cend(), sizeof(Tensor::ElementType), std::multiplies<size_t>());
+	}
+
+	MemoryEstimate memoryEstimate;
+	memoryEstimate.bufferIndices.assign(slots_.size(), MemoryEstimate::NO_BUFFER);
+
+	std::vector<size_t> freeBuffers;
+	size_t liveBytes = 0;
+
+	// picks the smallest free buffer fitting the value, otherwise grows the biggest one or adds a new one
+	const auto takeBuffer = [&memoryEstimate, &freeBuffers](const size_t nBytes) {
+		auto& bufferBytes = memoryEstimate.bufferBytes;
+
+		if(freeBuffers.empty())
+		{
+			bufferBytes.push_back(nBytes);
+			return bufferBytes.size() - 1;
+		}
+
+		const auto isBetter = [&bufferBytes, nBytes](const size_t buffer, const size_t other) {
+			const bool fits = bufferBytes[buffer] >= nBytes;
+			const bool otherFits = bufferBytes[other] >= nBytes;
+
+			if(fits != otherFits)
+			{
+				return fits;
+			}
+
+			return fits ? (bufferBytes[buffer] < bufferBytes[other]) : (bufferBytes[buffer] > bufferBytes[other]);
+		};
+
+		const auto chosen = std::min_element(freeBuffers.begin(), freeBuffers.end(), isBetter);
+		const size_t buffer = *chosen;
+
+		freeBuffers.erase(chosen);
+		bufferBytes[buffer] = std::max(bufferBytes[buffer], nBytes);
+
+		return buffer;
+	};
+
+	for(size_t step = 0; step < nSteps; step++)
+	{
+		if(step < nInstructions)
+		{
+			const size_t nBytes = valuesBytes[step];
+
+			memoryEstimate.bufferIndices[instructions_[step].output] = takeBuffer(nBytes);
+			memoryEstimate.totalBytes += nBytes;
+			liveBytes += nBytes;
+			memoryEstimate.peakBytes = std::max(memoryEstimate.peakBytes, liveBytes);
+		}
+
+		// the buffers are freed after the step, so that no instruction writes to the buffer of its input
+		for(const auto instructionIdx : releasedInstructions[step])
+		{
+			liveBytes -= valuesBytes[instructionIdx];
+			freeBuffers.push_back(memoryEstimate.bufferIndices[instructions_[instructionIdx].output]);
+		}
+	}
+
+	return memoryEstimate;
+}
+
+void ExecutionPlan::_computeForward(ExecutionContext* const context, const Instruction& instruction) const
+{
+	if(context)
+	{
+		_computeInContext(*context, instruction);
+	}
+	else if(instruction.opCode == OpCode::FUSED)
+	{
+		const auto inputs = _getInputSlots(instruction);
+		std::vector<const Tensor*> inputValues(inputs.size());
+
+		std::transform(inputs.begin(), inputs.end(), inputValues.begin(), [this](const size_t input) {
+			return &slots_[input]->getValue();
+		});
+
+		slots_[instruction.output]->getValue() = fusedKernels_[instruction.inputs[0]].computeValue(inputValues);
+		slots_[instruction.output]->resolve();
+	}
+	else if(isBuiltIn(instruction.opCode))
+	{
+		Node* const node = slots_[instruction.output];
+
+		// the inputs are read from the slots, since eliminateCommonSubexpressions may have replaced the operator's inputs
+		visitOperator(instruction.opCode, node, [this, node, &instruction](const auto* const oper) {
+			using Operator = std::remove_cvref_t<decltype(*oper)>;
+
+			if constexpr(std::is_base_of_v<binaryOperators::BinaryOperator, Operator>)
+			{
+				node->getValue() = oper->computeValue(slots_[instruction.inputs[0]]->getValue(),
+													  slots_[instruction.inputs[1]]->getValue());
+			}
+			else
+			{
+				node->getValue() = oper->computeValue(slots_[instruction.inputs[0]]->getValue());
+			}
+		});
+
+		node->resolve();
+	}
+	else
+	{
+		visitOperator(instruction.opCode, slots_[instruction.output], [](auto* const oper) { oper->updateValue(); });
+		slots_[instruction.output]->resolve();
+	}
+}
+
+ProfileEvent ExecutionPlan::_makeEvent(const ProfiledPass pass,
+									   const Instruction& instruction,
+									   const std::chrono::nanoseconds start,
+									   const size_t allocatedBytes) const
+{
+	const Node& node = *slots_[instruction.output];
+
+	ProfileEvent event;
+	event.pass = pass;
+	event.nodeId = node.getIndex();
+	event.nodeName = node.getName();
+	event.opName = getOpCodeName(instruction.opCode);
+	event.start = start;
+	event.duration = profiler_->now() - start;
+	event.allocatedBytes = allocatedBytes;
+
+	return event;
+}
+
+void ExecutionPlan::_computeInContext(ExecutionContext& context, const Instruction& instruction) const
+{
+	if(instruction.opCode == OpCode::FUSED)
+	{
+		const auto inputs = _getInputSlots(instruction);
+		std::vector<const Tensor*> inputValues(inputs.size());
+
+		std::transform(inputs.begin(), inputs.end(), inputValues.begin(), [this, &context](const size_t input) {
+			return &getValue(context, input);
+		});
+
+		context.values_[instruction.output] = fusedKernels_[instruction.inputs[0]].computeValue(inputValues);
+		return;
+	}
+
+	visitOperator(instruction.opCode, slots_[instruction.output], [this, &context, &instruction](const auto* const oper) {
+		using Operator = std::remove_cvref_t<decltype(*oper)>;
+
+		if constexpr(std::is_base_of_v<binaryOperators::BinaryOperator, Operator>)
+		{
+			context.values_[instruction.output] =
+				oper->computeValue(getValue(context, instruction.inputs[0]), getValue(context, instruction.inputs[1]));
+		}
+		else
+		{
+			context.values_[instruction.output] = oper->computeValue(getValue(context, instruction.inputs[0]));
+		}
+	});
+}
+
+std::vector<bool> ExecutionPlan::_markCheckpoints(const ExecutionContext& context) const
+{
+	std::vector<bool> isCheckpoint(slots_.size(), false);
+
+	if(context.checkpointPolicy_ == CheckpointPolicy::SQRT_N)
+	{
+		const auto interval = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(instructions_.size()))));
+
+		for(size_t instructionIdx = interval - 1; instructionIdx < instructions_.size(); instructionIdx += interval)
+		{
+			isCheckpoint[instructions_[instructionIdx].output] = true;
+		}
+	}
+	else if(context.checkpointPolicy_ == CheckpointPolicy::MANUAL)
+	{
+		for(const auto& checkpoint : context.checkpoints_)
+		{
+			const auto slot = findSlot(checkpoint.get());
+
+			if(!slot)
+			{
+				throw std::runtime_error(
+					fmt::format("Cannot use node {} outside of the graph as a checkpoint.", checkpoint->getIndex()));
+			}
+
+			isCheckpoint[*slot] = true;
+		}
+	}
+
+	return isCheckpoint;
+}
+
+void ExecutionPlan::_rematerialize(ExecutionContext& context, const size_t slot, std::vector<size_t>& rematerialized) const
+{
+	const auto isAvailable = [this, &context](const size_t inputSlot) {
+		return context.values_[inputSlot] || (producers_[inputSlot] == NO_PRODUCER);
+	};
+
+	// the dropped inputs are recomputed first, without recursion, since the segments may be long
+	std::vector<size_t> pendingSlots{slot};
+
+	while(!pendingSlots.empty())
+	{
+		const size_t pendingSlot = pendingSlots.back();
+
+		if(isAvailable(pendingSlot))
+		{
+			pendingSlots.pop_back();
+			continue;
+		}
+
+		const auto& instruction = instructions_[producers_[pendingSlot]];
+		bool areInputsAvailable = true;
+
+		for(const auto input : _getInputSlots(instruction))
+		{
+			if(!isAvailable(input))
+			{
+				pendingSlots.push_back(input);
+				areInputsAvailable = false;
+			}
+		}
+
+		if(areInputsAvailable)
+		{
+			_computeInContext(context, instruction);
+			rematerialized.push_back(pendingSlot);
+			pendingSlots.pop_back();
+		}
+	}
+}
+
+std::vector<bool> ExecutionPlan::_markReleasedOutputs(const LivenessMode mode) const
+{
+	std::vector<bool> isReleased(instructions_.size());
+
+	for(size_t instructionIdx = 0; instructionIdx < instructions_.size(); instructionIdx++)
+	{
+		const auto& consumers = consumers_[instructionIdx];
+
+		bool isReadBackward = readsOutputBackward(instructions_[instructionIdx].opCode);
+
+		for(const auto consumer : consumers)
+		{
+			isReadBackward = isReadBackward || readsInputsBackward(instructions_[consumer].opCode);
+		}
+
+		isReleased[instructionIdx] = !consumers.empty() && ((mode == LivenessMode::INFERENCE) || !isReadBackward);
+	}
+
+	return isReleased;
+}
+
+std::vector<bool> ExecutionPlan::_markRequiredGradients(const std::vector<size_t>& wrtSlots) const
+{
+	std::vector<bool> isRequired(slots_.size(), false);
+
+	const auto isAnyInputRequired = [this, &isRequired](const Instruction& instruction) {
+		const auto inputs = _getInputSlots(instruction);
+
+		return std::any_of(inputs.begin(), inputs.end(), [&isRequired](const size_t input) { return isRequired[input]; });
+	};
+
+	if(wrtSlots.empty())
+	{
+		for(size_t slot = 0; slot < slots_.size(); slot++)
+		{
+			isRequired[slot] = slots_[slot]->requiresGrad() && !isFolded_[slot];
+		}
+
+		for(const auto& instruction : instructions_)
+		{
+			isRequired[instruction.output] = isRequired[instruction.output] && isAnyInputRequired(instruction);
+		}
+
+		return isRequired;
+	}
+
+	for(const auto slot : wrtSlots)
+	{
+		isRequired[slot] = true;
+	}
+
+	// the operators with requiresGrad unset stop the backward pass regardless of the requested nodes
+	for(const auto& instruction : instructions_)
+	{
+		isRequired[instruction.output] = isRequired[instruction.output] ||
+										 (slots_[instruction.output]->requiresGrad() && isAnyInputRequired(instruction));
+	}
+
+	return isRequired;
+}
+} // namespace mlCore::autoDiff
@@ -1,5 +1,7 @@
 #include <AutoDiff/GraphOperations.h>
 
+#include <functional>
+
 #include <AutoDiff/BinaryOperators/AddOperator.h>
 #include <AutoDiff/BinaryOperators/DivideOperator.h>
 #include <AutoDiff/BinaryOperators/MatmulOperator.h>
@@ -11,8 +13,68 @@
 #include <AutoDiff/UnaryOperators/ReluOperator.h>
 #include <AutoDiff/UnaryOperators/SigmoidOperator.h>
 
+#include <AutoDiff/ExecutionPlan.h>
+
 namespace mlCore::autoDiff
 {
+namespace
+{
+thread_local ConstructionMode currentConstructionMode = ConstructionMode::EAGER;
+
+/// Gets the shape the node's value has or will have, or std::nullopt if it is not known before the forward pass.
+std::optional<std::vector<size_t>> getStaticShape(Node& node)
+{
+	if(node.isDeferred())
+	{
+		return node.getDeferredShape();
+	}
+
+	if(dynamic_cast<const Placeholder*>(&node) && node.getValue().shape().empty())
+	{
+		return std::nullopt;
+	}
+
+	return node.getValue().shape();
+}
+
+/// Computes the value of the created operator or, in the lazy mode, only infers its shape. The operators built on the
+/// deferred inputs are deferred as well.
+void buildValue(Node& result, Node& lhsInput, Node& rhsInput, const std::function<void()>& updateValue)
+{
+	if(currentConstructionMode == ConstructionMode::EAGER && !lhsInput.isDeferred() && !rhsInput.isDeferred())
+	{
+		updateValue();
+		return;
+	}
+
+	const auto lhsShape = getStaticShape(lhsInput);
+	const auto rhsShape = getStaticShape(rhsInput);
+
+	if(!lhsShape || !rhsShape)
+	{
+		result.defer(std::nullopt);
+		return;
+	}
+
+	result.defer(inferShape(*getOpCode(result), *lhsShape, *rhsShape));
+}
+} // namespace
+
+ConstructionMode getCurrentConstructionMode() noexcept
+{
+	return currentConstructionMode;
+}
+
+ConstructionModeScope::ConstructionModeScope(const ConstructionMode mode) noexcept
+	: previousMode_(currentConstructionMode)
+{
+	currentConstructionMode = mode;
+}
+
+ConstructionModeScope::~ConstructionModeScope()
+{
+	currentConstructionMode = previousMode_;
+}
 
 /****************
  * 
@@ -21,13 +83,13 @@ namespace mlCore::autoDiff
  ****************/
 namespace
 {
-/// Creates an binary operator node of the provided type and updates its value.
+/// Creates an binary operator node of the provided type and updates its value, see ConstructionMode.
 template <typename BinaryOperator>
 NodePtr binaryOperationImpl(const NodePtr& lNode, const NodePtr& rNode)
 {
 	auto result = std::make_shared<BinaryOperator>(lNode, rNode);
 
-	result->updateValue();
+	buildValue(*result, *lNode, *rNode, [&result]() { result->updateValue(); });
 
 	return result;
 }
@@ -67,13 +129,13 @@ NodePtr matmul(const NodePtr lNode, const NodePtr rNode)
 
 namespace
 {
-/// Creates an unary operator node of the provided type and updates its value.
+/// Creates an unary operator node of the provided type and updates its value, see ConstructionMode.
 template <typename UnaryOperator>
 NodePtr unaryOperationImpl(const NodePtr& node)
 {
 	auto result = std::make_shared<UnaryOperator>(node);
 
-	result->updateValue();
+	buildValue(*result, *node, *node, [&result]() { result->updateValue(); });
 
 	return result;
 }
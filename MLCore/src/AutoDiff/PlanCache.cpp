@@ -0,0 +1,118 @@
+#include <AutoDiff/PlanCache.h>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include <AutoDiff/HashCombine.h>
+#include <MLCore/Allocators/BufferAllocator.h>
+
+namespace mlCore::autoDiff
+{
+PlanCache::PlanCache(PlanCacheOptions options)
+	: options_()
+{
+	setOptions(std::move(options));
+}
+
+void PlanCache::setOptions(PlanCacheOptions options)
+{
+	options_ = std::move(options);
+	std::sort(options_.batchBuckets.begin(), options_.batchBuckets.end());
+
+	clear();
+}
+
+std::vector<size_t> PlanCache::padShape(std::vector<size_t> shape) const
+{
+	if(shape.empty())
+	{
+		return shape;
+	}
+
+	const auto& buckets = options_.batchBuckets;
+
+	if(const auto bucket = std::lower_bound(buckets.cbegin(), buckets.cend(), shape[0]); bucket != buckets.cend())
+	{
+		shape[0] = *bucket;
+	}
+
+	return shape;
+}
+
+const ShapedPlan& PlanCache::getPlan(const ExecutionPlan& plan,
+									 const LivenessMode mode,
+									 const std::map<size_t, std::vector<size_t>>& placeholderShapes,
+									 const allocators::AllocatorPtr& allocator)
+{
+	Key key{.mode = mode, .placeholderShapes = {placeholderShapes.cbegin(), placeholderShapes.cend()}};
+
+	if(const auto cached = lookup_.find(key); cached != lookup_.end())
+	{
+		nHits_++;
+		entries_.splice(entries_.begin(), entries_, cached->second);
+
+		return cached->second->second;
+	}
+
+	nMisses_++;
+
+	ShapedPlan shapedPlan;
+	shapedPlan.shapes =
+		plan.inferShapes(std::unordered_map<size_t, std::vector<size_t>>(placeholderShapes.cbegin(), placeholderShapes.cend()));
+	shapedPlan.memoryEstimate = plan.estimateMemory(shapedPlan.shapes, mode);
+
+	std::vector<allocators::AllocatorPtr> buffers;
+
+	for(const auto bufferBytes : shapedPlan.memoryEstimate.bufferBytes)
+	{
+		buffers.push_back(std::make_shared<allocators::BufferAllocator>(bufferBytes, allocator));
+	}
+
+	const auto& bufferIndices = shapedPlan.memoryEstimate.bufferIndices;
+	shapedPlan.valueAllocators.resize(bufferIndices.size());
+
+	for(size_t slot = 0; slot < bufferIndices.size(); slot++)
+	{
+		if(bufferIndices[slot] != MemoryEstimate::NO_BUFFER)
+		{
+			shapedPlan.valueAllocators[slot] = buffers[bufferIndices[slot]];
+		}
+	}
+
+	if(entries_.size() >= std::max(options_.capacity, size_t(1)))
+	{
+		lookup_.erase(entries_.back().first);
+		entries_.pop_back();
+	}
+
+	entries_.emplace_front(std::move(key), std::move(shapedPlan));
+	lookup_.emplace(entries_.front().first, entries_.begin());
+
+	return entries_.front().second;
+}
+
+void PlanCache::clear() noexcept
+{
+	lookup_.clear();
+	entries_.clear();
+}
+
+size_t PlanCache::KeyHash::operator()(const Key& key) const noexcept
+{
+	size_t hash = std::hash<size_t>{}(static_cast<size_t>(key.mode));
+
+	for(const auto& [slot, shape] : key.placeholderShapes)
+	{
+		combineHash(hash, slot);
+		combineHash(hash, shape.size());
+
+		for(const auto dim : shape)
+		{
+			combineHash(hash, dim);
+		}
+	}
+
+	return hash;
+}
+} // namespace mlCore::autoDiff
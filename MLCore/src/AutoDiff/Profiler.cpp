@@ -0,0 +1,212 @@
+#include <AutoDiff/Profiler.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <MLCore/Utilities.h>
+
+namespace mlCore::autoDiff
+{
+namespace
+{
+const char* getPassName(const ProfiledPass pass) noexcept
+{
+	return (pass == ProfiledPass::FORWARD) ? "forward" : "backward";
+}
+
+/// Escapes the characters which cannot be put in a JSON string as they are.
+std::string escapeJson(const std::string& text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+
+	for(const char character : text)
+	{
+		switch(character)
+		{
+		case '"':
+			escaped += "\\\"";
+			break;
+		case '\\':
+			escaped += "\\\\";
+			break;
+		case '\n':
+			escaped += "\\n";
+			break;
+		case '\t':
+			escaped += "\\t";
+			break;
+		default:
+			if(static_cast<unsigned char>(character) < 0x20)
+			{
+				escaped += fmt::format("\\u{:04x}", static_cast<int>(character));
+			}
+			else
+			{
+				escaped += character;
+			}
+		}
+	}
+
+	return escaped;
+}
+
+/// Gets the name the event's node is exported under.
+std::string getDisplayName(const ProfileEvent& event)
+{
+	return event.nodeName.empty() ? fmt::format("{}#{}", event.opName, event.nodeId) : event.nodeName;
+}
+
+/// Statistics of the events grouped under one key of the summary.
+struct AggregatedEvents
+{
+	size_t nCalls = 0;
+	std::chrono::nanoseconds totalDuration = {};
+	size_t allocatedBytes = 0;
+};
+
+/// Writes the table of the groups sorted by their total time, longest first.
+void writeTable(std::ostream& stream,
+				const std::string& title,
+				const std::map<std::pair<std::string, ProfiledPass>, AggregatedEvents>& groups)
+{
+	std::vector<std::pair<std::pair<std::string, ProfiledPass>, AggregatedEvents>> rows(groups.cbegin(), groups.cend());
+
+	std::stable_sort(rows.begin(), rows.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second.totalDuration > rhs.second.totalDuration;
+	});
+
+	stream << fmt::format(
+		"{:<32} {:<9} {:>8} {:>14} {:>14} {:>16}\n", title, "Pass", "Calls", "Total [ms]", "Mean [us]", "Allocated [B]");
+
+	for(const auto& [key, aggregated] : rows)
+	{
+		const double totalMicroseconds = static_cast<double>(aggregated.totalDuration.count()) / 1e3;
+
+		stream << fmt::format("{:<32} {:<9} {:>8} {:>14.3f} {:>14.3f} {:>16}\n",
+							  key.first,
+							  getPassName(key.second),
+							  aggregated.nCalls,
+							  totalMicroseconds / 1e3,
+							  totalMicroseconds / static_cast<double>(aggregated.nCalls),
+							  aggregated.allocatedBytes);
+	}
+}
+} // namespace
+
+TrackingAllocator::TrackingAllocator(allocators::AllocatorPtr allocator)
+	: allocator_(std::move(allocator))
+	, allocatedBytes_(0)
+{}
+
+void* TrackingAllocator::allocate(const size_t nBytes)
+{
+	allocatedBytes_.fetch_add(nBytes, std::memory_order_relaxed);
+
+	return allocator_->allocate(nBytes);
+}
+
+void TrackingAllocator::deallocate(void* const memory, const size_t nBytes)
+{
+	allocator_->deallocate(memory, nBytes);
+}
+
+GraphProfiler::GraphProfiler()
+	: startTime_(std::chrono::steady_clock::now())
+{}
+
+std::chrono::nanoseconds GraphProfiler::now() const noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_);
+}
+
+void GraphProfiler::record(ProfileEvent event)
+{
+	const std::lock_guard<std::mutex> lock(eventsMutex_);
+
+	event.threadIdx = threadIndices_.try_emplace(std::this_thread::get_id(), threadIndices_.size()).first->second;
+	events_.push_back(std::move(event));
+}
+
+std::vector<ProfileEvent> GraphProfiler::getEvents() const
+{
+	const std::lock_guard<std::mutex> lock(eventsMutex_);
+
+	return events_;
+}
+
+void GraphProfiler::clear()
+{
+	const std::lock_guard<std::mutex> lock(eventsMutex_);
+
+	events_.clear();
+}
+
+void GraphProfiler::writeChromeTrace(std::ostream& stream) const
+{
+	const auto events = getEvents();
+
+	stream << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	for(size_t eventIdx = 0; eventIdx < events.size(); eventIdx++)
+	{
+		const auto& event = events[eventIdx];
+
+		std::vector<std::string> inputShapes;
+
+		std::transform(event.inputShapes.cbegin(),
+					   event.inputShapes.cend(),
+					   std::back_inserter(inputShapes),
+					   [](const std::vector<size_t>& shape) { return stringifyVector(shape); });
+
+		// the timestamps are given in microseconds
+		stream << fmt::format("{}\n{{\"name\": \"{}\", \"cat\": \"{}\", \"ph\": \"X\", \"ts\": {:.3f}, \"dur\": {:.3f}, "
+							  "\"pid\": 0, \"tid\": {}, \"args\": {{\"op\": \"{}\", \"nodeId\": {}, \"allocatedBytes\": "
+							  "{}, \"inputShapes\": \"{}\", \"outputShape\": \"{}\"}}}}",
+							  (eventIdx == 0) ? "" : ",",
+							  escapeJson(getDisplayName(event)),
+							  getPassName(event.pass),
+							  static_cast<double>(event.start.count()) / 1e3,
+							  static_cast<double>(event.duration.count()) / 1e3,
+							  event.threadIdx,
+							  escapeJson(event.opName),
+							  event.nodeId,
+							  event.allocatedBytes,
+							  fmt::join(inputShapes, " "),
+							  stringifyVector(event.outputShape));
+	}
+
+	stream << "\n]}\n";
+}
+
+void GraphProfiler::writeSummary(std::ostream& stream) const
+{
+	const auto events = getEvents();
+
+	std::map<std::pair<std::string, ProfiledPass>, AggregatedEvents> operations;
+	std::map<std::pair<std::string, ProfiledPass>, AggregatedEvents> nodes;
+
+	const auto aggregate = [](AggregatedEvents& aggregated, const ProfileEvent& event) {
+		aggregated.nCalls++;
+		aggregated.totalDuration += event.duration;
+		aggregated.allocatedBytes += event.allocatedBytes;
+	};
+
+	for(const auto& event : events)
+	{
+		aggregate(operations[{event.opName, event.pass}], event);
+		// the unnamed nodes are told apart by their display names already
+		const auto nodeKey = event.nodeName.empty() ? getDisplayName(event)
+													: fmt::format("{} #{} ({})", event.nodeName, event.nodeId, event.opName);
+
+		aggregate(nodes[{nodeKey, event.pass}], event);
+	}
+
+	writeTable(stream, "Operation", operations);
+	stream << "\n";
+	writeTable(stream, "Node", nodes);
+}
+} // namespace mlCore::autoDiff
@@ -0,0 +1,174 @@
+#include <AutoDiff/ExecutionPlan.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include <AutoDiff/BinaryOperators/BinaryOperator.h>
+#include <AutoDiff/HashCombine.h>
+#include <AutoDiff/UnaryOperators/UnaryOperator.h>
+
+namespace mlCore::autoDiff
+{
+namespace
+{
+/// Operation looked up by eliminateCommonSubexpressions.
+struct OperationKey
+{
+	OpCode opCode;
+	size_t lhs;
+	size_t rhs;
+	bool requiresGrad;
+
+	bool operator==(const OperationKey&) const = default;
+};
+
+struct OperationKeyHash
+{
+	size_t operator()(const OperationKey& key) const noexcept
+	{
+		size_t hash = std::hash<size_t>{}(key.lhs);
+
+		combineHash(hash, key.rhs);
+		combineHash(hash, static_cast<size_t>(key.opCode));
+		combineHash(hash, static_cast<size_t>(key.requiresGrad));
+
+		return hash;
+	}
+};
+
+/// Tells whether the operation gives the same result for the swapped inputs.
+constexpr bool isCommutative(const OpCode opCode) noexcept
+{
+	return (opCode == OpCode::ADD) || (opCode == OpCode::MULTIPLY);
+}
+} // namespace
+
+void ExecutionPlan::foldConstants()
+{
+	std::vector<bool> isConstant(slots_.size(), false);
+
+	for(size_t slot = 0; slot < slots_.size(); slot++)
+	{
+		isConstant[slot] =
+			isFolded_[slot] || ((producers_[slot] == NO_PRODUCER) && dynamic_cast<const Constant*>(slots_[slot]));
+	}
+
+	std::vector<Instruction> instructions;
+
+	for(const auto& instruction : instructions_)
+	{
+		const auto inputs = _getInputSlots(instruction);
+		const bool isFoldable = isBuiltIn(instruction.opCode) &&
+								std::all_of(inputs.begin(), inputs.end(), [&isConstant](const size_t input) {
+									return isConstant[input];
+								});
+
+		if(!isFoldable)
+		{
+			instructions.push_back(instruction);
+			continue;
+		}
+
+		// the operator keeps the folded value, which is read as if it was a leaf
+		Node* const node = slots_[instruction.output];
+
+		if(isBinary(instruction.opCode))
+		{
+			static_cast<binaryOperators::BinaryOperator*>(node)->updateValue();
+		}
+		else
+		{
+			static_cast<unaryOperators::UnaryOperator*>(node)->updateValue();
+		}
+
+		node->resolve();
+		isConstant[instruction.output] = true;
+		isFolded_[instruction.output] = true;
+	}
+
+	instructions_ = std::move(instructions);
+
+	_linkInstructions();
+}
+
+void ExecutionPlan::eliminateCommonSubexpressions()
+{
+	// the slot each one is replaced with, i.e. the slot itself unless it is a removed duplicate
+	std::vector<size_t> replacements(slots_.size());
+	std::iota(replacements.begin(), replacements.end(), size_t(0));
+
+	// the custom operators read the values of their own inputs, so these cannot be replaced
+	std::vector<bool> isReadByCustom(slots_.size(), false);
+
+	for(const auto& instruction : instructions_)
+	{
+		if(!isBuiltIn(instruction.opCode) && (instruction.opCode != OpCode::FUSED))
+		{
+			for(const auto input : _getInputSlots(instruction))
+			{
+				isReadByCustom[input] = true;
+			}
+		}
+	}
+
+	std::unordered_map<OperationKey, size_t, OperationKeyHash> computedSlots;
+	std::vector<Instruction> instructions;
+
+	for(auto instruction : instructions_)
+	{
+		if(instruction.opCode == OpCode::FUSED)
+		{
+			// the kernels are not compared, only their inputs are replaced
+			auto& kernel = fusedKernels_[instruction.inputs[0]];
+			auto kernelInputs = kernel.getInputs();
+
+			std::transform(kernelInputs.cbegin(), kernelInputs.cend(), kernelInputs.begin(), [&replacements](const size_t input) {
+				return replacements[input];
+			});
+
+			kernel = FusedKernel(std::move(kernelInputs), kernel.getSteps());
+			instructions.push_back(instruction);
+			continue;
+		}
+
+		const bool isInstructionBinary = isBinary(instruction.opCode);
+		auto& [lhs, rhs] = instruction.inputs;
+
+		lhs = replacements[lhs];
+		rhs = isInstructionBinary ? replacements[rhs] : rhs;
+
+		if(!isBuiltIn(instruction.opCode))
+		{
+			instructions.push_back(instruction);
+			continue;
+		}
+
+		OperationKey key{.opCode = instruction.opCode,
+						 .lhs = lhs,
+						 .rhs = isInstructionBinary ? rhs : lhs,
+						 .requiresGrad = slots_[instruction.output]->requiresGrad()};
+
+		if(isCommutative(key.opCode) && (key.rhs < key.lhs))
+		{
+			std::swap(key.lhs, key.rhs);
+		}
+
+		const auto [computedSlot, isInserted] = computedSlots.emplace(key, instruction.output);
+
+		if(isInserted || isReadByCustom[instruction.output])
+		{
+			instructions.push_back(instruction);
+			continue;
+		}
+
+		replacements[instruction.output] = computedSlot->second;
+		slotIndices_[slots_[instruction.output]] = computedSlot->second;
+		duplicates_.emplace_back(instruction.output, computedSlot->second);
+	}
+
+	instructions_ = std::move(instructions);
+
+	_linkInstructions();
+}
+} // namespace mlCore::autoDiff
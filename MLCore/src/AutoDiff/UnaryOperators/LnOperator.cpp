@@ -5,12 +5,12 @@ namespace mlCore::autoDiff::unaryOperators
 {
 void LnOperator::updateValue()
 {
-	value_ = TensorOperations::ln(input_->getValue());
+	value_ = computeValue(input_->getValue());
 }
 
 Tensor LnOperator::computeDerivative(const Tensor& outerDerivative) const
 {
-	return computeDirectDerivative() * outerDerivative;
+	return computeInputDerivative(outerDerivative, input_->getValue(), value_);
 }
 
 Tensor LnOperator::computeDirectDerivative() const
@@ -24,4 +24,23 @@ Tensor LnOperator::computeDirectDerivative() const
 
 	return inputCopy;
 }
+
+Tensor LnOperator::computeValue(const Tensor& inputValue) const
+{
+	return TensorOperations::ln(inputValue);
+}
+
+Tensor LnOperator::computeInputDerivative(const Tensor& outerDerivative,
+										  const Tensor& inputValue,
+										  const Tensor& /*value*/) const
+{
+	auto derivative = inputValue;
+
+	for(auto& val : derivative)
+	{
+		val = 1.0 / val;
+	}
+
+	return derivative * outerDerivative;
+}
 } // namespace mlCore::autoDiff::unaryOperators
\ No newline at end of file
@@ -5,13 +5,12 @@ namespace mlCore::autoDiff::unaryOperators
 {
 void ReluOperator::updateValue()
 {
-	value_ = TensorOperations::relu(input_->getValue());
+	value_ = computeValue(input_->getValue());
 }
 
 Tensor ReluOperator::computeDerivative(const Tensor& outerDerivative) const
 {
-
-	return computeDirectDerivative() * outerDerivative;
+	return computeInputDerivative(outerDerivative, input_->getValue(), value_);
 }
 
 Tensor ReluOperator::computeDirectDerivative() const
@@ -25,4 +24,23 @@ Tensor ReluOperator::computeDirectDerivative() const
 
 	return inputCopy;
 }
+
+Tensor ReluOperator::computeValue(const Tensor& inputValue) const
+{
+	return TensorOperations::relu(inputValue);
+}
+
+Tensor ReluOperator::computeInputDerivative(const Tensor& outerDerivative,
+											const Tensor& inputValue,
+											const Tensor& /*value*/) const
+{
+	auto derivative = inputValue;
+
+	for(auto& val : derivative)
+	{
+		val = val > 0 ? 1 : 0;
+	}
+
+	return derivative * outerDerivative;
+}
 } // namespace mlCore::autoDiff::unaryOperators
\ No newline at end of file
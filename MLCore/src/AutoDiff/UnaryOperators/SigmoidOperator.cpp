@@ -5,13 +5,12 @@ namespace mlCore::autoDiff::unaryOperators
 {
 void SigmoidOperator::updateValue()
 {
-	value_ = TensorOperations::sigmoid(input_->getValue());
+	value_ = computeValue(input_->getValue());
 }
 
 Tensor SigmoidOperator::computeDerivative(const Tensor& outerDerivative) const
 {
-
-	return computeDirectDerivative() * outerDerivative;
+	return computeInputDerivative(outerDerivative, input_->getValue(), value_);
 }
 
 Tensor SigmoidOperator::computeDirectDerivative() const
@@ -25,4 +24,23 @@ Tensor SigmoidOperator::computeDirectDerivative() const
 
 	return valueCopy;
 }
+
+Tensor SigmoidOperator::computeValue(const Tensor& inputValue) const
+{
+	return TensorOperations::sigmoid(inputValue);
+}
+
+Tensor SigmoidOperator::computeInputDerivative(const Tensor& outerDerivative,
+											   const Tensor& /*inputValue*/,
+											   const Tensor& value) const
+{
+	auto derivative = value;
+
+	for(auto& val : derivative)
+	{
+		val = val * (1 - val);
+	}
+
+	return derivative * outerDerivative;
+}
 } // namespace mlCore::autoDiff::unaryOperators
\ No newline at end of file
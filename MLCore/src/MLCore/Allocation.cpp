@@ -0,0 +1,73 @@
+#include <MLCore/Allocation.h>
+
+#include <atomic>
+#include <mutex>
+
+#include <MLCore/Allocators/HeapAllocator.h>
+
+namespace mlCore
+{
+namespace
+{
+/// Gets the allocator used when no other one is chosen.
+const allocators::AllocatorPtr& getDefaultAllocator()
+{
+	static const allocators::AllocatorPtr defaultAllocator = std::make_shared<allocators::HeapAllocator>();
+	return defaultAllocator;
+}
+
+std::mutex globalAllocatorMutex;
+allocators::AllocatorPtr globalAllocator;
+
+// incremented on each change of the global allocator, so that the threads can use their copies of it without locking
+std::atomic<uint64_t> globalAllocatorVersion = 1;
+
+thread_local allocators::AllocatorPtr cachedGlobalAllocator;
+thread_local uint64_t cachedGlobalAllocatorVersion = 0;
+
+thread_local allocators::AllocatorPtr scopedAllocator;
+} // namespace
+
+void setGlobalAllocator(allocators::AllocatorPtr allocator)
+{
+	std::unique_lock<std::mutex> lock(globalAllocatorMutex);
+
+	globalAllocator = allocator ? std::move(allocator) : getDefaultAllocator();
+	globalAllocatorVersion++;
+}
+
+allocators::AllocatorPtr getGlobalAllocator()
+{
+	std::unique_lock<std::mutex> lock(globalAllocatorMutex);
+	return globalAllocator ? globalAllocator : getDefaultAllocator();
+}
+
+allocators::AllocatorPtr getCurrentAllocator()
+{
+	if(scopedAllocator)
+	{
+		return scopedAllocator;
+	}
+
+	if(const auto version = globalAllocatorVersion.load(std::memory_order_acquire); version != cachedGlobalAllocatorVersion)
+	{
+		std::unique_lock<std::mutex> lock(globalAllocatorMutex);
+
+		cachedGlobalAllocator = globalAllocator ? globalAllocator : getDefaultAllocator();
+		cachedGlobalAllocatorVersion = globalAllocatorVersion.load(std::memory_order_relaxed);
+	}
+
+	return cachedGlobalAllocator;
+}
+
+AllocatorScope::AllocatorScope(allocators::AllocatorPtr allocator)
+	: previousAllocator_(std::move(scopedAllocator))
+{
+	scopedAllocator = allocator ? std::move(allocator) : getDefaultAllocator();
+}
+
+AllocatorScope::~AllocatorScope()
+{
+	scopedAllocator = std::move(previousAllocator_);
+}
+} // namespace mlCore
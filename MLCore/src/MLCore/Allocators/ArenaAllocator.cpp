@@ -0,0 +1,122 @@
+#include <MLCore/Allocators/ArenaAllocator.h>
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace mlCore::allocators
+{
+namespace
+{
+/// Rounds `nBytes` up to a multiple of kAllocationAlignment.
+size_t alignUp(const size_t nBytes)
+{
+	return (nBytes + kAllocationAlignment - 1) / kAllocationAlignment * kAllocationAlignment;
+}
+} // namespace
+
+ArenaAllocator::ArenaAllocator(const size_t chunkSize)
+	: chunkSize_(alignUp(chunkSize))
+	, mutex_()
+	, chunks_()
+	, currentOffset_(0)
+	, usedBytes_(0)
+	, nLiveBlocks_(0)
+{ }
+
+ArenaAllocator::~ArenaAllocator()
+{
+	_freeChunks();
+}
+
+void* ArenaAllocator::allocate(const size_t nBytes)
+{
+	const size_t blockSize = alignUp(std::max(nBytes, size_t(1)));
+
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	if(chunks_.empty() || (currentOffset_ + blockSize > chunks_.back().size))
+	{
+		_addChunk(blockSize);
+	}
+
+	void* const block = chunks_.back().memory + currentOffset_;
+
+	currentOffset_ += blockSize;
+	usedBytes_ += blockSize;
+	nLiveBlocks_++;
+
+	return block;
+}
+
+void ArenaAllocator::deallocate(void* const /*memory*/, const size_t /*nBytes*/)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	nLiveBlocks_--;
+}
+
+void ArenaAllocator::reset()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	if(nLiveBlocks_ > 0)
+	{
+		throw std::runtime_error(
+			fmt::format("Cannot reset the arena, since {} of the allocated blocks are still in use.", nLiveBlocks_));
+	}
+
+	if(chunks_.size() > 1)
+	{
+		size_t capacity = 0;
+		for(const auto& chunk : chunks_)
+		{
+			capacity += chunk.size;
+		}
+
+		_freeChunks();
+		_addChunk(capacity);
+	}
+
+	currentOffset_ = 0;
+	usedBytes_ = 0;
+}
+
+size_t ArenaAllocator::getUsedBytes() const
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	return usedBytes_;
+}
+
+size_t ArenaAllocator::getCapacity() const
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	size_t capacity = 0;
+	for(const auto& chunk : chunks_)
+	{
+		capacity += chunk.size;
+	}
+
+	return capacity;
+}
+
+void ArenaAllocator::_addChunk(const size_t nBytes)
+{
+	const size_t size = std::max(nBytes, chunkSize_);
+
+	chunks_.push_back({static_cast<std::byte*>(::operator new(size, std::align_val_t(kAllocationAlignment))), size});
+	currentOffset_ = 0;
+}
+
+void ArenaAllocator::_freeChunks() noexcept
+{
+	for(const auto& chunk : chunks_)
+	{
+		::operator delete(chunk.memory, std::align_val_t(kAllocationAlignment));
+	}
+
+	chunks_.clear();
+}
+} // namespace mlCore::allocators
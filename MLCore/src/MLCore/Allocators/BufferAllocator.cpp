@@ -0,0 +1,51 @@
+#include <MLCore/Allocators/BufferAllocator.h>
+
+#include <utility>
+
+namespace mlCore::allocators
+{
+BufferAllocator::BufferAllocator(const size_t bufferBytes, AllocatorPtr fallback)
+	: bufferBytes_(bufferBytes)
+	, fallback_(std::move(fallback))
+	, buffer_(nullptr)
+	, isLent_(false)
+{ }
+
+BufferAllocator::~BufferAllocator()
+{
+	if(void* const buffer = buffer_.load(std::memory_order_relaxed))
+	{
+		fallback_->deallocate(buffer, bufferBytes_);
+	}
+}
+
+void* BufferAllocator::allocate(const size_t nBytes)
+{
+	if(nBytes > bufferBytes_ || isLent_.exchange(true, std::memory_order_acquire))
+	{
+		return fallback_->allocate(nBytes);
+	}
+
+	// only the thread which has taken the buffer can get here, so it is allocated once
+	void* buffer = buffer_.load(std::memory_order_relaxed);
+
+	if(!buffer)
+	{
+		buffer = fallback_->allocate(bufferBytes_);
+		buffer_.store(buffer, std::memory_order_relaxed);
+	}
+
+	return buffer;
+}
+
+void BufferAllocator::deallocate(void* const memory, const size_t nBytes)
+{
+	if(memory == buffer_.load(std::memory_order_relaxed))
+	{
+		isLent_.store(false, std::memory_order_release);
+		return;
+	}
+
+	fallback_->deallocate(memory, nBytes);
+}
+} // namespace mlCore::allocators
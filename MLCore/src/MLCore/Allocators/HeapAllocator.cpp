@@ -0,0 +1,16 @@
+#include <MLCore/Allocators/HeapAllocator.h>
+
+#include <new>
+
+namespace mlCore::allocators
+{
+void* HeapAllocator::allocate(const size_t nBytes)
+{
+	return ::operator new(nBytes, std::align_val_t(kAllocationAlignment));
+}
+
+void HeapAllocator::deallocate(void* const memory, const size_t /*nBytes*/)
+{
+	::operator delete(memory, std::align_val_t(kAllocationAlignment));
+}
+} // namespace mlCore::allocators
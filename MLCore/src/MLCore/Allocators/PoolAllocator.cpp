@@ -0,0 +1,218 @@
+#include <MLCore/Allocators/PoolAllocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
+#include <unordered_map>
+
+namespace mlCore::allocators
+{
+namespace
+{
+/// Size of the smallest block, so that the blocks never share a cache line.
+constexpr size_t kMinBlockSize = kAllocationAlignment;
+
+std::atomic<uint64_t> nextPoolId = 0;
+
+void* allocateBlock(const size_t blockSize)
+{
+	return ::operator new(blockSize, std::align_val_t(kAllocationAlignment));
+}
+
+void freeBlock(void* const block)
+{
+	::operator delete(block, std::align_val_t(kAllocationAlignment));
+}
+
+/// Blocks cached by a single thread for a single pool.
+struct PoolCache
+{
+	std::vector<std::vector<void*>> freeLists{};
+	size_t nCachedBytes = 0;
+};
+
+/**
+ * @brief Blocks cached by the current thread, grouped by the pools' ids. The pools are identified by ids that are never
+ * reused, so that blocks of a destroyed pool are never handed out by another one.
+ *
+ * The blocks are plain heap memory, so the cache can free them on thread exit even if the pool no longer exists.
+ */
+struct ThreadCache
+{
+	ThreadCache() = default;
+
+	ThreadCache(const ThreadCache&) = delete;
+	ThreadCache(ThreadCache&&) = delete;
+	ThreadCache& operator=(const ThreadCache&) = delete;
+	ThreadCache& operator=(ThreadCache&&) = delete;
+
+	~ThreadCache()
+	{
+		isDestroyed = true;
+
+		for(auto& [poolId, poolCache] : pools)
+		{
+			for(const auto& freeList : poolCache.freeLists)
+			{
+				std::for_each(freeList.begin(), freeList.end(), freeBlock);
+			}
+		}
+	}
+
+	std::unordered_map<uint64_t, PoolCache> pools{};
+
+	/// Set when the thread exits, so that the blocks freed by the later destructors go to the shared lists.
+	static thread_local bool isDestroyed;
+};
+
+thread_local bool ThreadCache::isDestroyed = false;
+thread_local ThreadCache threadCache;
+
+/// Gets blocks cached by the current thread for the pool or nullptr if there are none.
+PoolCache* findPoolCache(const uint64_t poolId)
+{
+	if(ThreadCache::isDestroyed)
+	{
+		return nullptr;
+	}
+
+	const auto poolCacheIter = threadCache.pools.find(poolId);
+
+	return poolCacheIter == threadCache.pools.end() ? nullptr : &poolCacheIter->second;
+}
+} // namespace
+
+PoolAllocator::PoolAllocator(const size_t maxThreadCachedBytes, const size_t maxBlockSize)
+	: id_(nextPoolId++)
+	, maxThreadCachedBytes_(maxThreadCachedBytes)
+	, maxBlockSize_(getBlockSize(maxBlockSize))
+	, sharedFreeListsMutex_()
+	, sharedFreeLists_(_getSizeClass(maxBlockSize_) + 1)
+{ }
+
+PoolAllocator::~PoolAllocator()
+{
+	release();
+}
+
+void* PoolAllocator::allocate(const size_t nBytes)
+{
+	const size_t blockSize = getBlockSize(nBytes);
+
+	if(blockSize > maxBlockSize_)
+	{
+		return allocateBlock(blockSize);
+	}
+
+	const size_t sizeClass = _getSizeClass(blockSize);
+
+	if(auto* const poolCache = findPoolCache(id_); poolCache && !poolCache->freeLists[sizeClass].empty())
+	{
+		auto& freeList = poolCache->freeLists[sizeClass];
+
+		void* const block = freeList.back();
+		freeList.pop_back();
+		poolCache->nCachedBytes -= blockSize;
+
+		return block;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(sharedFreeListsMutex_);
+		auto& freeList = sharedFreeLists_[sizeClass];
+
+		if(!freeList.empty())
+		{
+			void* const block = freeList.back();
+			freeList.pop_back();
+
+			return block;
+		}
+	}
+
+	return allocateBlock(blockSize);
+}
+
+void PoolAllocator::deallocate(void* const memory, const size_t nBytes)
+{
+	const size_t blockSize = getBlockSize(nBytes);
+
+	if(blockSize > maxBlockSize_)
+	{
+		freeBlock(memory);
+		return;
+	}
+
+	const size_t sizeClass = _getSizeClass(blockSize);
+
+	auto* poolCache = findPoolCache(id_);
+
+	if(!poolCache && !ThreadCache::isDestroyed)
+	{
+		poolCache = &threadCache.pools[id_];
+		poolCache->freeLists.resize(sharedFreeLists_.size());
+	}
+
+	if(poolCache && (poolCache->nCachedBytes + blockSize <= maxThreadCachedBytes_))
+	{
+		poolCache->freeLists[sizeClass].push_back(memory);
+		poolCache->nCachedBytes += blockSize;
+
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(sharedFreeListsMutex_);
+	sharedFreeLists_[sizeClass].push_back(memory);
+}
+
+void PoolAllocator::release()
+{
+	if(const auto* const poolCache = findPoolCache(id_))
+	{
+		for(const auto& freeList : poolCache->freeLists)
+		{
+			std::for_each(freeList.begin(), freeList.end(), freeBlock);
+		}
+
+		threadCache.pools.erase(id_);
+	}
+
+	std::unique_lock<std::mutex> lock(sharedFreeListsMutex_);
+
+	for(auto& freeList : sharedFreeLists_)
+	{
+		std::for_each(freeList.begin(), freeList.end(), freeBlock);
+		freeList.clear();
+	}
+}
+
+size_t PoolAllocator::getCachedBytes() const
+{
+	size_t nCachedBytes = 0;
+
+	if(const auto* const poolCache = findPoolCache(id_))
+	{
+		nCachedBytes += poolCache->nCachedBytes;
+	}
+
+	std::unique_lock<std::mutex> lock(sharedFreeListsMutex_);
+
+	for(size_t sizeClass = 0; sizeClass < sharedFreeLists_.size(); sizeClass++)
+	{
+		nCachedBytes += sharedFreeLists_[sizeClass].size() * (kMinBlockSize << sizeClass);
+	}
+
+	return nCachedBytes;
+}
+
+size_t PoolAllocator::getBlockSize(const size_t nBytes) noexcept
+{
+	return std::bit_ceil(std::max(nBytes, kMinBlockSize));
+}
+
+size_t PoolAllocator::_getSizeClass(const size_t blockSize) noexcept
+{
+	return static_cast<size_t>(std::countr_zero(blockSize) - std::countr_zero(kMinBlockSize));
+}
+} // namespace mlCore::allocators
@@ -1,7 +1,11 @@
 #include "MLCore/BasicTensor.h"
 
+#include <utility>
+
 #include <fmt/format.h>
 
+#include <MLCore/Allocation.h>
+#include <MLCore/BasicTensorView.h>
 #include <MLCore/TensorOperationsImpl.h>
 
 namespace mlCore
@@ -9,16 +13,38 @@ namespace mlCore
 /**************************
  * Explicit instantiations
  **************************/
-template class BasicTensor<double>;
-template std::ostream& operator<<(std::ostream& out, const BasicTensor<double>& tensor);
+// NOLINTBEGIN
+
+// Instantiates the tensor together with its free operators
+#define INSTANTIATE_BASIC_TENSOR(ValueType)                                                                                      \
+	template class BasicTensor<ValueType>;                                                                                       \
+	template std::ostream& operator<<(std::ostream& out, const BasicTensor<ValueType>& tensor);                                  \
+	template BasicTensor<ValueType> operator+(const BasicTensor<ValueType>& lhs, BasicTensor<ValueType>&& rhs);                  \
+	template BasicTensor<ValueType> operator-(const BasicTensor<ValueType>& lhs, BasicTensor<ValueType>&& rhs);                  \
+	template BasicTensor<ValueType> operator*(const BasicTensor<ValueType>& lhs, BasicTensor<ValueType>&& rhs);                  \
+	template BasicTensor<ValueType> operator/(const BasicTensor<ValueType>& lhs, BasicTensor<ValueType>&& rhs);                  \
+	template BasicTensor<ValueType> operator+(BasicTensor<ValueType>&& lhs, BasicTensor<ValueType>&& rhs);                       \
+	template BasicTensor<ValueType> operator-(BasicTensor<ValueType>&& lhs, BasicTensor<ValueType>&& rhs);                       \
+	template BasicTensor<ValueType> operator*(BasicTensor<ValueType>&& lhs, BasicTensor<ValueType>&& rhs);                       \
+	template BasicTensor<ValueType> operator/(BasicTensor<ValueType>&& lhs, BasicTensor<ValueType>&& rhs);
+
+INSTANTIATE_BASIC_TENSOR(double)
+INSTANTIATE_BASIC_TENSOR(float)
+INSTANTIATE_BASIC_TENSOR(int32_t)
+INSTANTIATE_BASIC_TENSOR(BFloat16)
+
+#undef INSTANTIATE_BASIC_TENSOR
+
+// NOLINTEND
 
 template <typename ValueType>
 BasicTensor<ValueType>::BasicTensor()
 	: length_(1)
 	, shape_()
+	, storage_()
 	, data_()
 {
-	data_ = new ValueType[1];
+	_allocate();
 }
 
 template <typename ValueType>
@@ -32,6 +58,7 @@ template <typename ValueType>
 BasicTensor<ValueType>::BasicTensor(const std::vector<size_t>& shape)
 	: length_()
 	, shape_(shape)
+	, storage_()
 	, data_()
 {
 	try
@@ -78,7 +105,7 @@ BasicTensor<ValueType>::BasicTensor(const std::vector<size_t>& shape)
 	length_ = std::accumulate(
 		shape_.begin(), shape_.end(), size_t(1), [](const auto current, const auto dim) { return current * dim; });
 
-	data_ = new ValueType[length_];
+	_allocate();
 }
 
 template <typename ValueType>
@@ -107,18 +134,15 @@ template <typename ValueType>
 BasicTensor<ValueType>::BasicTensor(const BasicTensor& other)
 	: length_(other.length_)
 	, shape_(other.shape_)
-	, data_(new ValueType[length_])
-{
-	for(size_t pos = 0; pos < length_; pos++)
-	{
-		data_[pos] = other.data_[pos];
-	}
-}
+	, storage_(other.storage_)
+	, data_(other.data_)
+{ }
 
 template <typename ValueType>
 BasicTensor<ValueType>::BasicTensor(BasicTensor&& other)
 	: length_(other.length_)
 	, shape_(std::move(other.shape_))
+	, storage_(std::move(other.storage_))
 	, data_(other.data_)
 {
 	other.length_ = 0;
@@ -126,29 +150,17 @@ BasicTensor<ValueType>::BasicTensor(BasicTensor&& other)
 }
 
 template <typename ValueType>
-BasicTensor<ValueType>::~BasicTensor()
-{
-	delete[] data_;
-}
+BasicTensor<ValueType>::~BasicTensor() = default;
 
 template <typename ValueType>
 BasicTensor<ValueType>& BasicTensor<ValueType>::operator=(const BasicTensor& other)
 {
 	if(&other != this)
 	{
-		if(length_ != other.length_)
-		{
-			delete[] data_;
-			length_ = other.length_;
-			data_ = new ValueType[length_];
-		}
-
+		storage_ = other.storage_;
+		data_ = other.data_;
+		length_ = other.length_;
 		shape_ = other.shape_;
-
-		for(size_t i = 0; i < length_; i++)
-		{
-			data_[i] = other.data_[i];
-		}
 	}
 
 	return *this;
@@ -159,7 +171,7 @@ BasicTensor<ValueType>& BasicTensor<ValueType>::operator=(BasicTensor&& other)
 {
 	if(&other != this)
 	{
-		delete[] data_;
+		storage_ = std::move(other.storage_);
 		data_ = other.data_;
 		other.data_ = nullptr;
 
@@ -182,6 +194,33 @@ void BasicTensor<ValueType>::reshape(const std::vector<size_t>& newShape)
 	shape_ = newShape;
 }
 
+template <typename ValueType>
+void BasicTensor<ValueType>::_allocate()
+{
+	// the allocator is kept alive by the storage, so that it is always able to take its memory back
+	auto allocator = getCurrentAllocator();
+	const size_t nBytes = length_ * sizeof(ValueType);
+
+	data_ = static_cast<ValueType*>(allocator->allocate(nBytes));
+	storage_ = std::shared_ptr<ValueType[]>(data_, [allocator = std::move(allocator), nBytes](ValueType* const data) {
+		allocator->deallocate(data, nBytes);
+	});
+}
+
+template <typename ValueType>
+void BasicTensor<ValueType>::_detachStorage()
+{
+	if(storage_.use_count() <= 1)
+	{
+		return;
+	}
+
+	const auto sharedStorage = std::move(storage_);
+
+	_allocate();
+	std::copy(sharedStorage.get(), sharedStorage.get() + length_, data_);
+}
+
 template <typename ValueType>
 void BasicTensor<ValueType>::_checkShapeElementsPositive(const std::vector<size_t>& shape)
 {
@@ -211,7 +250,7 @@ template <typename ValueType>
 void BasicTensor<ValueType>::_checkShapeCompatible(const std::vector<size_t>& shape) const
 {
 	const auto newLength = std::accumulate(
-		shape.begin(), shape.end(), size_t(0), [](const auto current, const auto axis) { return current * axis; });
+		shape.begin(), shape.end(), size_t(1), [](const auto current, const auto axis) { return current * axis; });
 
 	if(newLength != length_)
 	{
@@ -255,62 +294,110 @@ void BasicTensor<ValueType>::_checkIndicesList(const std::initializer_list<std::
 }
 
 template <typename ValueType>
-BasicTensor<ValueType> BasicTensor<ValueType>::operator*(const BasicTensor& other) const
+BasicTensor<ValueType> BasicTensor<ValueType>::operator+(const BasicTensor& other) const&
 {
-	auto ret = *this;
-	TensorOperationsImpl<double>::multiplyTensorsInPlace(ret, other);
+	BasicTensor<ValueType> ret(TensorOperationsImpl<ValueType>::getBroadcastedShape(shape_, other.shape_));
+	TensorOperationsImpl<ValueType>::addTensors(*this, other, ret);
 	return ret;
 }
 
 template <typename ValueType>
-BasicTensor<ValueType> BasicTensor<ValueType>::operator-(const BasicTensor& other) const
+BasicTensor<ValueType> BasicTensor<ValueType>::operator-(const BasicTensor& other) const&
 {
-	auto ret = *this;
-	TensorOperationsImpl<double>::subtractTensorsInPlace(ret, other);
+	BasicTensor<ValueType> ret(TensorOperationsImpl<ValueType>::getBroadcastedShape(shape_, other.shape_));
+	TensorOperationsImpl<ValueType>::subtractTensors(*this, other, ret);
 	return ret;
 }
 
 template <typename ValueType>
-BasicTensor<ValueType> BasicTensor<ValueType>::operator+(const BasicTensor& other) const
+BasicTensor<ValueType> BasicTensor<ValueType>::operator*(const BasicTensor& other) const&
 {
-	auto ret = *this;
-	TensorOperationsImpl<double>::addTensorsInPlace(ret, other);
+	BasicTensor<ValueType> ret(TensorOperationsImpl<ValueType>::getBroadcastedShape(shape_, other.shape_));
+	TensorOperationsImpl<ValueType>::multiplyTensors(*this, other, ret);
 	return ret;
 }
 
 template <typename ValueType>
-BasicTensor<ValueType> BasicTensor<ValueType>::operator/(const BasicTensor& other) const
+BasicTensor<ValueType> BasicTensor<ValueType>::operator/(const BasicTensor& other) const&
 {
-	auto ret = *this;
-	TensorOperationsImpl<double>::divideTensorsInPlace(ret, other);
+	BasicTensor<ValueType> ret(TensorOperationsImpl<ValueType>::getBroadcastedShape(shape_, other.shape_));
+	TensorOperationsImpl<ValueType>::divideTensors(*this, other, ret);
 	return ret;
 }
 
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensor<ValueType>::operator+(const BasicTensor& other) &&
+{
+	if(TensorOperationsImpl<ValueType>::canStoreResult(*this, other))
+	{
+		TensorOperationsImpl<ValueType>::addTensors(*this, other, *this);
+		return std::move(*this);
+	}
+
+	return std::as_const(*this) + other;
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensor<ValueType>::operator-(const BasicTensor& other) &&
+{
+	if(TensorOperationsImpl<ValueType>::canStoreResult(*this, other))
+	{
+		TensorOperationsImpl<ValueType>::subtractTensors(*this, other, *this);
+		return std::move(*this);
+	}
+
+	return std::as_const(*this) - other;
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensor<ValueType>::operator*(const BasicTensor& other) &&
+{
+	if(TensorOperationsImpl<ValueType>::canStoreResult(*this, other))
+	{
+		TensorOperationsImpl<ValueType>::multiplyTensors(*this, other, *this);
+		return std::move(*this);
+	}
+
+	return std::as_const(*this) * other;
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensor<ValueType>::operator/(const BasicTensor& other) &&
+{
+	if(TensorOperationsImpl<ValueType>::canStoreResult(*this, other))
+	{
+		TensorOperationsImpl<ValueType>::divideTensors(*this, other, *this);
+		return std::move(*this);
+	}
+
+	return std::as_const(*this) / other;
+}
+
 template <typename ValueType>
 BasicTensor<ValueType>& BasicTensor<ValueType>::operator+=(const BasicTensor& other)
 {
-	TensorOperationsImpl<double>::addTensorsInPlace(*this, other);
+	TensorOperationsImpl<ValueType>::addTensorsInPlace(*this, other);
 	return *this;
 }
 
 template <typename ValueType>
 BasicTensor<ValueType>& BasicTensor<ValueType>::operator-=(const BasicTensor& other)
 {
-	TensorOperationsImpl<double>::subtractTensorsInPlace(*this, other);
+	TensorOperationsImpl<ValueType>::subtractTensorsInPlace(*this, other);
 	return *this;
 }
 
 template <typename ValueType>
 BasicTensor<ValueType>& BasicTensor<ValueType>::operator*=(const BasicTensor& other)
 {
-	TensorOperationsImpl<double>::multiplyTensorsInPlace(*this, other);
+	TensorOperationsImpl<ValueType>::multiplyTensorsInPlace(*this, other);
 	return *this;
 }
 
 template <typename ValueType>
 BasicTensor<ValueType>& BasicTensor<ValueType>::operator/=(const BasicTensor& other)
 {
-	TensorOperationsImpl<double>::divideTensorsInPlace(*this, other);
+	TensorOperationsImpl<ValueType>::divideTensorsInPlace(*this, other);
 	return *this;
 }
 
@@ -327,160 +414,22 @@ BasicTensor<ValueType> BasicTensor<ValueType>::operator-() const
 	return ret;
 }
 
-// NOLINTBEGIN
 template <typename ValueType>
 BasicTensor<ValueType> BasicTensor<ValueType>::matmul(const BasicTensor& other) const
 {
+	return BasicTensorView<ValueType>(*this).matmul(other);
+}
 
-	// for clean error throwing with additional info about shapes
-	auto throwInformative = [this, &other](const std::string& message) {
-		throw std::runtime_error(fmt::format("Cannot perform matrix multiplication for shapes '{}' and '{}' - {}",
-											 stringifyVector(shape_),
-											 stringifyVector(other.shape_),
-											 message));
-	};
-
-	// checking if first tensor can be padded to nDims >= 2
-	if(other.shape_.size() < 2)
-	{
-		throwInformative("Cannot obtain last but one dimension of the second tensor");
-	}
-
-	// for padding tensors shapes
-	const size_t biggerSize = std::max(shape_.size(), other.shape_.size());
-
-	// padded shapes for easier operating
-	std::vector<size_t> paddedShapeFirst(biggerSize, 1);
-	std::vector<size_t> paddedShapeSecond(biggerSize, 1);
-
-	std::copy(
-		shape_.cbegin(), shape_.cend(), std::next(paddedShapeFirst.begin(), static_cast<ptrdiff_t>(biggerSize - shape_.size())));
-
-	std::copy(other.shape_.cbegin(),
-			  other.shape_.cend(),
-			  std::next(paddedShapeSecond.begin(), static_cast<ptrdiff_t>(biggerSize - other.shape_.size())));
-
-	// checking matmul conditions
-	if(paddedShapeFirst[biggerSize - 1] != paddedShapeSecond[biggerSize - 2])
-	{
-		throwInformative("Last two dimensions are incompatible");
-	}
-
-	for(size_t i = 0; i < biggerSize - 2; i++)
-	{
-		if((paddedShapeFirst[i] != paddedShapeSecond[i]) && (paddedShapeFirst[i] != 1) && (paddedShapeSecond[i] != 1))
-		{
-			throwInformative("shapes are incompatible");
-		}
-	}
-
-	std::vector<size_t> retShape(biggerSize);
-	retShape[biggerSize - 2] = paddedShapeFirst[biggerSize - 2];
-	retShape[biggerSize - 1] = paddedShapeSecond[biggerSize - 1];
-
-	for(size_t i = 0; i < biggerSize - 2; i++)
-	{
-		retShape[i] = paddedShapeFirst[i] == 1 ? paddedShapeSecond[i] : paddedShapeFirst[i];
-	}
-
-	BasicTensor<ValueType> resultTensor(retShape, 0);
-
-	// tells the position of a single computed matrix relative to the array of values
-	auto computeFramePos = [](const std::vector<size_t>& treePath, const std::vector<size_t>& shape) -> size_t {
-		size_t offset = 0;
-		size_t factor = shape[shape.size() - 1] * shape[shape.size() - 2];
-		for(size_t i = shape.size() - 3; i < shape.size() - 2; i--)
-		{
-			offset += treePath[i] * factor;
-			factor *= shape[i];
-		}
-		return offset;
-	};
-
-	size_t resElementPos = 0;
-	const size_t adjacentDimension = paddedShapeFirst[biggerSize - 1];
-	std::vector<size_t> firstTreePath(biggerSize - 2, 0);
-	std::vector<size_t> secondTreePath(biggerSize - 2, 0);
-
-	while(resElementPos < resultTensor.length_)
-	{
-		// proper data pointers with offsets for obtaining frame elements
-		const ValueType* firstDataPtr = data_ + computeFramePos(firstTreePath, shape_);
-		const ValueType* secondDataPtr = other.data_ + computeFramePos(secondTreePath, other.shape_);
-
-		// rows and cols of result frame
-		for(size_t rowIter = 0; rowIter < retShape[biggerSize - 2]; rowIter++)
-		{
-			for(size_t colIter = 0; colIter < retShape[biggerSize - 1]; colIter++)
-			{
-				// position of a certain multiplication in sum of multiplications
-				for(size_t mulIter = 0; mulIter < adjacentDimension; mulIter++)
-				{
-					resultTensor.data_[resElementPos] += firstDataPtr[rowIter * adjacentDimension + mulIter] *
-														 secondDataPtr[mulIter * paddedShapeSecond[biggerSize - 1] + colIter];
-				}
-				resElementPos++;
-			}
-		}
-
-		// tells which dimension of the tree path should be incremented
-		for(size_t i = biggerSize - 3; i < biggerSize - 2; i--)
-		{
-
-			if(paddedShapeFirst[i] > 1)
-			{
-				firstTreePath[i]++;
-			}
-
-			if(paddedShapeSecond[i] > 1)
-			{
-				secondTreePath[i]++;
-			}
-
-			if((firstTreePath[i] < paddedShapeFirst[i]) && (secondTreePath[i] < paddedShapeSecond[i]))
-			{
-				break;
-			}
-
-			firstTreePath[i] = 0;
-			secondTreePath[i] = 0;
-		}
-	}
-
-	return resultTensor;
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensor<ValueType>::matmul(const BasicTensorView<ValueType>& other) const
+{
+	return BasicTensorView<ValueType>(*this).matmul(other);
 }
-// NOLINTEND
 
 template <typename ValueType>
 BasicTensor<ValueType> BasicTensor<ValueType>::transposed() const
 {
-
-	std::vector<size_t> retShape;
-	for(size_t i = 0; i < shape_.size() - 2; i++)
-	{
-		retShape.push_back(shape_[i]);
-	}
-
-	// size of a single 2-dimensional part that takes part in single matrix multiplication
-	const size_t frameShapeFirst = *(++shape_.rbegin());
-	const size_t frameShapeSecond = *shape_.rbegin();
-	const size_t frameLength = frameShapeFirst * frameShapeSecond;
-
-	retShape.push_back(frameShapeSecond);
-	retShape.push_back(frameShapeFirst);
-
-	BasicTensor<ValueType> ret(retShape);
-
-	for(size_t frameOffset = 0; frameOffset < length_; frameOffset += frameLength)
-	{
-		for(size_t posInFrame = 0; posInFrame < frameLength; posInFrame++)
-		{
-			ret.data_[frameOffset + posInFrame] =
-				data_[frameOffset + (posInFrame % frameShapeFirst) * frameShapeSecond + (posInFrame / frameShapeFirst)];
-		}
-	}
-
-	return ret;
+	return BasicTensorView<ValueType>(*this).transposed().contiguous();
 }
 
 template <typename ValueType>
@@ -527,6 +476,8 @@ void BasicTensor<ValueType>::assign(std::initializer_list<std::pair<size_t, size
 		return offset;
 	};
 
+	_detachStorage();
+
 	auto dataIter = newData.begin();
 	size_t elementsProcessed = 0;
 	while(elementsProcessed < itemsToAssign)
@@ -560,6 +511,8 @@ void BasicTensor<ValueType>::assign(std::initializer_list<std::pair<size_t, size
 template <typename ValueType>
 void BasicTensor<ValueType>::fill(const tensorInitializers::ITensorInitializer<ValueType>& initializer)
 {
+	_detachStorage();
+
 	size_t elementPos = 0;
 	while(initializer.canYield() && (elementPos < length_))
 	{
@@ -652,4 +605,96 @@ std::ostream& operator<<(std::ostream& out, const BasicTensor<TensorValueType>&
 	return out;
 }
 
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator+(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(rhs, lhs))
+	{
+		TensorOperationsImpl<TensorValueType>::addTensors(lhs, rhs, rhs);
+		return std::move(rhs);
+	}
+
+	return lhs + std::as_const(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator-(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(rhs, lhs))
+	{
+		TensorOperationsImpl<TensorValueType>::subtractTensors(lhs, rhs, rhs);
+		return std::move(rhs);
+	}
+
+	return lhs - std::as_const(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator*(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(rhs, lhs))
+	{
+		TensorOperationsImpl<TensorValueType>::multiplyTensors(lhs, rhs, rhs);
+		return std::move(rhs);
+	}
+
+	return lhs * std::as_const(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator/(const BasicTensor<TensorValueType>& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(rhs, lhs))
+	{
+		TensorOperationsImpl<TensorValueType>::divideTensors(lhs, rhs, rhs);
+		return std::move(rhs);
+	}
+
+	return lhs / std::as_const(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator+(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(lhs, rhs))
+	{
+		return std::move(lhs) + std::as_const(rhs);
+	}
+
+	return std::as_const(lhs) + std::move(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator-(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(lhs, rhs))
+	{
+		return std::move(lhs) - std::as_const(rhs);
+	}
+
+	return std::as_const(lhs) - std::move(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator*(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(lhs, rhs))
+	{
+		return std::move(lhs) * std::as_const(rhs);
+	}
+
+	return std::as_const(lhs) * std::move(rhs);
+}
+
+template <typename TensorValueType>
+BasicTensor<TensorValueType> operator/(BasicTensor<TensorValueType>&& lhs, BasicTensor<TensorValueType>&& rhs)
+{
+	if(TensorOperationsImpl<TensorValueType>::canStoreResult(lhs, rhs))
+	{
+		return std::move(lhs) / std::as_const(rhs);
+	}
+
+	return std::as_const(lhs) / std::move(rhs);
+}
+
 } // namespace mlCore
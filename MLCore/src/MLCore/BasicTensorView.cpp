@@ -0,0 +1,444 @@
+#include <MLCore/BasicTensorView.h>
+
+#include <fmt/format.h>
+
+#include <MLCore/BroadcastingImpl.h>
+#include <MLCore/MatmulImpl.h>
+#include <MLCore/TensorOperationsImpl.h>
+
+namespace mlCore
+{
+namespace
+{
+/// Computes strides of a contiguous row-major tensor with the given shape.
+std::vector<size_t> computeContiguousStrides(const std::vector<size_t>& shape)
+{
+	std::vector<size_t> strides(shape.size());
+
+	size_t stride = 1;
+	for(size_t dim = shape.size() - 1; dim < shape.size(); dim--)
+	{
+		strides[dim] = stride;
+		stride *= shape[dim];
+	}
+
+	return strides;
+}
+} // namespace
+
+/**************************
+ * Explicit instantiations
+ **************************/
+template class BasicTensorView<double>;
+template class BasicTensorView<float>;
+template class BasicTensorView<int32_t>;
+template class BasicTensorView<BFloat16>;
+
+template <typename ValueType>
+BasicTensorView<ValueType>::BasicTensorView(const BasicTensor<ValueType>& tensor)
+	: storage_(tensor.storage_)
+	, data_(tensor.data_)
+	, shape_(tensor.shape_)
+	, strides_(computeContiguousStrides(tensor.shape_))
+{ }
+
+template <typename ValueType>
+BasicTensorView<ValueType>::BasicTensorView(std::shared_ptr<ValueType[]> storage,
+											const ValueType* data,
+											std::vector<size_t> shape,
+											std::vector<size_t> strides)
+	: storage_(std::move(storage))
+	, data_(data)
+	, shape_(std::move(shape))
+	, strides_(std::move(strides))
+{ }
+
+template <typename ValueType>
+size_t BasicTensorView<ValueType>::size() const noexcept
+{
+	return std::accumulate(
+		shape_.begin(), shape_.end(), size_t(1), [](const auto current, const auto dim) { return current * dim; });
+}
+
+template <typename ValueType>
+bool BasicTensorView<ValueType>::isContiguous() const noexcept
+{
+	size_t expectedStride = 1;
+	for(size_t dim = shape_.size() - 1; dim < shape_.size(); dim--)
+	{
+		// the stride of a single-element dimension is never used
+		if((shape_[dim] != 1) && (strides_[dim] != expectedStride))
+		{
+			return false;
+		}
+
+		expectedStride *= shape_[dim];
+	}
+
+	return true;
+}
+
+template <typename ValueType>
+ValueType BasicTensorView<ValueType>::at(const std::vector<size_t>& indices) const
+{
+	if(indices.size() != shape_.size())
+	{
+		throw std::out_of_range(fmt::format(
+			"Cannot access element of view with shape '{}' using indices '{}'.", stringifyVector(shape_), stringifyVector(indices)));
+	}
+
+	size_t offset = 0;
+	for(size_t dim = 0; dim < shape_.size(); dim++)
+	{
+		if(indices[dim] >= shape_[dim])
+		{
+			throw std::out_of_range(fmt::format("Index {} is out of range for dimension {} of view with shape '{}'.",
+												indices[dim],
+												dim,
+												stringifyVector(shape_)));
+		}
+
+		offset += indices[dim] * strides_[dim];
+	}
+
+	return data_[offset];
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::transposed() const
+{
+	if(shape_.size() < 2)
+	{
+		throw std::runtime_error(
+			fmt::format("Cannot transpose view with shape '{}' - at least 2 dimensions are required.", stringifyVector(shape_)));
+	}
+
+	auto shape = shape_;
+	auto strides = strides_;
+
+	std::swap(shape[shape.size() - 1], shape[shape.size() - 2]);
+	std::swap(strides[strides.size() - 1], strides[strides.size() - 2]);
+
+	return BasicTensorView(storage_, data_, std::move(shape), std::move(strides));
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::permuted(const std::vector<size_t>& axes) const
+{
+	std::vector<size_t> sortedAxes(axes);
+	std::sort(sortedAxes.begin(), sortedAxes.end());
+
+	std::vector<size_t> identity(shape_.size());
+	std::iota(identity.begin(), identity.end(), size_t(0));
+
+	if(sortedAxes != identity)
+	{
+		throw std::out_of_range(fmt::format(
+			"Axes '{}' are not a permutation of dimensions of view with shape '{}'.", stringifyVector(axes), stringifyVector(shape_)));
+	}
+
+	std::vector<size_t> shape;
+	std::vector<size_t> strides;
+
+	for(const auto axis : axes)
+	{
+		shape.push_back(shape_[axis]);
+		strides.push_back(strides_[axis]);
+	}
+
+	return BasicTensorView(storage_, data_, std::move(shape), std::move(strides));
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::sliced(const size_t axis, const size_t begin, const size_t end) const
+{
+	_checkAxis(axis, shape_.size());
+
+	if((begin >= end) || (end > shape_[axis]))
+	{
+		throw std::out_of_range(fmt::format(
+			"Cannot slice range [{}, {}) along dimension {} of view with shape '{}'.", begin, end, axis, stringifyVector(shape_)));
+	}
+
+	auto shape = shape_;
+	shape[axis] = end - begin;
+
+	return BasicTensorView(storage_, data_ + begin * strides_[axis], std::move(shape), strides_);
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::squeezed(const size_t axis) const
+{
+	_checkAxis(axis, shape_.size());
+
+	if(shape_[axis] != 1)
+	{
+		throw std::runtime_error(fmt::format(
+			"Cannot squeeze dimension {} of view with shape '{}' - its size is not 1.", axis, stringifyVector(shape_)));
+	}
+
+	auto shape = shape_;
+	auto strides = strides_;
+
+	shape.erase(std::next(shape.begin(), static_cast<ptrdiff_t>(axis)));
+	strides.erase(std::next(strides.begin(), static_cast<ptrdiff_t>(axis)));
+
+	return BasicTensorView(storage_, data_, std::move(shape), std::move(strides));
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::unsqueezed(const size_t axis) const
+{
+	_checkAxis(axis, shape_.size() + 1);
+
+	auto shape = shape_;
+	auto strides = strides_;
+
+	shape.insert(std::next(shape.begin(), static_cast<ptrdiff_t>(axis)), 1);
+	strides.insert(std::next(strides.begin(), static_cast<ptrdiff_t>(axis)), 0);
+
+	return BasicTensorView(storage_, data_, std::move(shape), std::move(strides));
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::broadcastedTo(const std::vector<size_t>& shape) const
+{
+	auto throwInformative = [this, &shape]() {
+		throw std::runtime_error(fmt::format(
+			"Cannot broadcast view with shape '{}' to shape '{}'.", stringifyVector(shape_), stringifyVector(shape)));
+	};
+
+	if(shape.size() < shape_.size())
+	{
+		throwInformative();
+	}
+
+	const size_t padding = shape.size() - shape_.size();
+
+	// the padded dimensions are stretched as well
+	std::vector<size_t> strides(shape.size(), 0);
+
+	for(size_t dim = 0; dim < shape_.size(); dim++)
+	{
+		if(shape_[dim] == shape[padding + dim])
+		{
+			strides[padding + dim] = strides_[dim];
+		}
+		else if(shape_[dim] != 1)
+		{
+			throwInformative();
+		}
+	}
+
+	return BasicTensorView(storage_, data_, shape, std::move(strides));
+}
+
+template <typename ValueType>
+BasicTensorView<ValueType> BasicTensorView<ValueType>::reshaped(const std::vector<size_t>& shape) const
+{
+	const size_t newSize =
+		std::accumulate(shape.begin(), shape.end(), size_t(1), [](const auto current, const auto dim) { return current * dim; });
+
+	if(newSize != size())
+	{
+		throw std::out_of_range(fmt::format(
+			"Cannot reshape view with shape '{}' to shape '{}'.", stringifyVector(shape_), stringifyVector(shape)));
+	}
+
+	if(isContiguous())
+	{
+		return BasicTensorView(storage_, data_, shape, computeContiguousStrides(shape));
+	}
+
+	auto tensor = contiguous();
+	tensor.reshape(shape);
+
+	return BasicTensorView(tensor);
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::contiguous() const
+{
+	BasicTensor<ValueType> tensor(shape_);
+
+	// the second operand of the layout is unused and given zero strides, so that it never prevents merging
+	const auto layout = collapseBroadcastLayout(shape_, strides_, std::vector<size_t>(shape_.size(), 0));
+
+	forEachBroadcastRow(layout,
+						data_,
+						data_,
+						tensor.data_,
+						[](const size_t length,
+						   const ValueType* source,
+						   const size_t sourceStride,
+						   const ValueType* /*unused*/,
+						   const size_t /*unused*/,
+						   ValueType* destination) {
+							for(size_t pos = 0; pos < length; pos++)
+							{
+								destination[pos] = source[pos * sourceStride];
+							}
+						});
+
+	return tensor;
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::operator+(const BasicTensorView& other) const
+{
+	return TensorOperationsImpl<ValueType>::addTensors(*this, other);
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::operator-(const BasicTensorView& other) const
+{
+	return TensorOperationsImpl<ValueType>::subtractTensors(*this, other);
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::operator*(const BasicTensorView& other) const
+{
+	return TensorOperationsImpl<ValueType>::multiplyTensors(*this, other);
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::operator/(const BasicTensorView& other) const
+{
+	return TensorOperationsImpl<ValueType>::divideTensors(*this, other);
+}
+
+// NOLINTBEGIN
+template <typename ValueType>
+BasicTensor<ValueType> BasicTensorView<ValueType>::matmul(const BasicTensorView& other) const
+{
+
+	// for clean error throwing with additional info about shapes
+	auto throwInformative = [this, &other](const std::string& message) {
+		throw std::runtime_error(fmt::format("Cannot perform matrix multiplication for shapes '{}' and '{}' - {}",
+											 stringifyVector(shape_),
+											 stringifyVector(other.shape_),
+											 message));
+	};
+
+	// checking if first tensor can be padded to nDims >= 2
+	if(other.shape_.size() < 2)
+	{
+		throwInformative("Cannot obtain last but one dimension of the second tensor");
+	}
+
+	// for padding tensors shapes
+	const size_t biggerSize = std::max(shape_.size(), other.shape_.size());
+
+	// padded shapes and strides for easier operating
+	std::vector<size_t> paddedShapeFirst(biggerSize, 1);
+	std::vector<size_t> paddedShapeSecond(biggerSize, 1);
+	std::vector<size_t> paddedStridesFirst(biggerSize, 0);
+	std::vector<size_t> paddedStridesSecond(biggerSize, 0);
+
+	std::copy(
+		shape_.cbegin(), shape_.cend(), std::next(paddedShapeFirst.begin(), static_cast<ptrdiff_t>(biggerSize - shape_.size())));
+	std::copy(strides_.cbegin(),
+			  strides_.cend(),
+			  std::next(paddedStridesFirst.begin(), static_cast<ptrdiff_t>(biggerSize - shape_.size())));
+
+	std::copy(other.shape_.cbegin(),
+			  other.shape_.cend(),
+			  std::next(paddedShapeSecond.begin(), static_cast<ptrdiff_t>(biggerSize - other.shape_.size())));
+	std::copy(other.strides_.cbegin(),
+			  other.strides_.cend(),
+			  std::next(paddedStridesSecond.begin(), static_cast<ptrdiff_t>(biggerSize - other.shape_.size())));
+
+	// checking matmul conditions
+	if(paddedShapeFirst[biggerSize - 1] != paddedShapeSecond[biggerSize - 2])
+	{
+		throwInformative("Last two dimensions are incompatible");
+	}
+
+	for(size_t i = 0; i < biggerSize - 2; i++)
+	{
+		if((paddedShapeFirst[i] != paddedShapeSecond[i]) && (paddedShapeFirst[i] != 1) && (paddedShapeSecond[i] != 1))
+		{
+			throwInformative("shapes are incompatible");
+		}
+	}
+
+	std::vector<size_t> retShape(biggerSize);
+	retShape[biggerSize - 2] = paddedShapeFirst[biggerSize - 2];
+	retShape[biggerSize - 1] = paddedShapeSecond[biggerSize - 1];
+
+	for(size_t i = 0; i < biggerSize - 2; i++)
+	{
+		retShape[i] = paddedShapeFirst[i] == 1 ? paddedShapeSecond[i] : paddedShapeFirst[i];
+	}
+
+	BasicTensor<ValueType> resultTensor(retShape);
+
+	const size_t nRows = retShape[biggerSize - 2];
+	const size_t nCols = retShape[biggerSize - 1];
+	const size_t adjacentDimension = paddedShapeFirst[biggerSize - 1];
+	const size_t frameLength = nRows * nCols;
+
+	// distances between consecutive frames along each batch dimension, zero for the broadcast ones
+	std::vector<size_t> firstFrameStrides(biggerSize - 2, 0);
+	std::vector<size_t> secondFrameStrides(biggerSize - 2, 0);
+
+	for(size_t i = 0; i < biggerSize - 2; i++)
+	{
+		firstFrameStrides[i] = paddedShapeFirst[i] > 1 ? paddedStridesFirst[i] : 0;
+		secondFrameStrides[i] = paddedShapeSecond[i] > 1 ? paddedStridesSecond[i] : 0;
+	}
+
+	// offsets of the consecutive frames, collected first so that the frames can be multiplied concurrently
+	std::vector<FrameOffsets> frameOffsets;
+	frameOffsets.reserve(resultTensor.length_ / frameLength);
+
+	size_t firstOffset = 0;
+	size_t secondOffset = 0;
+	std::vector<size_t> treePath(biggerSize - 2, 0);
+
+	for(size_t resultOffset = 0; resultOffset < resultTensor.length_; resultOffset += frameLength)
+	{
+		frameOffsets.push_back({firstOffset, secondOffset, resultOffset});
+
+		// tells which dimension of the tree path should be incremented
+		for(size_t i = biggerSize - 3; i < biggerSize - 2; i--)
+		{
+			treePath[i]++;
+			firstOffset += firstFrameStrides[i];
+			secondOffset += secondFrameStrides[i];
+
+			if(treePath[i] < retShape[i])
+			{
+				break;
+			}
+
+			firstOffset -= treePath[i] * firstFrameStrides[i];
+			secondOffset -= treePath[i] * secondFrameStrides[i];
+			treePath[i] = 0;
+		}
+	}
+
+	// transposed operands are handled by the frames' strides
+	MatmulImpl<ValueType>::multiplyFrames(nRows,
+										  nCols,
+										  adjacentDimension,
+										  {data_, paddedStridesFirst[biggerSize - 2], paddedStridesFirst[biggerSize - 1]},
+										  {other.data_, paddedStridesSecond[biggerSize - 2], paddedStridesSecond[biggerSize - 1]},
+										  {resultTensor.data_, nCols},
+										  frameOffsets);
+
+	return resultTensor;
+}
+// NOLINTEND
+
+template <typename ValueType>
+void BasicTensorView<ValueType>::_checkAxis(const size_t axis, const size_t nDimensions) const
+{
+	if(axis >= nDimensions)
+	{
+		throw std::out_of_range(
+			fmt::format("Axis {} is out of range for view with shape '{}'.", axis, stringifyVector(shape_)));
+	}
+}
+
+} // namespace mlCore
@@ -0,0 +1,148 @@
+#include <MLCore/BroadcastingImpl.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include <fmt/format.h>
+
+#include <LoggingLib/LoggingLib.hpp>
+#include <MLCore/Utilities.h>
+
+namespace mlCore
+{
+namespace
+{
+/**
+ * @brief Checks if the shapes of two tensors can be stretched to perform the broadcast operation 
+ * 
+ * @param shape1 
+ * @param shape2 
+ */
+void checkShapesForBroadcasting(const std::vector<size_t>& shape1, const std::vector<size_t>& shape2)
+{
+	// checking if the rules of broadcasting are not breached
+	for(auto [leftShapeIter, rightShapeIter] = std::tuple{shape1.crbegin(), shape2.crbegin()};
+		(leftShapeIter != shape1.crend()) && (rightShapeIter != shape2.crend());
+		leftShapeIter++, rightShapeIter++)
+	{
+		if((*leftShapeIter != 1) && (*rightShapeIter != 1) && (*leftShapeIter != *rightShapeIter))
+		{
+			LOG_ERROR("TensorOperations",
+					  fmt::format("Cannot perform broadcasting operation on tensors with invalid shapes: '{}' '{}'.",
+								  stringifyVector(shape1),
+								  stringifyVector(shape2)));
+		}
+	}
+}
+
+/**
+ * @brief Fills tensor's shape from left side with given value
+ * 
+ * @param shape Shape to be filled
+ * @param biggerSize Size of the result tensor. If less than shape.size(), no padding is added
+ * @param paddingVal Value to pad the shape with
+ * @return Padded vector
+ */
+std::vector<size_t> padShapeFromLeft(const std::vector<size_t>& shape, const size_t biggerSize, const size_t paddingVal = 1)
+{
+	std::vector<size_t> paddedShape(biggerSize, paddingVal);
+
+	std::copy(shape.cbegin(), shape.cend(), std::next(paddedShape.begin(), static_cast<ptrdiff_t>(biggerSize - shape.size())));
+
+	return paddedShape;
+}
+
+std::vector<size_t> deduceBroadcastedShape(const std::vector<size_t>& paddedShape1, const std::vector<size_t>& paddedShape2)
+{
+
+	std::vector<size_t> retShape(paddedShape1.size());
+	for(size_t shapePos = 0; shapePos < paddedShape1.size(); shapePos++)
+	{
+		// filling new shape according to dimension that can be stretched
+		retShape[shapePos] = paddedShape1[shapePos] == 1 ? paddedShape2[shapePos] : paddedShape1[shapePos];
+	}
+
+	return retShape;
+}
+} // namespace
+
+std::vector<size_t> broadcastShapes(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape)
+{
+	checkShapesForBroadcasting(lhsShape, rhsShape);
+
+	const auto biggerSize = std::max(lhsShape.size(), rhsShape.size());
+
+	return deduceBroadcastedShape(padShapeFromLeft(lhsShape, biggerSize), padShapeFromLeft(rhsShape, biggerSize));
+}
+
+std::vector<size_t> computeBroadcastStrides(const std::vector<size_t>& shape, const std::vector<size_t>& broadcastedShape)
+{
+	std::vector<size_t> strides(broadcastedShape.size(), 0);
+
+	const size_t padding = broadcastedShape.size() - shape.size();
+
+	size_t stride = 1;
+	for(size_t dim = shape.size() - 1; dim < shape.size(); dim--)
+	{
+		strides[padding + dim] = shape[dim] == 1 ? 0 : stride;
+		stride *= shape[dim];
+	}
+
+	return strides;
+}
+
+std::vector<size_t> computeBroadcastStrides(const std::vector<size_t>& shape,
+											const std::vector<size_t>& strides,
+											const std::vector<size_t>& broadcastedShape)
+{
+	std::vector<size_t> broadcastStrides(broadcastedShape.size(), 0);
+
+	const size_t padding = broadcastedShape.size() - shape.size();
+
+	for(size_t dim = 0; dim < shape.size(); dim++)
+	{
+		broadcastStrides[padding + dim] = shape[dim] == 1 ? 0 : strides[dim];
+	}
+
+	return broadcastStrides;
+}
+
+BroadcastLayout collapseBroadcastLayout(const std::vector<size_t>& shape,
+										const std::vector<size_t>& lhsStrides,
+										const std::vector<size_t>& rhsStrides)
+{
+	BroadcastLayout layout{};
+
+	for(size_t dim = 0; dim < shape.size(); dim++)
+	{
+		if(shape[dim] == 1)
+		{
+			continue;
+		}
+
+		// the previous dimension can be merged if stepping over it equals stepping over the whole current one
+		if(!layout.shape.empty() && (layout.lhsStrides.back() == lhsStrides[dim] * shape[dim]) &&
+		   (layout.rhsStrides.back() == rhsStrides[dim] * shape[dim]))
+		{
+			layout.shape.back() *= shape[dim];
+			layout.lhsStrides.back() = lhsStrides[dim];
+			layout.rhsStrides.back() = rhsStrides[dim];
+			continue;
+		}
+
+		layout.shape.push_back(shape[dim]);
+		layout.lhsStrides.push_back(lhsStrides[dim]);
+		layout.rhsStrides.push_back(rhsStrides[dim]);
+	}
+
+	if(layout.shape.empty())
+	{
+		layout.shape.push_back(1);
+		layout.lhsStrides.push_back(0);
+		layout.rhsStrides.push_back(0);
+	}
+
+	return layout;
+}
+
+} // namespace mlCore
@@ -0,0 +1,158 @@
+#include <MLCore/InstructionSet.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include <LoggingLib/LoggingLib.hpp>
+#include <MLCore/KernelDispatch.h>
+
+namespace mlCore
+{
+namespace
+{
+/// Reads the instruction set requested via environment, falling back to the detected one.
+InstructionSet chooseInitialInstructionSet()
+{
+	const auto detected = detectInstructionSet();
+
+	const char* const requested = std::getenv("MLCORE_INSTRUCTION_SET");
+
+	if(requested == nullptr)
+	{
+		return detected;
+	}
+
+	for(const auto instructionSet : getSupportedInstructionSets())
+	{
+		if(stringifyInstructionSet(instructionSet) == requested)
+		{
+			return instructionSet;
+		}
+	}
+
+	LOG_WARN("InstructionSet",
+			 "Instruction set '" << requested << "' requested by MLCORE_INSTRUCTION_SET is unknown or not supported. Using '"
+								 << stringifyInstructionSet(detected) << "'.");
+
+	return detected;
+}
+
+InstructionSet getInitialInstructionSet()
+{
+	static const InstructionSet initial = chooseInitialInstructionSet();
+	return initial;
+}
+
+std::atomic<InstructionSet>& getCurrentInstructionSet()
+{
+	static std::atomic<InstructionSet> current(getInitialInstructionSet());
+	return current;
+}
+} // namespace
+
+InstructionSet detectInstructionSet()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	// the builtins check also whether the operating system preserves the extended registers
+	__builtin_cpu_init();
+
+	if(__builtin_cpu_supports("avx512f"))
+	{
+		return InstructionSet::AVX512;
+	}
+
+	if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		return InstructionSet::AVX2;
+	}
+
+	if(__builtin_cpu_supports("sse2"))
+	{
+		return InstructionSet::SSE2;
+	}
+#endif
+
+	return InstructionSet::SCALAR;
+}
+
+std::vector<InstructionSet> getSupportedInstructionSets()
+{
+	std::vector<InstructionSet> supported;
+
+	for(const auto instructionSet : {InstructionSet::SCALAR, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512})
+	{
+		if(instructionSet <= detectInstructionSet())
+		{
+			supported.push_back(instructionSet);
+		}
+	}
+
+	return supported;
+}
+
+InstructionSet getInstructionSet()
+{
+	return getCurrentInstructionSet().load(std::memory_order_relaxed);
+}
+
+void setInstructionSet(const InstructionSet instructionSet)
+{
+	if(instructionSet > detectInstructionSet())
+	{
+		throw std::runtime_error(fmt::format("Cannot use instruction set '{}' - the host supports at most '{}'.",
+											 stringifyInstructionSet(instructionSet),
+											 stringifyInstructionSet(detectInstructionSet())));
+	}
+
+	getCurrentInstructionSet().store(instructionSet, std::memory_order_relaxed);
+}
+
+void resetInstructionSet()
+{
+	getCurrentInstructionSet().store(getInitialInstructionSet(), std::memory_order_relaxed);
+}
+
+std::string stringifyInstructionSet(const InstructionSet instructionSet)
+{
+	switch(instructionSet)
+	{
+	case InstructionSet::SCALAR:
+		return "scalar";
+	case InstructionSet::SSE2:
+		return "sse2";
+	case InstructionSet::AVX2:
+		return "avx2";
+	case InstructionSet::AVX512:
+		return "avx512";
+	}
+
+	return "unknown";
+}
+
+template <typename ValueType>
+const KernelTable<ValueType>& getKernelTable()
+{
+	switch(getInstructionSet())
+	{
+	case InstructionSet::AVX512:
+		return getAvx512KernelTable<ValueType>();
+	case InstructionSet::AVX2:
+		return getAvx2KernelTable<ValueType>();
+	case InstructionSet::SSE2:
+		return getSse2KernelTable<ValueType>();
+	case InstructionSet::SCALAR:
+		break;
+	}
+
+	return getScalarKernelTable<ValueType>();
+}
+
+template const KernelTable<double>& getKernelTable<double>();
+template const KernelTable<float>& getKernelTable<float>();
+template const KernelTable<int32_t>& getKernelTable<int32_t>();
+template const KernelTable<BFloat16>& getKernelTable<BFloat16>();
+
+} // namespace mlCore
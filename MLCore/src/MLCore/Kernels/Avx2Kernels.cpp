@@ -0,0 +1,165 @@
+#include <MLCore/KernelDispatch.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#	include <immintrin.h>
+
+// Kernels are compiled for AVX2 per function, so that the rest of the library keeps running on older hosts
+#	define MLCORE_KERNEL_TARGET __attribute__((target("avx2,fma")))
+
+namespace mlCore
+{
+namespace
+{
+/// AVX2 intrinsics for the supported element types. The micro-kernel's 6 rows x 2 vectors of accumulators,
+/// 2 loaded vectors and 1 broadcast fit in 16 ymm registers.
+template <typename ValueType>
+struct VectorOps;
+
+template <>
+struct VectorOps<double>
+{
+	using Type = __m256d;
+
+	static constexpr size_t kLanes = 4;
+	static constexpr size_t kMicroRows = 6;
+
+	MLCORE_KERNEL_TARGET static Type zero()
+	{
+		return _mm256_setzero_pd();
+	}
+
+	MLCORE_KERNEL_TARGET static Type load(const double* data)
+	{
+		return _mm256_loadu_pd(data);
+	}
+
+	MLCORE_KERNEL_TARGET static void store(double* data, const Type value)
+	{
+		_mm256_storeu_pd(data, value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type broadcast(const double value)
+	{
+		return _mm256_set1_pd(value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type add(const Type lhs, const Type rhs)
+	{
+		return _mm256_add_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type subtract(const Type lhs, const Type rhs)
+	{
+		return _mm256_sub_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiply(const Type lhs, const Type rhs)
+	{
+		return _mm256_mul_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type divide(const Type lhs, const Type rhs)
+	{
+		return _mm256_div_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiplyAdd(const Type lhs, const Type rhs, const Type acc)
+	{
+		return _mm256_fmadd_pd(lhs, rhs, acc);
+	}
+};
+
+template <>
+struct VectorOps<float>
+{
+	using Type = __m256;
+
+	static constexpr size_t kLanes = 8;
+	static constexpr size_t kMicroRows = 6;
+
+	MLCORE_KERNEL_TARGET static Type zero()
+	{
+		return _mm256_setzero_ps();
+	}
+
+	MLCORE_KERNEL_TARGET static Type load(const float* data)
+	{
+		return _mm256_loadu_ps(data);
+	}
+
+	MLCORE_KERNEL_TARGET static void store(float* data, const Type value)
+	{
+		_mm256_storeu_ps(data, value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type broadcast(const float value)
+	{
+		return _mm256_set1_ps(value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type add(const Type lhs, const Type rhs)
+	{
+		return _mm256_add_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type subtract(const Type lhs, const Type rhs)
+	{
+		return _mm256_sub_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiply(const Type lhs, const Type rhs)
+	{
+		return _mm256_mul_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type divide(const Type lhs, const Type rhs)
+	{
+		return _mm256_div_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiplyAdd(const Type lhs, const Type rhs, const Type acc)
+	{
+		return _mm256_fmadd_ps(lhs, rhs, acc);
+	}
+};
+} // namespace
+} // namespace mlCore
+
+#	include <MLCore/VectorizedKernels.hpp>
+
+namespace mlCore
+{
+template <>
+const KernelTable<double>& getAvx2KernelTable<double>()
+{
+	static const KernelTable<double> table = createVectorizedKernelTable<double>(InstructionSet::AVX2);
+	return table;
+}
+
+template <>
+const KernelTable<float>& getAvx2KernelTable<float>()
+{
+	static const KernelTable<float> table = createVectorizedKernelTable<float>(InstructionSet::AVX2);
+	return table;
+}
+} // namespace mlCore
+
+#else
+
+namespace mlCore
+{
+template <>
+const KernelTable<double>& getAvx2KernelTable<double>()
+{
+	return getScalarKernelTable<double>();
+}
+
+template <>
+const KernelTable<float>& getAvx2KernelTable<float>()
+{
+	return getScalarKernelTable<float>();
+}
+} // namespace mlCore
+
+#endif
@@ -0,0 +1,113 @@
+#include <MLCore/KernelDispatch.h>
+
+#include <functional>
+
+namespace mlCore
+{
+namespace
+{
+constexpr size_t kMicroRows = 4;
+constexpr size_t kMicroCols = 8;
+
+template <typename ValueType>
+void microKernel(const size_t depth,
+				 const ValueType* packedLhs,
+				 const ValueType* packedRhs,
+				 ValueType* const result,
+				 const size_t resultRowStride,
+				 const size_t nValidRows,
+				 const size_t nValidCols,
+				 const bool accumulate)
+{
+	// accumulators are kept local so that the compiler can hold them in registers
+	ValueType tile[kMicroRows][kMicroCols] = {};
+
+	for(size_t depthIter = 0; depthIter < depth; depthIter++)
+	{
+		for(size_t rowIter = 0; rowIter < kMicroRows; rowIter++)
+		{
+			const ValueType lhsValue = packedLhs[rowIter];
+
+			for(size_t colIter = 0; colIter < kMicroCols; colIter++)
+			{
+				tile[rowIter][colIter] += lhsValue * packedRhs[colIter];
+			}
+		}
+
+		packedLhs += kMicroRows;
+		packedRhs += kMicroCols;
+	}
+
+	for(size_t rowIter = 0; rowIter < nValidRows; rowIter++)
+	{
+		ValueType* const resultRow = result + rowIter * resultRowStride;
+
+		for(size_t colIter = 0; colIter < nValidCols; colIter++)
+		{
+			resultRow[colIter] = accumulate ? resultRow[colIter] + tile[rowIter][colIter] : tile[rowIter][colIter];
+		}
+	}
+}
+
+template <typename ValueType, typename Operation>
+void binaryKernel(const size_t length, const ValueType* const lhs, const ValueType* const rhs, ValueType* const result)
+{
+	for(size_t pos = 0; pos < length; pos++)
+	{
+		result[pos] = Operation()(lhs[pos], rhs[pos]);
+	}
+}
+
+template <typename ValueType, typename Operation>
+void binaryWithScalarKernel(const size_t length, const ValueType* const lhs, const ValueType rhs, ValueType* const result)
+{
+	for(size_t pos = 0; pos < length; pos++)
+	{
+		result[pos] = Operation()(lhs[pos], rhs);
+	}
+}
+
+template <typename ValueType, typename Operation>
+void scalarWithBinaryKernel(const size_t length, const ValueType lhs, const ValueType* const rhs, ValueType* const result)
+{
+	for(size_t pos = 0; pos < length; pos++)
+	{
+		result[pos] = Operation()(lhs, rhs[pos]);
+	}
+}
+
+template <typename ValueType>
+KernelTable<ValueType> createScalarKernelTable()
+{
+	return {.instructionSet = InstructionSet::SCALAR,
+			.microRows = kMicroRows,
+			.microCols = kMicroCols,
+			.microKernel = microKernel<ValueType>,
+			.binary = {binaryKernel<ValueType, std::plus<ValueType>>,
+					   binaryKernel<ValueType, std::minus<ValueType>>,
+					   binaryKernel<ValueType, std::multiplies<ValueType>>,
+					   binaryKernel<ValueType, std::divides<ValueType>>},
+			.binaryWithScalar = {binaryWithScalarKernel<ValueType, std::plus<ValueType>>,
+								 binaryWithScalarKernel<ValueType, std::minus<ValueType>>,
+								 binaryWithScalarKernel<ValueType, std::multiplies<ValueType>>,
+								 binaryWithScalarKernel<ValueType, std::divides<ValueType>>},
+			.scalarWithBinary = {scalarWithBinaryKernel<ValueType, std::plus<ValueType>>,
+								 scalarWithBinaryKernel<ValueType, std::minus<ValueType>>,
+								 scalarWithBinaryKernel<ValueType, std::multiplies<ValueType>>,
+								 scalarWithBinaryKernel<ValueType, std::divides<ValueType>>}};
+}
+} // namespace
+
+template <typename ValueType>
+const KernelTable<ValueType>& getScalarKernelTable()
+{
+	static const KernelTable<ValueType> table = createScalarKernelTable<ValueType>();
+	return table;
+}
+
+template const KernelTable<double>& getScalarKernelTable<double>();
+template const KernelTable<float>& getScalarKernelTable<float>();
+template const KernelTable<int32_t>& getScalarKernelTable<int32_t>();
+template const KernelTable<BFloat16>& getScalarKernelTable<BFloat16>();
+
+} // namespace mlCore
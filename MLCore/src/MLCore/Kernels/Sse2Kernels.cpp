@@ -0,0 +1,165 @@
+#include <MLCore/KernelDispatch.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#	include <immintrin.h>
+
+// Kernels are marked for SSE2 explicitly, as it is not the baseline of 32-bit builds
+#	define MLCORE_KERNEL_TARGET __attribute__((target("sse2")))
+
+namespace mlCore
+{
+namespace
+{
+/// SSE2 intrinsics for the supported element types. The micro-kernel's 4 rows x 2 vectors of accumulators,
+/// 2 loaded vectors and 1 broadcast fit in 16 xmm registers.
+template <typename ValueType>
+struct VectorOps;
+
+template <>
+struct VectorOps<double>
+{
+	using Type = __m128d;
+
+	static constexpr size_t kLanes = 2;
+	static constexpr size_t kMicroRows = 4;
+
+	MLCORE_KERNEL_TARGET static Type zero()
+	{
+		return _mm_setzero_pd();
+	}
+
+	MLCORE_KERNEL_TARGET static Type load(const double* data)
+	{
+		return _mm_loadu_pd(data);
+	}
+
+	MLCORE_KERNEL_TARGET static void store(double* data, const Type value)
+	{
+		_mm_storeu_pd(data, value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type broadcast(const double value)
+	{
+		return _mm_set1_pd(value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type add(const Type lhs, const Type rhs)
+	{
+		return _mm_add_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type subtract(const Type lhs, const Type rhs)
+	{
+		return _mm_sub_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiply(const Type lhs, const Type rhs)
+	{
+		return _mm_mul_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type divide(const Type lhs, const Type rhs)
+	{
+		return _mm_div_pd(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiplyAdd(const Type lhs, const Type rhs, const Type acc)
+	{
+		return _mm_add_pd(acc, _mm_mul_pd(lhs, rhs));
+	}
+};
+
+template <>
+struct VectorOps<float>
+{
+	using Type = __m128;
+
+	static constexpr size_t kLanes = 4;
+	static constexpr size_t kMicroRows = 4;
+
+	MLCORE_KERNEL_TARGET static Type zero()
+	{
+		return _mm_setzero_ps();
+	}
+
+	MLCORE_KERNEL_TARGET static Type load(const float* data)
+	{
+		return _mm_loadu_ps(data);
+	}
+
+	MLCORE_KERNEL_TARGET static void store(float* data, const Type value)
+	{
+		_mm_storeu_ps(data, value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type broadcast(const float value)
+	{
+		return _mm_set1_ps(value);
+	}
+
+	MLCORE_KERNEL_TARGET static Type add(const Type lhs, const Type rhs)
+	{
+		return _mm_add_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type subtract(const Type lhs, const Type rhs)
+	{
+		return _mm_sub_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiply(const Type lhs, const Type rhs)
+	{
+		return _mm_mul_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type divide(const Type lhs, const Type rhs)
+	{
+		return _mm_div_ps(lhs, rhs);
+	}
+
+	MLCORE_KERNEL_TARGET static Type multiplyAdd(const Type lhs, const Type rhs, const Type acc)
+	{
+		return _mm_add_ps(acc, _mm_mul_ps(lhs, rhs));
+	}
+};
+} // namespace
+} // namespace mlCore
+
+#	include <MLCore/VectorizedKernels.hpp>
+
+namespace mlCore
+{
+template <>
+const KernelTable<double>& getSse2KernelTable<double>()
+{
+	static const KernelTable<double> table = createVectorizedKernelTable<double>(InstructionSet::SSE2);
+	return table;
+}
+
+template <>
+const KernelTable<float>& getSse2KernelTable<float>()
+{
+	static const KernelTable<float> table = createVectorizedKernelTable<float>(InstructionSet::SSE2);
+	return table;
+}
+} // namespace mlCore
+
+#else
+
+namespace mlCore
+{
+template <>
+const KernelTable<double>& getSse2KernelTable<double>()
+{
+	return getScalarKernelTable<double>();
+}
+
+template <>
+const KernelTable<float>& getSse2KernelTable<float>()
+{
+	return getScalarKernelTable<float>();
+}
+} // namespace mlCore
+
+#endif
@@ -0,0 +1,355 @@
+#include <MLCore/MatmulImpl.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <MLCore/ParallelFor.h>
+
+namespace mlCore
+{
+namespace
+{
+/// Frames with fewer multiply-adds than this are computed without packing.
+constexpr size_t kSmallFrameThreshold = 32 * 32 * 32;
+
+/// Batches with fewer multiply-adds than this are computed on the calling thread only.
+constexpr size_t kParallelThreshold = 64 * 64 * 64;
+
+/// Returns packing buffer reused by consecutive multiplications performed on the calling thread.
+template <typename ValueType>
+ValueType* getPackingBuffer(std::vector<ValueType>& buffer, const size_t minSize)
+{
+	if(buffer.size() < minSize)
+	{
+		buffer.resize(minSize);
+	}
+
+	return buffer.data();
+}
+
+/**
+ * @brief Copies frames of a matrix to contiguous row-major float frames. Frames shared by several multiplications, e.g.
+ * broadcast ones, are copied once.
+ *
+ * @param nRows Number of rows of a frame.
+ * @param nCols Number of columns of a frame.
+ * @param source Matrix the frames are taken from.
+ * @param sourceOffsets Offsets of the consecutive frames within `source`.
+ * @param widened Buffer the frames are appended to.
+ * @return Offsets of the consecutive frames within `widened`.
+ */
+std::vector<size_t> widenFrames(const size_t nRows,
+								const size_t nCols,
+								const ConstMatrixFrame<BFloat16>& source,
+								const std::vector<size_t>& sourceOffsets,
+								std::vector<float>& widened)
+{
+	std::unordered_map<size_t, size_t> widenedOffsets;
+	std::vector<size_t> offsets;
+
+	for(const auto sourceOffset : sourceOffsets)
+	{
+		const auto [offsetIter, isNew] = widenedOffsets.try_emplace(sourceOffset, widened.size());
+
+		if(isNew)
+		{
+			for(size_t rowIter = 0; rowIter < nRows; rowIter++)
+			{
+				for(size_t colIter = 0; colIter < nCols; colIter++)
+				{
+					widened.push_back(
+						static_cast<float>(source.data[sourceOffset + rowIter * source.rowStride + colIter * source.colStride]));
+				}
+			}
+		}
+
+		offsets.push_back(offsetIter->second);
+	}
+
+	return offsets;
+}
+} // namespace
+
+template <>
+void MatmulImpl<BFloat16>::multiplyFrames(const size_t nRows,
+										  const size_t nCols,
+										  const size_t adjacentDim,
+										  const ConstMatrixFrame<BFloat16>& lhs,
+										  const ConstMatrixFrame<BFloat16>& rhs,
+										  const MatrixFrame<BFloat16>& result,
+										  const std::vector<FrameOffsets>& frameOffsets)
+{
+	if(frameOffsets.empty() || (nRows == 0) || (nCols == 0))
+	{
+		return;
+	}
+
+	std::vector<size_t> lhsOffsets;
+	std::vector<size_t> rhsOffsets;
+
+	for(const auto& offsets : frameOffsets)
+	{
+		lhsOffsets.push_back(offsets.lhs);
+		rhsOffsets.push_back(offsets.rhs);
+	}
+
+	std::vector<float> widenedLhs;
+	std::vector<float> widenedRhs;
+
+	const auto widenedLhsOffsets = widenFrames(nRows, adjacentDim, lhs, lhsOffsets, widenedLhs);
+	const auto widenedRhsOffsets = widenFrames(adjacentDim, nCols, rhs, rhsOffsets, widenedRhs);
+
+	std::vector<float> widenedResult(frameOffsets.size() * nRows * nCols);
+	std::vector<FrameOffsets> widenedFrameOffsets;
+
+	for(size_t frameIter = 0; frameIter < frameOffsets.size(); frameIter++)
+	{
+		widenedFrameOffsets.push_back({widenedLhsOffsets[frameIter], widenedRhsOffsets[frameIter], frameIter * nRows * nCols});
+	}
+
+	MatmulImpl<float>::multiplyFrames(nRows,
+									  nCols,
+									  adjacentDim,
+									  {widenedLhs.data(), adjacentDim, 1},
+									  {widenedRhs.data(), nCols, 1},
+									  {widenedResult.data(), nCols},
+									  widenedFrameOffsets);
+
+	for(size_t frameIter = 0; frameIter < frameOffsets.size(); frameIter++)
+	{
+		for(size_t rowIter = 0; rowIter < nRows; rowIter++)
+		{
+			const float* const source = widenedResult.data() + (frameIter * nRows + rowIter) * nCols;
+			BFloat16* const target = result.data + frameOffsets[frameIter].result + rowIter * result.rowStride;
+
+			std::copy(source, source + nCols, target);
+		}
+	}
+}
+
+template class MatmulImpl<double>;
+template class MatmulImpl<float>;
+template class MatmulImpl<int32_t>;
+template class MatmulImpl<BFloat16>;
+
+template <typename ValueType>
+void MatmulImpl<ValueType>::multiplyFrames(const size_t nRows,
+										   const size_t nCols,
+										   const size_t adjacentDim,
+										   const ConstMatrixFrame<ValueType>& lhs,
+										   const ConstMatrixFrame<ValueType>& rhs,
+										   const MatrixFrame<ValueType>& result,
+										   const std::vector<FrameOffsets>& frameOffsets)
+{
+	if(frameOffsets.empty() || (nRows == 0) || (nCols == 0))
+	{
+		return;
+	}
+
+	const auto& kernels = getKernelTable<ValueType>();
+
+	// the path is chosen for the whole frame, so that it does not depend on the tiling
+	const bool isSmallFrame = nRows * nCols * adjacentDim < kSmallFrameThreshold;
+
+	// tiles of big frames are aligned to the row blocks, so that no additional partial micro-tiles are created
+	const size_t rowsTile = isSmallFrame ? nRows : (kRowsBlock / kernels.microRows) * kernels.microRows;
+	const size_t colsTile = isSmallFrame ? nCols : kColsTile;
+
+	const size_t nRowsTiles = (nRows + rowsTile - 1) / rowsTile;
+	const size_t nColsTiles = (nCols + colsTile - 1) / colsTile;
+	const size_t nTilesPerFrame = nRowsTiles * nColsTiles;
+
+	auto computeTile = [&](const size_t taskIdx) {
+		const auto& offsets = frameOffsets[taskIdx / nTilesPerFrame];
+		const size_t rowsTileBegin = ((taskIdx % nTilesPerFrame) / nColsTiles) * rowsTile;
+		const size_t colsTileBegin = ((taskIdx % nTilesPerFrame) % nColsTiles) * colsTile;
+
+		const size_t tileRows = std::min(rowsTile, nRows - rowsTileBegin);
+		const size_t tileCols = std::min(colsTile, nCols - colsTileBegin);
+
+		const ConstMatrixFrame<ValueType> lhsTile{
+			lhs.data + offsets.lhs + rowsTileBegin * lhs.rowStride, lhs.rowStride, lhs.colStride};
+		const ConstMatrixFrame<ValueType> rhsTile{
+			rhs.data + offsets.rhs + colsTileBegin * rhs.colStride, rhs.rowStride, rhs.colStride};
+		const MatrixFrame<ValueType> resultTile{
+			result.data + offsets.result + rowsTileBegin * result.rowStride + colsTileBegin, result.rowStride};
+
+		if(isSmallFrame)
+		{
+			_multiplySmallFrames(tileRows, tileCols, adjacentDim, lhsTile, rhsTile, resultTile);
+		}
+		else
+		{
+			_multiplyBlockedFrames(tileRows, tileCols, adjacentDim, lhsTile, rhsTile, resultTile, kernels);
+		}
+	};
+
+	const size_t nTasks = frameOffsets.size() * nTilesPerFrame;
+
+	if(frameOffsets.size() * nRows * nCols * adjacentDim < kParallelThreshold)
+	{
+		for(size_t taskIdx = 0; taskIdx < nTasks; taskIdx++)
+		{
+			computeTile(taskIdx);
+		}
+
+		return;
+	}
+
+	parallelFor(nTasks, computeTile);
+}
+
+template <typename ValueType>
+void MatmulImpl<ValueType>::_multiplyBlockedFrames(const size_t nRows,
+												   const size_t nCols,
+												   const size_t adjacentDim,
+												   const ConstMatrixFrame<ValueType>& lhs,
+												   const ConstMatrixFrame<ValueType>& rhs,
+												   const MatrixFrame<ValueType>& result,
+												   const KernelTable<ValueType>& kernels)
+{
+	const size_t microRows = kernels.microRows;
+	const size_t microCols = kernels.microCols;
+
+	// row blocks are aligned to the micro-kernel's tile height
+	const size_t rowsBlockLimit = (kRowsBlock / microRows) * microRows;
+
+	thread_local std::vector<ValueType> lhsBuffer;
+	thread_local std::vector<ValueType> rhsBuffer;
+
+	ValueType* const packedLhs = getPackingBuffer(lhsBuffer, rowsBlockLimit * kDepthBlock);
+	ValueType* const packedRhs = getPackingBuffer(rhsBuffer, kDepthBlock * kColsBlock);
+
+	// L3 level - block of right operand's columns
+	for(size_t colsBlockBegin = 0; colsBlockBegin < nCols; colsBlockBegin += kColsBlock)
+	{
+		const size_t colsBlock = std::min(kColsBlock, nCols - colsBlockBegin);
+
+		// shared dimension split so that the packed panels stay in lower cache levels
+		for(size_t depthBlockBegin = 0; depthBlockBegin < adjacentDim; depthBlockBegin += kDepthBlock)
+		{
+			const size_t depthBlock = std::min(kDepthBlock, adjacentDim - depthBlockBegin);
+
+			const ConstMatrixFrame<ValueType> rhsBlock{
+				rhs.data + depthBlockBegin * rhs.rowStride + colsBlockBegin * rhs.colStride, rhs.rowStride, rhs.colStride};
+
+			_packRhs(depthBlock, colsBlock, microCols, rhsBlock, packedRhs);
+
+			// L2 level - block of left operand's rows
+			for(size_t rowsBlockBegin = 0; rowsBlockBegin < nRows; rowsBlockBegin += rowsBlockLimit)
+			{
+				const size_t rowsBlock = std::min(rowsBlockLimit, nRows - rowsBlockBegin);
+
+				const ConstMatrixFrame<ValueType> lhsBlock{
+					lhs.data + rowsBlockBegin * lhs.rowStride + depthBlockBegin * lhs.colStride, lhs.rowStride, lhs.colStride};
+
+				_packLhs(rowsBlock, depthBlock, microRows, lhsBlock, packedLhs);
+
+				// L1 level - single panel of the right operand against consecutive panels of the left one
+				for(size_t microColsBegin = 0; microColsBegin < colsBlock; microColsBegin += microCols)
+				{
+					for(size_t microRowsBegin = 0; microRowsBegin < rowsBlock; microRowsBegin += microRows)
+					{
+						ValueType* const resultTile = result.data + (rowsBlockBegin + microRowsBegin) * result.rowStride +
+													  colsBlockBegin + microColsBegin;
+
+						kernels.microKernel(depthBlock,
+											packedLhs + microRowsBegin * depthBlock,
+											packedRhs + microColsBegin * depthBlock,
+											resultTile,
+											result.rowStride,
+											std::min(microRows, rowsBlock - microRowsBegin),
+											std::min(microCols, colsBlock - microColsBegin),
+											depthBlockBegin > 0);
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename ValueType>
+void MatmulImpl<ValueType>::_multiplySmallFrames(const size_t nRows,
+												 const size_t nCols,
+												 const size_t adjacentDim,
+												 const ConstMatrixFrame<ValueType>& lhs,
+												 const ConstMatrixFrame<ValueType>& rhs,
+												 const MatrixFrame<ValueType>& result)
+{
+	// row-by-row accumulation so that the right operand and the result are walked along their rows
+	for(size_t rowIter = 0; rowIter < nRows; rowIter++)
+	{
+		ValueType* const resultRow = result.data + rowIter * result.rowStride;
+
+		std::fill(resultRow, resultRow + nCols, ValueType(0));
+
+		for(size_t mulIter = 0; mulIter < adjacentDim; mulIter++)
+		{
+			const ValueType lhsValue = lhs.data[rowIter * lhs.rowStride + mulIter * lhs.colStride];
+			const ValueType* const rhsRow = rhs.data + mulIter * rhs.rowStride;
+
+			for(size_t colIter = 0; colIter < nCols; colIter++)
+			{
+				resultRow[colIter] += lhsValue * rhsRow[colIter * rhs.colStride];
+			}
+		}
+	}
+}
+
+template <typename ValueType>
+void MatmulImpl<ValueType>::_packLhs(const size_t nRows,
+									 const size_t depth,
+									 const size_t microRows,
+									 const ConstMatrixFrame<ValueType>& lhs,
+									 ValueType* packed)
+{
+	for(size_t panelBegin = 0; panelBegin < nRows; panelBegin += microRows)
+	{
+		const size_t panelRows = std::min(microRows, nRows - panelBegin);
+
+		for(size_t depthIter = 0; depthIter < depth; depthIter++)
+		{
+			const ValueType* const source = lhs.data + panelBegin * lhs.rowStride + depthIter * lhs.colStride;
+
+			size_t rowIter = 0;
+			for(; rowIter < panelRows; rowIter++)
+			{
+				*packed++ = source[rowIter * lhs.rowStride];
+			}
+			for(; rowIter < microRows; rowIter++)
+			{
+				*packed++ = ValueType(0);
+			}
+		}
+	}
+}
+
+template <typename ValueType>
+void MatmulImpl<ValueType>::_packRhs(const size_t depth,
+									 const size_t nCols,
+									 const size_t microCols,
+									 const ConstMatrixFrame<ValueType>& rhs,
+									 ValueType* packed)
+{
+	for(size_t panelBegin = 0; panelBegin < nCols; panelBegin += microCols)
+	{
+		const size_t panelCols = std::min(microCols, nCols - panelBegin);
+
+		for(size_t depthIter = 0; depthIter < depth; depthIter++)
+		{
+			const ValueType* const source = rhs.data + depthIter * rhs.rowStride + panelBegin * rhs.colStride;
+
+			size_t colIter = 0;
+			for(; colIter < panelCols; colIter++)
+			{
+				*packed++ = source[colIter * rhs.colStride];
+			}
+			for(; colIter < microCols; colIter++)
+			{
+				*packed++ = ValueType(0);
+			}
+		}
+	}
+}
+
+} // namespace mlCore
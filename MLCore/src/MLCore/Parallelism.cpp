@@ -0,0 +1,162 @@
+#include <MLCore/Parallelism.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include <MLCore/Allocation.h>
+#include <MLCore/ParallelFor.h>
+
+namespace mlCore
+{
+namespace
+{
+std::mutex globalThreadPoolMutex;
+std::shared_ptr<utilities::ThreadPool> globalThreadPool;
+
+thread_local std::shared_ptr<utilities::ThreadPool> scopedThreadPool;
+thread_local bool hasScopedThreadPool = false;
+
+/// State of a single parallelFor call, shared between the caller and the helping jobs.
+struct ParallelForState
+{
+	ParallelForState(const size_t nTasks, std::function<void(size_t)> task)
+		: nTasks(nTasks)
+		, task(std::move(task))
+	{ }
+
+	const size_t nTasks;
+	const std::function<void(size_t)> task;
+
+	std::atomic<size_t> nextTask = 0;
+
+	std::mutex mutex{};
+	std::condition_variable allFinished{};
+	size_t nFinished = 0;
+	std::exception_ptr exception = nullptr;
+};
+
+/// Runs tasks of the parallelFor call until there are no unclaimed ones.
+void runParallelForTasks(ParallelForState& state)
+{
+	for(size_t taskIdx = state.nextTask++; taskIdx < state.nTasks; taskIdx = state.nextTask++)
+	{
+		std::exception_ptr exception = nullptr;
+
+		try
+		{
+			state.task(taskIdx);
+		}
+		catch(...)
+		{
+			exception = std::current_exception();
+		}
+
+		std::unique_lock<std::mutex> lock(state.mutex);
+
+		if(exception && !state.exception)
+		{
+			state.exception = exception;
+		}
+
+		if(++state.nFinished == state.nTasks)
+		{
+			state.allFinished.notify_all();
+		}
+	}
+}
+} // namespace
+
+void setGlobalThreadPool(std::shared_ptr<utilities::ThreadPool> threadPool)
+{
+	std::unique_lock<std::mutex> lock(globalThreadPoolMutex);
+	globalThreadPool = std::move(threadPool);
+}
+
+std::shared_ptr<utilities::ThreadPool> getGlobalThreadPool()
+{
+	std::unique_lock<std::mutex> lock(globalThreadPoolMutex);
+	return globalThreadPool;
+}
+
+std::shared_ptr<utilities::ThreadPool> getCurrentThreadPool()
+{
+	if(hasScopedThreadPool)
+	{
+		return scopedThreadPool;
+	}
+
+	return getGlobalThreadPool();
+}
+
+ThreadPoolScope::ThreadPoolScope(std::shared_ptr<utilities::ThreadPool> threadPool)
+	: previousPool_(std::move(scopedThreadPool))
+	, hadPreviousPool_(hasScopedThreadPool)
+{
+	scopedThreadPool = std::move(threadPool);
+	hasScopedThreadPool = true;
+}
+
+ThreadPoolScope::~ThreadPoolScope()
+{
+	scopedThreadPool = std::move(previousPool_);
+	hasScopedThreadPool = hadPreviousPool_;
+}
+
+void parallelFor(const size_t nTasks, const std::function<void(size_t)>& task)
+{
+	const auto threadPool = getCurrentThreadPool();
+
+	if((nTasks <= 1) || !threadPool || !threadPool->isRunning() || (threadPool->size() == 0))
+	{
+		for(size_t taskIdx = 0; taskIdx < nTasks; taskIdx++)
+		{
+			task(taskIdx);
+		}
+
+		return;
+	}
+
+	const auto state = std::make_shared<ParallelForState>(nTasks, task);
+
+	const size_t nHelpers = std::min(threadPool->size(), nTasks - 1);
+
+	// the helpers must not own the pool, otherwise it could be destroyed by its own worker - the pool is alive anyway
+	// as long as its jobs are being run
+	utilities::ThreadPool* const unownedThreadPool = threadPool.get();
+	const auto allocator = getCurrentAllocator();
+
+	for(size_t helperIdx = 0; helperIdx < nHelpers; helperIdx++)
+	{
+		try
+		{
+			// the helpers propagate the pool, so that nested calls split their work as well, and the allocator, so that
+			// the tasks' temporaries come from the same place as the caller's
+			threadPool->addJob([state, unownedThreadPool, allocator]() {
+				const std::shared_ptr<utilities::ThreadPool> threadPoolView(std::shared_ptr<utilities::ThreadPool>(), unownedThreadPool);
+				ThreadPoolScope scope(threadPoolView);
+				const AllocatorScope allocatorScope(allocator);
+				runParallelForTasks(*state);
+			});
+		}
+		catch(const std::runtime_error&)
+		{
+			// the pool has been terminated in the meantime - the remaining tasks are run by the caller
+			break;
+		}
+	}
+
+	runParallelForTasks(*state);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->allFinished.wait(lock, [&state]() { return state->nFinished == state->nTasks; });
+
+	if(state->exception)
+	{
+		std::rethrow_exception(state->exception);
+	}
+}
+
+} // namespace mlCore
@@ -0,0 +1,16 @@
+#include <MLCore/TensorExpressions.h>
+
+#include <MLCore/BroadcastingImpl.h>
+
+namespace mlCore::expressions::detail
+{
+std::vector<size_t> broadcastShapes(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape)
+{
+	return mlCore::broadcastShapes(lhsShape, rhsShape);
+}
+
+std::vector<size_t> computeStrides(const std::vector<size_t>& shape, const std::vector<size_t>& outputShape)
+{
+	return computeBroadcastStrides(shape, outputShape);
+}
+} // namespace mlCore::expressions::detail
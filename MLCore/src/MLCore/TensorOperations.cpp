@@ -5,23 +5,27 @@
 namespace mlCore
 {
 template class BasicTensorOperations<double>;
+template class BasicTensorOperations<float>;
+template class BasicTensorOperations<BFloat16>;
 
 template <typename ValueType>
 BasicTensor<ValueType> BasicTensorOperations<ValueType>::power(const BasicTensor<ValueType>& lhs,
 															   const BasicTensor<ValueType>& rhs)
 {
-	auto ret = lhs;
-	TensorOperationsImpl<ValueType>::powerInPlace(ret, rhs);
+	BasicTensor<ValueType> ret(TensorOperationsImpl<ValueType>::getBroadcastedShape(lhs.shape(), rhs.shape()));
+	TensorOperationsImpl<ValueType>::powerTensors(lhs, rhs, ret);
 	return ret;
 }
 
 template <typename ValueType>
 BasicTensor<ValueType> BasicTensorOperations<ValueType>::ln(const BasicTensor<ValueType>& arg)
 {
+	using Compute = typename ComputeType<ValueType>::Type;
+
 	auto ret = arg;
 	for(auto& val : ret)
 	{
-		val = std::log(val);
+		val = static_cast<ValueType>(std::log(static_cast<Compute>(val)));
 	}
 	return ret;
 }
@@ -32,7 +36,7 @@ BasicTensor<ValueType> BasicTensorOperations<ValueType>::relu(const BasicTensor<
 	auto ret = arg;
 	for(auto& val : ret)
 	{
-		val = val > 0 ? val : 0;
+		val = val > ValueType(0) ? val : ValueType(0);
 	}
 	return ret;
 }
@@ -40,10 +44,12 @@ BasicTensor<ValueType> BasicTensorOperations<ValueType>::relu(const BasicTensor<
 template <typename ValueType>
 BasicTensor<ValueType> BasicTensorOperations<ValueType>::sigmoid(const BasicTensor<ValueType>& arg)
 {
+	using Compute = typename ComputeType<ValueType>::Type;
+
 	auto ret = arg;
 	for(auto& val : ret)
 	{
-		val = 1.0 / (1.0 + std::pow(M_E, -val));
+		val = static_cast<ValueType>(Compute(1) / (Compute(1) + std::pow(static_cast<Compute>(M_E), -static_cast<Compute>(val))));
 	}
 	return ret;
 }
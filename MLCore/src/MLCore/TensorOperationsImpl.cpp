@@ -1,210 +1,299 @@
 #include <MLCore/TensorOperationsImpl.h>
 
 #include <cmath>
+#include <functional>
 
 #include <fmt/format.h>
 
+#include <MLCore/BroadcastingImpl.h>
+#include <MLCore/KernelDispatch.h>
 #include <MLCore/Utilities.h>
 
 // NOLINTBEGIN
 
-#define __SIMPLE_PLUS(a, b) a + b
-#define __SIMPLE_MINUS(a, b) a - b
-#define __SIMPLE_DIVIDE(a, b) a / b
-#define __SIMPLE_MULTIPLY(a, b) a* b
-
-// Computes operation between two tensors with same shape and assigns result to the left one
-#define COMPAT_SHAPES_OPERATION(lhs, rhs, oper)                                                                                  \
+// Computes `result = lhs op rhs` writing each element of the result exactly once. The result has to have the broadcasted
+// shape and may be one of the operands, since the kernels read each element before writing it
+#define TERNARY_TENSOR_OPERATION(lhs, rhs, result, operation, scalarOperation)                                                   \
+	checkResultShape(lhs.shape_, rhs.shape_, result.shape_);                                                                     \
+	result._detachStorage();                                                                                                     \
+                                                                                                                                 \
+	const auto& kernels = getKernelTable<ValueType>();                                                                           \
+                                                                                                                                 \
 	if(lhs.shape_ == rhs.shape_)                                                                                                 \
 	{                                                                                                                            \
-		for(size_t dataPos = 0; dataPos < lhs.length_; dataPos++)                                                                \
-		{                                                                                                                        \
-			lhs.data_[dataPos] = oper(lhs.data_[dataPos], rhs.data_[dataPos]);                                                   \
-		}                                                                                                                        \
+		kernels.getBinary(operation)(result.length_, lhs.data_, rhs.data_, result.data_);                                        \
 		return;                                                                                                                  \
-	}
-
-// Used when one of the tensors is scalar type and expensive broadcasting could be avoided
-#define OPERATION_WITH_SCALAR(lhs, rhs, oper)                                                                                    \
+	}                                                                                                                            \
+                                                                                                                                 \
 	if(rhs.shape_.empty())                                                                                                       \
 	{                                                                                                                            \
-		for(size_t dataPos = 0; dataPos < lhs.length_; dataPos++)                                                                \
-		{                                                                                                                        \
-			lhs.data_[dataPos] = oper(lhs.data_[dataPos], rhs.data_[0]);                                                         \
-		}                                                                                                                        \
+		kernels.getBinaryWithScalar(operation)(result.length_, lhs.data_, rhs.data_[0], result.data_);                           \
 		return;                                                                                                                  \
-	}
-
-// Computes the position of an element in tensor's payload
-#define COMPUTE_ELEMENT_POSITION(path, shape, positionName)                                                                      \
-	size_t positionName = 0;                                                                                                     \
-	{                                                                                                                            \
-		size_t offset = 1;                                                                                                       \
-		for(size_t i = path.size() - 1; i < path.size(); i--)                                                                    \
-		{                                                                                                                        \
-			positionName += offset * path[i];                                                                                    \
-			offset *= shape[i];                                                                                                  \
-		}                                                                                                                        \
-	}
-
-// Stretches a tensor and applies an operation
-#define STRETCH_TENSOR_TO_ANOTHER(dst, src, srcPaddedShape, oper)                                                                \
-	std::vector<size_t> dstTreePath(dst.nDimensions(), 0);                                                                       \
-	std::vector<size_t> srcTreePath(dst.nDimensions(), 0);                                                                       \
-                                                                                                                                 \
-	size_t elementsProcessed = 0;                                                                                                \
+	}                                                                                                                            \
                                                                                                                                  \
-	while(elementsProcessed < dst.length_)                                                                                       \
+	if(lhs.shape_.empty())                                                                                                       \
 	{                                                                                                                            \
-		COMPUTE_ELEMENT_POSITION(dstTreePath, dst.shape_, dstElemPos)                                                            \
-		COMPUTE_ELEMENT_POSITION(srcTreePath, srcPaddedShape, srcElemPos)                                                        \
-                                                                                                                                 \
-		dst.data_[dstElemPos] = oper(dst.data_[dstElemPos], src.data_[srcElemPos]);                                              \
-                                                                                                                                 \
-		elementsProcessed++;                                                                                                     \
-		for(size_t i = 0; i < dst.nDimensions(); i++)                                                                            \
-		{                                                                                                                        \
-			const size_t pathPos = dst.nDimensions() - 1 - i;                                                                    \
-                                                                                                                                 \
-			dstTreePath[pathPos]++;                                                                                              \
-                                                                                                                                 \
-			if(srcPaddedShape[pathPos] > 1)                                                                                      \
-			{                                                                                                                    \
-				srcTreePath[pathPos]++;                                                                                          \
-			}                                                                                                                    \
-                                                                                                                                 \
-			if(dstTreePath[pathPos] < dst.shape_[pathPos])                                                                       \
-			{                                                                                                                    \
-				break;                                                                                                           \
-			}                                                                                                                    \
+		kernels.getScalarWithBinary(operation)(result.length_, lhs.data_[0], rhs.data_, result.data_);                           \
+		return;                                                                                                                  \
+	}                                                                                                                            \
                                                                                                                                  \
-			dstTreePath[pathPos] = 0;                                                                                            \
-			srcTreePath[pathPos] = 0;                                                                                            \
-		}                                                                                                                        \
-	}
+	BROADCASTED_TERNARY_OPERATION(lhs, rhs, result, makeVectorizedInnerLoop<ValueType>(operation, scalarOperation))
 
-// Generic operation between tensors with incompatible shapes - result assigned to the left one
-#define BROADCASTED_TENSOR_OPERATION(lhs, rhs, oper)                                                                             \
-	checkShapesForBroadcasting(lhs.shape_, rhs.shape_);                                                                          \
+// Generic version of TERNARY_TENSOR_OPERATION for tensors with any shapes. The operands are walked with precomputed
+// strides (zero for the stretched dimensions)
+#define BROADCASTED_TERNARY_OPERATION(lhs, rhs, result, innerLoop)                                                               \
+	const auto layout = collapseBroadcastLayout(result.shape_,                                                                   \
+												computeBroadcastStrides(lhs.shape_, result.shape_),                              \
+												computeBroadcastStrides(rhs.shape_, result.shape_));                             \
                                                                                                                                  \
-	const auto biggerSize = std::max(lhs.shape_.size(), rhs.shape_.size());                                                      \
+	forEachBroadcastRow(layout, lhs.data_, rhs.data_, result.data_, innerLoop);
+
+// In-place operation written to the left operand if it has the broadcasted shape, otherwise to a new tensor assigned to
+// the left operand afterwards
+#define IN_PLACE_TENSOR_OPERATION(lhs, rhs, ternaryOperation)                                                                    \
+	const auto retShape = broadcastShapes(lhs.shape_, rhs.shape_);                                                               \
                                                                                                                                  \
-	const auto paddedLeftShape = padShapeFromLeft(lhs.shape_, biggerSize);                                                       \
-	const auto paddedRightShape = padShapeFromLeft(rhs.shape_, biggerSize);                                                      \
+	if(lhs.shape_ == retShape)                                                                                                   \
+	{                                                                                                                            \
+		ternaryOperation(lhs, rhs, lhs);                                                                                         \
+		return;                                                                                                                  \
+	}                                                                                                                            \
                                                                                                                                  \
-	const auto retShape = deduceBroadcastedShape(paddedLeftShape, paddedRightShape);                                             \
+	BasicTensor<ValueType> ret(retShape);                                                                                        \
+	ternaryOperation(lhs, rhs, ret);                                                                                             \
+	lhs = std::move(ret);
+
+// Operation between two views of any shapes and strides - result written to a new contiguous tensor
+#define BROADCASTED_VIEW_OPERATION(lhs, rhs, innerLoop)                                                                          \
+	const auto retShape = broadcastShapes(lhs.shape(), rhs.shape());                                                             \
                                                                                                                                  \
-	BasicTensor<ValueType> ret(retShape, 0.0);                                                                                   \
+	const auto layout = collapseBroadcastLayout(retShape,                                                                        \
+												computeBroadcastStrides(lhs.shape(), lhs.strides(), retShape),                   \
+												computeBroadcastStrides(rhs.shape(), rhs.strides(), retShape));                  \
                                                                                                                                  \
-	{                                                                                                                            \
-		STRETCH_TENSOR_TO_ANOTHER(ret, lhs, paddedLeftShape, __SIMPLE_PLUS);                                                     \
-	}                                                                                                                            \
+	BasicTensor<ValueType> ret(retShape);                                                                                        \
                                                                                                                                  \
-	{                                                                                                                            \
-		STRETCH_TENSOR_TO_ANOTHER(ret, rhs, paddedRightShape, oper);                                                             \
-	}                                                                                                                            \
+	forEachBroadcastRow(layout, lhs.data(), rhs.data(), ret.data_, innerLoop);                                                   \
                                                                                                                                  \
-	lhs = std::move(ret);
+	return ret;
 
 namespace mlCore
 {
 namespace
 {
-/**
- * @brief Checks if the shapes of two tensors can be stretched to perform the broadcast operation 
- * 
- * @param shape1 
- * @param shape2 
- */
-void checkShapesForBroadcasting(const std::vector<size_t>& shape1, const std::vector<size_t>& shape2)
+/// Checks if the result of a ternary operation has the shape of the broadcasted operands.
+void checkResultShape(const std::vector<size_t>& lhsShape,
+					  const std::vector<size_t>& rhsShape,
+					  const std::vector<size_t>& resultShape)
 {
-	// checking if the rules of broadcasting are not breached
-	for(auto [leftShapeIter, rightShapeIter] = std::tuple{shape1.crbegin(), shape2.crbegin()};
-		(leftShapeIter > shape1.crend()) && (rightShapeIter > shape2.crend());
-		leftShapeIter--, rightShapeIter--)
+	if(broadcastShapes(lhsShape, rhsShape) != resultShape)
 	{
-		if((*leftShapeIter != 1) && (*rightShapeIter != 1) && (*leftShapeIter != *rightShapeIter))
-		{
-			LOG_ERROR("TensorOperations",
-					  fmt::format("Cannot perform broadcasting operation on tensors with invalid shapes: '{}' '{}'.",
-								  stringifyVector(shape1),
-								  stringifyVector(shape2)));
-		}
+		LOG_ERROR("TensorOperations",
+				  fmt::format("Cannot store result of operation on tensors with shapes '{}' '{}' in tensor with shape '{}'.",
+							  stringifyVector(lhsShape),
+							  stringifyVector(rhsShape),
+							  stringifyVector(resultShape)));
 	}
 }
 
 /**
- * @brief Fills tensor's shape from left side with given value
- * 
- * @param shape Shape to be filled
- * @param biggerSize Size of the result tensor. If less than shape.size(), no padding is added
- * @param paddingVal Value to pad the shape with
- * @return Padded vector
+ * @brief Creates inner loop of a broadcasted operation. Rows with contiguous or stretched operands are computed with
+ * the vectorized kernels, the other ones element by element.
+ *
+ * @param operation Operation used to choose the vectorized kernel.
+ * @param scalarOperation Same operation computed for a single pair of elements.
  */
-std::vector<size_t> padShapeFromLeft(const std::vector<size_t>& shape, const size_t biggerSize, const size_t paddingVal = 1)
+template <typename ValueType, typename ScalarOperation>
+auto makeVectorizedInnerLoop(const ElementwiseOperation operation, ScalarOperation scalarOperation)
 {
-	std::vector<size_t> paddedShape(biggerSize, paddingVal);
+	const auto& kernels = getKernelTable<ValueType>();
 
-	std::copy(shape.cbegin(), shape.cend(), std::next(paddedShape.begin(), static_cast<ptrdiff_t>(biggerSize - shape.size())));
+	return [&kernels, operation, scalarOperation](const size_t length,
+												  const ValueType* lhs,
+												  const size_t lhsStride,
+												  const ValueType* rhs,
+												  const size_t rhsStride,
+												  ValueType* result) {
+		if((lhsStride == 1) && (rhsStride == 1))
+		{
+			kernels.getBinary(operation)(length, lhs, rhs, result);
+		}
+		else if((lhsStride == 1) && (rhsStride == 0))
+		{
+			kernels.getBinaryWithScalar(operation)(length, lhs, *rhs, result);
+		}
+		else if((lhsStride == 0) && (rhsStride == 1))
+		{
+			kernels.getScalarWithBinary(operation)(length, *lhs, rhs, result);
+		}
+		else
+		{
+			for(size_t pos = 0; pos < length; pos++)
+			{
+				result[pos] = scalarOperation(lhs[pos * lhsStride], rhs[pos * rhsStride]);
+			}
+		}
+	};
+}
+
+/// Computes `base` to the power of `factor`.
+template <typename ValueType>
+ValueType power(const ValueType base, const ValueType factor)
+{
+	using Compute = typename ComputeType<ValueType>::Type;
 
-	return paddedShape;
+	return static_cast<ValueType>(std::pow(static_cast<Compute>(base), static_cast<Compute>(factor)));
 }
 
-std::vector<size_t> deduceBroadcastedShape(const std::vector<size_t>& paddedShape1, const std::vector<size_t>& paddedShape2)
+/// Creates inner loop of a broadcasted operation having no vectorized kernels.
+template <typename ValueType, typename ScalarOperation>
+auto makeScalarInnerLoop(ScalarOperation scalarOperation)
 {
+	return [scalarOperation](const size_t length,
+							 const ValueType* lhs,
+							 const size_t lhsStride,
+							 const ValueType* rhs,
+							 const size_t rhsStride,
+							 ValueType* result) {
+		for(size_t pos = 0; pos < length; pos++)
+		{
+			result[pos] = scalarOperation(lhs[pos * lhsStride], rhs[pos * rhsStride]);
+		}
+	};
+}
+
+} // namespace
 
-	std::vector<size_t> retShape(paddedShape1.size());
-	for(size_t shapePos = 0; shapePos < paddedShape1.size(); shapePos++)
+template class TensorOperationsImpl<double>;
+template class TensorOperationsImpl<float>;
+template class TensorOperationsImpl<int32_t>;
+template class TensorOperationsImpl<BFloat16>;
+
+template <typename ValueType>
+std::vector<size_t> TensorOperationsImpl<ValueType>::getBroadcastedShape(const std::vector<size_t>& lhsShape,
+																		 const std::vector<size_t>& rhsShape)
+{
+	return broadcastShapes(lhsShape, rhsShape);
+}
+
+template <typename ValueType>
+bool TensorOperationsImpl<ValueType>::canStoreResult(const BasicTensor<ValueType>& tensor,
+													 const BasicTensor<ValueType>& otherOperand)
+{
+	if((tensor.storage_.use_count() != 1) || (otherOperand.shape_.size() > tensor.shape_.size()))
 	{
-		// filling new shape according to dimension that can be stretched
-		retShape[shapePos] = paddedShape1[shapePos] == 1 ? paddedShape2[shapePos] : paddedShape1[shapePos];
+		return false;
 	}
 
-	return retShape;
+	// the other operand can only be stretched to the tensor's shape
+	return std::equal(otherOperand.shape_.crbegin(),
+					  otherOperand.shape_.crend(),
+					  tensor.shape_.crbegin(),
+					  [](const auto otherDim, const auto dim) { return (otherDim == dim) || (otherDim == 1); });
 }
 
-} // namespace
+template <typename ValueType>
+void TensorOperationsImpl<ValueType>::addTensors(const BasicTensor<ValueType>& lhs,
+												 const BasicTensor<ValueType>& rhs,
+												 BasicTensor<ValueType>& result)
+{
+	TERNARY_TENSOR_OPERATION(lhs, rhs, result, ElementwiseOperation::ADD, std::plus<ValueType>())
+}
 
-template class TensorOperationsImpl<double>;
+template <typename ValueType>
+void TensorOperationsImpl<ValueType>::multiplyTensors(const BasicTensor<ValueType>& lhs,
+													  const BasicTensor<ValueType>& rhs,
+													  BasicTensor<ValueType>& result)
+{
+	TERNARY_TENSOR_OPERATION(lhs, rhs, result, ElementwiseOperation::MULTIPLY, std::multiplies<ValueType>())
+}
+
+template <typename ValueType>
+void TensorOperationsImpl<ValueType>::subtractTensors(const BasicTensor<ValueType>& lhs,
+													  const BasicTensor<ValueType>& rhs,
+													  BasicTensor<ValueType>& result)
+{
+	TERNARY_TENSOR_OPERATION(lhs, rhs, result, ElementwiseOperation::SUBTRACT, std::minus<ValueType>())
+}
+
+template <typename ValueType>
+void TensorOperationsImpl<ValueType>::divideTensors(const BasicTensor<ValueType>& lhs,
+													const BasicTensor<ValueType>& rhs,
+													BasicTensor<ValueType>& result)
+{
+	TERNARY_TENSOR_OPERATION(lhs, rhs, result, ElementwiseOperation::DIVIDE, std::divides<ValueType>())
+}
+
+template <typename ValueType>
+void TensorOperationsImpl<ValueType>::powerTensors(const BasicTensor<ValueType>& lhs,
+												   const BasicTensor<ValueType>& rhs,
+												   BasicTensor<ValueType>& result)
+{
+	checkResultShape(lhs.shape_, rhs.shape_, result.shape_);
+	result._detachStorage();
+
+	BROADCASTED_TERNARY_OPERATION(lhs, rhs, result, makeScalarInnerLoop<ValueType>(power<ValueType>))
+}
 
 template <typename ValueType>
 void TensorOperationsImpl<ValueType>::addTensorsInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs)
 {
-	COMPAT_SHAPES_OPERATION(lhs, rhs, __SIMPLE_PLUS)
-	OPERATION_WITH_SCALAR(lhs, rhs, __SIMPLE_PLUS)
-	BROADCASTED_TENSOR_OPERATION(lhs, rhs, __SIMPLE_PLUS)
+	IN_PLACE_TENSOR_OPERATION(lhs, rhs, addTensors)
 }
 
 template <typename ValueType>
 void TensorOperationsImpl<ValueType>::multiplyTensorsInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs)
 {
-	COMPAT_SHAPES_OPERATION(lhs, rhs, __SIMPLE_MULTIPLY)
-	OPERATION_WITH_SCALAR(lhs, rhs, __SIMPLE_MULTIPLY)
-	BROADCASTED_TENSOR_OPERATION(lhs, rhs, __SIMPLE_MULTIPLY)
+	IN_PLACE_TENSOR_OPERATION(lhs, rhs, multiplyTensors)
 }
 
 template <typename ValueType>
 void TensorOperationsImpl<ValueType>::subtractTensorsInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs)
 {
-	COMPAT_SHAPES_OPERATION(lhs, rhs, __SIMPLE_MINUS)
-	OPERATION_WITH_SCALAR(lhs, rhs, __SIMPLE_MINUS)
-	BROADCASTED_TENSOR_OPERATION(lhs, rhs, __SIMPLE_MINUS)
+	IN_PLACE_TENSOR_OPERATION(lhs, rhs, subtractTensors)
 }
 
 template <typename ValueType>
 void TensorOperationsImpl<ValueType>::divideTensorsInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs)
 {
-	COMPAT_SHAPES_OPERATION(lhs, rhs, __SIMPLE_DIVIDE)
-	OPERATION_WITH_SCALAR(lhs, rhs, __SIMPLE_DIVIDE)
-	BROADCASTED_TENSOR_OPERATION(lhs, rhs, __SIMPLE_DIVIDE)
+	IN_PLACE_TENSOR_OPERATION(lhs, rhs, divideTensors)
 }
 
 template <typename ValueType>
 void TensorOperationsImpl<ValueType>::powerInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs)
 {
-	COMPAT_SHAPES_OPERATION(lhs, rhs, std::pow)
-	OPERATION_WITH_SCALAR(lhs, rhs, std::pow)
-	BROADCASTED_TENSOR_OPERATION(lhs, rhs, std::pow)
+	IN_PLACE_TENSOR_OPERATION(lhs, rhs, powerTensors)
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> TensorOperationsImpl<ValueType>::addTensors(const BasicTensorView<ValueType>& lhs,
+																   const BasicTensorView<ValueType>& rhs)
+{
+	BROADCASTED_VIEW_OPERATION(lhs, rhs, makeVectorizedInnerLoop<ValueType>(ElementwiseOperation::ADD, std::plus<ValueType>()))
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> TensorOperationsImpl<ValueType>::multiplyTensors(const BasicTensorView<ValueType>& lhs,
+																		const BasicTensorView<ValueType>& rhs)
+{
+	BROADCASTED_VIEW_OPERATION(
+		lhs, rhs, makeVectorizedInnerLoop<ValueType>(ElementwiseOperation::MULTIPLY, std::multiplies<ValueType>()))
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> TensorOperationsImpl<ValueType>::subtractTensors(const BasicTensorView<ValueType>& lhs,
+																		const BasicTensorView<ValueType>& rhs)
+{
+	BROADCASTED_VIEW_OPERATION(
+		lhs, rhs, makeVectorizedInnerLoop<ValueType>(ElementwiseOperation::SUBTRACT, std::minus<ValueType>()))
+}
+
+template <typename ValueType>
+BasicTensor<ValueType> TensorOperationsImpl<ValueType>::divideTensors(const BasicTensorView<ValueType>& lhs,
+																	  const BasicTensorView<ValueType>& rhs)
+{
+	BROADCASTED_VIEW_OPERATION(
+		lhs, rhs, makeVectorizedInnerLoop<ValueType>(ElementwiseOperation::DIVIDE, std::divides<ValueType>()))
 }
 
 } // namespace mlCore
@@ -0,0 +1,38 @@
+#ifndef MLCORE_SRC_INCLUDE_AUTODIFF_DAGSCHEDULER_H
+#define MLCORE_SRC_INCLUDE_AUTODIFF_DAGSCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Utilities/ThreadPool.h>
+
+namespace mlCore::autoDiff
+{
+/**
+ * @brief Runs tasks forming a directed acyclic graph, each one once all of its predecessors have finished. The ready
+ * tasks are picked by the calling thread and by helping jobs added to the pool, so that independent tasks are run
+ * concurrently. The helpers bind the caller's allocator and thread pool, so the tasks' kernels behave the same on every
+ * thread.
+ *
+ * As in parallelFor, the caller takes part in the computation, so the function does not deadlock when called from the
+ * pool's jobs. Returns once all started tasks are finished. No new tasks are started after one of them has thrown and
+ * the first exception is rethrown to the caller.
+ *
+ * @param threadPool Pool whose threads help the caller.
+ * @param nTasks Number of tasks to run.
+ * @param readyTasks Tasks having no predecessors.
+ * @param task Function called with the task's index. Different tasks may be called concurrently.
+ * @param release Function called after the task with its index. Pushes the successors having no more unfinished
+ * predecessors to the passed vector. Calls of the function are serialized.
+ */
+void runDag(const std::shared_ptr<utilities::ThreadPool>& threadPool,
+			size_t nTasks,
+			std::vector<size_t> readyTasks,
+			const std::function<void(size_t)>& task,
+			const std::function<void(size_t, std::vector<size_t>&)>& release);
+
+} // namespace mlCore::autoDiff
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MLCORE_SRC_INCLUDE_AUTODIFF_HASHCOMBINE_H
+#define MLCORE_SRC_INCLUDE_AUTODIFF_HASHCOMBINE_H
+
+#include <cstddef>
+#include <functional>
+
+namespace mlCore::autoDiff
+{
+/**
+ * @brief Mixes the hash of the value into the seed like boost::hash_combine, so that the hashes of the keys made of many
+ * values depend on their order.
+ *
+ * @param seed Hash of the values combined so far.
+ * @param value Next value of the key.
+ */
+inline void combineHash(size_t& seed, const size_t value) noexcept
+{
+	seed ^= std::hash<size_t>{}(value) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+}
+
+} // namespace mlCore::autoDiff
+
+#endif
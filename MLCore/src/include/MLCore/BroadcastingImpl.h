@@ -0,0 +1,118 @@
+#ifndef MLCORE_SRC_INCLUDE_MLCORE_BROADCASTINGIMPL_H
+#define MLCORE_SRC_INCLUDE_MLCORE_BROADCASTINGIMPL_H
+
+#include <cstddef>
+#include <vector>
+
+namespace mlCore
+{
+/**
+ * @brief Layout of a broadcasted binary operation. The output is contiguous and the operands are described by their
+ * strides along the output's dimensions, with zero strides for the broadcast ones.
+ *
+ * Dimensions of size 1 are dropped and neighbouring dimensions that are contiguous for all tensors are merged, so
+ * e.g. `[N, M] + [M]` is described by two dimensions and `[N, M] + [N, M]` by one.
+ */
+struct BroadcastLayout
+{
+	std::vector<size_t> shape{};
+	std::vector<size_t> lhsStrides{};
+	std::vector<size_t> rhsStrides{};
+};
+
+/**
+ * @brief Checks if the shapes are compatible and gets the shape of the broadcasting result. Throws
+ * std::runtime_error if the shapes cannot be broadcast.
+ *
+ * @param lhsShape Shape of the left operand.
+ * @param rhsShape Shape of the right operand.
+ */
+std::vector<size_t> broadcastShapes(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape);
+
+/**
+ * @brief Computes strides of a contiguous tensor along the dimensions of the broadcasted shape. Dimensions padded from
+ * the left and the stretched ones are given zero strides.
+ *
+ * @param shape Shape of the tensor.
+ * @param broadcastedShape Shape of the broadcasting result, having at least as many dimensions as `shape`.
+ * @return Strides aligned to `broadcastedShape`.
+ */
+std::vector<size_t> computeBroadcastStrides(const std::vector<size_t>& shape, const std::vector<size_t>& broadcastedShape);
+
+/**
+ * @brief Same as above, but for a tensor whose elements are described by arbitrary strides, e.g. a view.
+ *
+ * @param shape Shape of the tensor.
+ * @param strides Strides of the tensor along its dimensions.
+ * @param broadcastedShape Shape of the broadcasting result, having at least as many dimensions as `shape`.
+ * @return Strides aligned to `broadcastedShape`.
+ */
+std::vector<size_t> computeBroadcastStrides(const std::vector<size_t>& shape,
+											const std::vector<size_t>& strides,
+											const std::vector<size_t>& broadcastedShape);
+
+/**
+ * @brief Drops the unit dimensions and merges the contiguous ones. The result always has at least one dimension.
+ *
+ * @param shape Shape of the output.
+ * @param lhsStrides Strides of the left operand along the output's dimensions.
+ * @param rhsStrides Strides of the right operand along the output's dimensions.
+ */
+BroadcastLayout collapseBroadcastLayout(const std::vector<size_t>& shape,
+										const std::vector<size_t>& lhsStrides,
+										const std::vector<size_t>& rhsStrides);
+
+/**
+ * @brief Runs `innerLoop` for each row of the innermost dimension of the layout. Offsets of the consecutive rows are
+ * updated incrementally, so that the per-element work is done solely by the inner loop.
+ *
+ * @param layout Collapsed layout of the operation.
+ * @param lhs Data of the left operand.
+ * @param rhs Data of the right operand.
+ * @param result Contiguous output. May alias `lhs` if the left operand is not broadcast.
+ * @param innerLoop Callable with signature `(length, lhs, lhsStride, rhs, rhsStride, result)` computing a single row.
+ */
+template <typename ValueType, typename InnerLoop>
+void forEachBroadcastRow(
+	const BroadcastLayout& layout, const ValueType* lhs, const ValueType* rhs, ValueType* result, InnerLoop&& innerLoop)
+{
+	const size_t nOuterDims = layout.shape.size() - 1;
+	const size_t rowLength = layout.shape.back();
+	const size_t lhsRowStride = layout.lhsStrides.back();
+	const size_t rhsRowStride = layout.rhsStrides.back();
+
+	size_t nRows = 1;
+	for(size_t dim = 0; dim < nOuterDims; dim++)
+	{
+		nRows *= layout.shape[dim];
+	}
+
+	std::vector<size_t> outerPath(nOuterDims, 0);
+	size_t lhsOffset = 0;
+	size_t rhsOffset = 0;
+
+	for(size_t row = 0; row < nRows; row++)
+	{
+		innerLoop(rowLength, lhs + lhsOffset, lhsRowStride, rhs + rhsOffset, rhsRowStride, result + row * rowLength);
+
+		for(size_t dim = nOuterDims - 1; dim < nOuterDims; dim--)
+		{
+			outerPath[dim]++;
+			lhsOffset += layout.lhsStrides[dim];
+			rhsOffset += layout.rhsStrides[dim];
+
+			if(outerPath[dim] < layout.shape[dim])
+			{
+				break;
+			}
+
+			lhsOffset -= outerPath[dim] * layout.lhsStrides[dim];
+			rhsOffset -= outerPath[dim] * layout.rhsStrides[dim];
+			outerPath[dim] = 0;
+		}
+	}
+}
+
+} // namespace mlCore
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef MLCORE_SRC_INCLUDE_MLCORE_KERNELDISPATCH_H
+#define MLCORE_SRC_INCLUDE_MLCORE_KERNELDISPATCH_H
+
+#include <array>
+#include <cstddef>
+
+#include <MLCore/BFloat16.h>
+#include <MLCore/InstructionSet.h>
+
+namespace mlCore
+{
+/// Elementwise operations having vectorized kernels. Used to index KernelTable's arrays.
+enum class ElementwiseOperation : uint8_t
+{
+	ADD,
+	SUBTRACT,
+	MULTIPLY,
+	DIVIDE
+};
+
+/// Number of ElementwiseOperation's values.
+constexpr size_t kNumElementwiseOperations = 4;
+
+/// Computes the operation for a single pair of elements.
+template <ElementwiseOperation operation, typename ValueType>
+constexpr ValueType applyElementwiseOperation(const ValueType lhs, const ValueType rhs)
+{
+	if constexpr(operation == ElementwiseOperation::ADD)
+	{
+		return lhs + rhs;
+	}
+	else if constexpr(operation == ElementwiseOperation::SUBTRACT)
+	{
+		return lhs - rhs;
+	}
+	else if constexpr(operation == ElementwiseOperation::MULTIPLY)
+	{
+		return lhs * rhs;
+	}
+	else
+	{
+		return lhs / rhs;
+	}
+}
+
+/**
+ * @brief Set of hot kernels compiled for a single instruction set.
+ *
+ * @tparam ValueType Type of the processed elements.
+ */
+template <typename ValueType>
+struct KernelTable
+{
+	/// Computes a microRows x microCols tile of matmul from packed panels and stores its valid part to the result.
+	using MicroKernel = void (*)(size_t depth,
+								 const ValueType* packedLhs,
+								 const ValueType* packedRhs,
+								 ValueType* result,
+								 size_t resultRowStride,
+								 size_t nValidRows,
+								 size_t nValidCols,
+								 bool accumulate);
+
+	/// Computes result[i] = lhs[i] op rhs[i]. The result may alias any of the inputs.
+	using BinaryKernel = void (*)(size_t length, const ValueType* lhs, const ValueType* rhs, ValueType* result);
+
+	/// Computes result[i] = lhs[i] op rhs. The result may alias the input.
+	using BinaryWithScalarKernel = void (*)(size_t length, const ValueType* lhs, ValueType rhs, ValueType* result);
+
+	/// Computes result[i] = lhs op rhs[i]. The result may alias the input.
+	using ScalarWithBinaryKernel = void (*)(size_t length, ValueType lhs, const ValueType* rhs, ValueType* result);
+
+	InstructionSet instructionSet;
+
+	size_t microRows;
+	size_t microCols;
+	MicroKernel microKernel;
+
+	std::array<BinaryKernel, kNumElementwiseOperations> binary;
+	std::array<BinaryWithScalarKernel, kNumElementwiseOperations> binaryWithScalar;
+	std::array<ScalarWithBinaryKernel, kNumElementwiseOperations> scalarWithBinary;
+
+	/// Gets kernel computing the given operation between two arrays.
+	BinaryKernel getBinary(const ElementwiseOperation operation) const
+	{
+		return binary[static_cast<size_t>(operation)];
+	}
+
+	/// Gets kernel computing the given operation between an array and a scalar.
+	BinaryWithScalarKernel getBinaryWithScalar(const ElementwiseOperation operation) const
+	{
+		return binaryWithScalar[static_cast<size_t>(operation)];
+	}
+
+	/// Gets kernel computing the given operation between a scalar and an array.
+	ScalarWithBinaryKernel getScalarWithBinary(const ElementwiseOperation operation) const
+	{
+		return scalarWithBinary[static_cast<size_t>(operation)];
+	}
+};
+
+/**
+ * @brief Gets kernels matching the currently chosen instruction set.
+ *
+ */
+template <typename ValueType>
+const KernelTable<ValueType>& getKernelTable();
+
+/// Kernels written in plain C++, available on every host.
+template <typename ValueType>
+const KernelTable<ValueType>& getScalarKernelTable();
+
+/// Kernels using SSE2 instructions. Types having no vectorized kernels use the scalar ones.
+template <typename ValueType>
+const KernelTable<ValueType>& getSse2KernelTable()
+{
+	return getScalarKernelTable<ValueType>();
+}
+
+/// Kernels using AVX2 and FMA instructions. Types having no vectorized kernels use the scalar ones.
+template <typename ValueType>
+const KernelTable<ValueType>& getAvx2KernelTable()
+{
+	return getScalarKernelTable<ValueType>();
+}
+
+/// Kernels using AVX-512F instructions. Types having no vectorized kernels use the scalar ones.
+template <typename ValueType>
+const KernelTable<ValueType>& getAvx512KernelTable()
+{
+	return getScalarKernelTable<ValueType>();
+}
+
+template <>
+const KernelTable<double>& getSse2KernelTable<double>();
+
+template <>
+const KernelTable<float>& getSse2KernelTable<float>();
+
+template <>
+const KernelTable<double>& getAvx2KernelTable<double>();
+
+template <>
+const KernelTable<float>& getAvx2KernelTable<float>();
+
+template <>
+const KernelTable<double>& getAvx512KernelTable<double>();
+
+template <>
+const KernelTable<float>& getAvx512KernelTable<float>();
+
+} // namespace mlCore
+
+#endif
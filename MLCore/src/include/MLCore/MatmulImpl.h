@@ -0,0 +1,128 @@
+#ifndef MLCORE_SRC_INCLUDE_MLCORE_MATMULIMPL_H
+#define MLCORE_SRC_INCLUDE_MLCORE_MATMULIMPL_H
+
+#include <cstddef>
+#include <vector>
+
+#include <MLCore/KernelDispatch.h>
+
+namespace mlCore
+{
+/**
+ * @brief Describes a read-only 2-dimensional matrix placed somewhere in memory. Element (row, col) is located at
+ * `data[row * rowStride + col * colStride]`, so that both row-major and transposed layouts can be expressed.
+ *
+ * @tparam ValueType Type of the matrix elements.
+ */
+template <typename ValueType>
+struct ConstMatrixFrame
+{
+	const ValueType* data;
+	size_t rowStride;
+	size_t colStride;
+};
+
+/**
+ * @brief Describes a writable row-major 2-dimensional matrix. Element (row, col) is located at `data[row * rowStride + col]`.
+ *
+ * @tparam ValueType Type of the matrix elements.
+ */
+template <typename ValueType>
+struct MatrixFrame
+{
+	ValueType* data;
+	size_t rowStride;
+};
+
+/// Positions of a single frame's operands and result, relative to the frames passed to MatmulImpl::multiplyFrames.
+struct FrameOffsets
+{
+	size_t lhs;
+	size_t rhs;
+	size_t result;
+};
+
+/**
+ * @brief Implements general matrix multiplication of batches of frames. The computation is split into blocks fitting the
+ * consecutive cache levels, both operands are packed into contiguous panels and the innermost work is done by a
+ * register-tiled micro-kernel chosen for the current instruction set.
+ *
+ * The work is split into tasks computing separate tiles of the result frames and run on the current thread pool. The
+ * split does not depend on the number of threads and each result element is always accumulated in the same order, so
+ * the results are deterministic.
+ *
+ * @tparam ValueType Type of the multiplied elements.
+ */
+template <typename ValueType>
+class MatmulImpl
+{
+public:
+	/// Depth of the packed panels, chosen so that a packed panel of the right operand stays in L1.
+	static constexpr size_t kDepthBlock = 256;
+
+	/// Maximal number of rows of the left operand packed at once, chosen so that the packed block stays in L2.
+	static constexpr size_t kRowsBlock = 128;
+
+	/// Number of columns of the right operand packed at once, chosen so that the packed block stays in L3.
+	static constexpr size_t kColsBlock = 2048;
+
+	/// Number of result columns computed by a single parallel task.
+	static constexpr size_t kColsTile = 512;
+
+	/**
+	 * @brief Computes `result = lhs * rhs` for each of the frames. Previous content of the results is overwritten.
+	 *
+	 * @param nRows Number of rows of `lhs` and `result`.
+	 * @param nCols Number of columns of `rhs` and `result`.
+	 * @param adjacentDim Number of columns of `lhs` and rows of `rhs`.
+	 * @param lhs Left operand of the multiplication.
+	 * @param rhs Right operand of the multiplication.
+	 * @param result Matrix the product is written to.
+	 * @param frameOffsets Offsets added to the data pointers of `lhs`, `rhs` and `result` to obtain the consecutive frames.
+	 */
+	static void multiplyFrames(size_t nRows,
+							   size_t nCols,
+							   size_t adjacentDim,
+							   const ConstMatrixFrame<ValueType>& lhs,
+							   const ConstMatrixFrame<ValueType>& rhs,
+							   const MatrixFrame<ValueType>& result,
+							   const std::vector<FrameOffsets>& frameOffsets);
+
+private:
+	/// Multiplies frames with packed operands using the given micro-kernel.
+	static void _multiplyBlockedFrames(size_t nRows,
+									   size_t nCols,
+									   size_t adjacentDim,
+									   const ConstMatrixFrame<ValueType>& lhs,
+									   const ConstMatrixFrame<ValueType>& rhs,
+									   const MatrixFrame<ValueType>& result,
+									   const KernelTable<ValueType>& kernels);
+
+	/// Multiplies small frames without packing, for which the packing overhead would dominate.
+	static void _multiplySmallFrames(size_t nRows,
+									 size_t nCols,
+									 size_t adjacentDim,
+									 const ConstMatrixFrame<ValueType>& lhs,
+									 const ConstMatrixFrame<ValueType>& rhs,
+									 const MatrixFrame<ValueType>& result);
+
+	/// Copies `nRows` x `depth` block of `lhs` into column-major panels of `microRows` rows. Missing rows are zeroed.
+	static void _packLhs(size_t nRows, size_t depth, size_t microRows, const ConstMatrixFrame<ValueType>& lhs, ValueType* packed);
+
+	/// Copies `depth` x `nCols` block of `rhs` into row-major panels of `microCols` columns. Missing columns are zeroed.
+	static void _packRhs(size_t depth, size_t nCols, size_t microCols, const ConstMatrixFrame<ValueType>& rhs, ValueType* packed);
+};
+
+/// BFloat16 frames are widened to float and multiplied with the float kernels, so that the products are accumulated in
+/// float and rounded only once.
+template <>
+void MatmulImpl<BFloat16>::multiplyFrames(size_t nRows,
+										  size_t nCols,
+										  size_t adjacentDim,
+										  const ConstMatrixFrame<BFloat16>& lhs,
+										  const ConstMatrixFrame<BFloat16>& rhs,
+										  const MatrixFrame<BFloat16>& result,
+										  const std::vector<FrameOffsets>& frameOffsets);
+} // namespace mlCore
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef MLCORE_SRC_INCLUDE_MLCORE_PARALLELFOR_H
+#define MLCORE_SRC_INCLUDE_MLCORE_PARALLELFOR_H
+
+#include <cstddef>
+#include <functional>
+
+namespace mlCore
+{
+/**
+ * @brief Calls `task(0)`, ..., `task(nTasks - 1)` using the thread pool returned by getCurrentThreadPool.
+ *
+ * The calling thread takes part in the computation and the pool's threads only help it by grabbing the remaining
+ * tasks, so that the function does not deadlock when called from within the pool's jobs. Returns once all tasks are
+ * finished. The first exception thrown by the tasks is rethrown to the caller. The helping threads use the caller's
+ * allocator, see getCurrentAllocator.
+ *
+ * @param nTasks Number of tasks to run.
+ * @param task Function called with the index of the task. Different tasks may be called concurrently.
+ */
+void parallelFor(size_t nTasks, const std::function<void(size_t)>& task);
+
+} // namespace mlCore
+
+#endif
@@ -2,6 +2,7 @@
 #define MLCORE_SRC_INCLUDE_MLCORE_TENSOROPERATIONSIMPL_H
 
 #include <MLCore/BasicTensor.h>
+#include <MLCore/BasicTensorView.h>
 
 namespace mlCore
 {
@@ -10,6 +11,36 @@ template <typename ValueType>
 class TensorOperationsImpl
 {
 public:
+	/// Gets shape of the result of a broadcasted operation. Throws if the shapes are incompatible
+	static std::vector<size_t> getBroadcastedShape(const std::vector<size_t>& lhsShape, const std::vector<size_t>& rhsShape);
+
+	/// Tells if the tensor can be overwritten with the result of an operation with the other operand, i.e. its storage is
+	/// not shared and the result has its shape
+	static bool canStoreResult(const BasicTensor<ValueType>& tensor, const BasicTensor<ValueType>& otherOperand);
+
+	/// Computes `result = lhs + rhs`. The result has to have the broadcasted shape and may be one of the operands
+	static void addTensors(const BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs, BasicTensor<ValueType>& result);
+
+	/// Computes `result = lhs * rhs`. The result has to have the broadcasted shape and may be one of the operands
+	static void multiplyTensors(const BasicTensor<ValueType>& lhs,
+								const BasicTensor<ValueType>& rhs,
+								BasicTensor<ValueType>& result);
+
+	/// Computes `result = lhs - rhs`. The result has to have the broadcasted shape and may be one of the operands
+	static void subtractTensors(const BasicTensor<ValueType>& lhs,
+								const BasicTensor<ValueType>& rhs,
+								BasicTensor<ValueType>& result);
+
+	/// Computes `result = lhs / rhs`. The result has to have the broadcasted shape and may be one of the operands
+	static void divideTensors(const BasicTensor<ValueType>& lhs,
+							  const BasicTensor<ValueType>& rhs,
+							  BasicTensor<ValueType>& result);
+
+	/// Computes `result = lhs ^ rhs`. The result has to have the broadcasted shape and may be one of the operands
+	static void powerTensors(const BasicTensor<ValueType>& lhs,
+							 const BasicTensor<ValueType>& rhs,
+							 BasicTensor<ValueType>& result);
+
 	/// Adds right tensor to the left one
 	static void addTensorsInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs);
 
@@ -24,6 +55,20 @@ public:
 
 	/// Computes left tensor to the power of right one
 	static void powerInPlace(BasicTensor<ValueType>& lhs, const BasicTensor<ValueType>& rhs);
+
+	/// Creates a sum of two views
+	static BasicTensor<ValueType> addTensors(const BasicTensorView<ValueType>& lhs, const BasicTensorView<ValueType>& rhs);
+
+	/// Creates a product of multiplying left view by the right one
+	static BasicTensor<ValueType> multiplyTensors(const BasicTensorView<ValueType>& lhs,
+												  const BasicTensorView<ValueType>& rhs);
+
+	/// Creates a difference of two views
+	static BasicTensor<ValueType> subtractTensors(const BasicTensorView<ValueType>& lhs,
+												  const BasicTensorView<ValueType>& rhs);
+
+	/// Creates a quotient of two views
+	static BasicTensor<ValueType> divideTensors(const BasicTensorView<ValueType>& lhs, const BasicTensorView<ValueType>& rhs);
 };
 } // namespace mlCore
 
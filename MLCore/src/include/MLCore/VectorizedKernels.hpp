@@ -0,0 +1,202 @@
+#ifndef MLCORE_SRC_INCLUDE_MLCORE_VECTORIZEDKERNELS_HPP
+#define MLCORE_SRC_INCLUDE_MLCORE_VECTORIZEDKERNELS_HPP
+
+#include <MLCore/KernelDispatch.h>
+
+/**
+ * Kernels written once for all of the vector instruction sets. A translation unit including the header defines first:
+ * - MLCORE_KERNEL_TARGET - attribute compiling the kernels for the instruction set,
+ * - `VectorOps<ValueType>` - intrinsics for the supported element types, providing the vector `Type`, its number of
+ * lanes `kLanes`, height of the micro-kernel's tile `kMicroRows` and functions `zero`, `load`, `store`, `broadcast`,
+ * `add`, `subtract`, `multiply`, `divide` and `multiplyAdd` (`acc + lhs * rhs`).
+ *
+ * Each instruction set is compiled in a separate translation unit, so the kernels live in an anonymous namespace.
+ */
+
+namespace mlCore
+{
+namespace
+{
+/// Applies the operation to a pair of vectors.
+template <ElementwiseOperation operation, typename Vector>
+MLCORE_KERNEL_TARGET typename Vector::Type applyVectorOperation(const typename Vector::Type lhs, const typename Vector::Type rhs)
+{
+	if constexpr(operation == ElementwiseOperation::ADD)
+	{
+		return Vector::add(lhs, rhs);
+	}
+	else if constexpr(operation == ElementwiseOperation::SUBTRACT)
+	{
+		return Vector::subtract(lhs, rhs);
+	}
+	else if constexpr(operation == ElementwiseOperation::MULTIPLY)
+	{
+		return Vector::multiply(lhs, rhs);
+	}
+	else
+	{
+		return Vector::divide(lhs, rhs);
+	}
+}
+
+/// Computes result[i] = lhs[i] op rhs[i].
+template <typename ValueType, ElementwiseOperation operation>
+MLCORE_KERNEL_TARGET void binaryKernel(const size_t length, const ValueType* lhs, const ValueType* rhs, ValueType* result)
+{
+	using Vector = VectorOps<ValueType>;
+
+	size_t pos = 0;
+	for(; pos + Vector::kLanes <= length; pos += Vector::kLanes)
+	{
+		Vector::store(result + pos, applyVectorOperation<operation, Vector>(Vector::load(lhs + pos), Vector::load(rhs + pos)));
+	}
+	for(; pos < length; pos++)
+	{
+		result[pos] = applyElementwiseOperation<operation>(lhs[pos], rhs[pos]);
+	}
+}
+
+/// Computes result[i] = lhs[i] op rhs.
+template <typename ValueType, ElementwiseOperation operation>
+MLCORE_KERNEL_TARGET void binaryWithScalarKernel(const size_t length, const ValueType* lhs, const ValueType rhs, ValueType* result)
+{
+	using Vector = VectorOps<ValueType>;
+
+	const auto rhsVector = Vector::broadcast(rhs);
+
+	size_t pos = 0;
+	for(; pos + Vector::kLanes <= length; pos += Vector::kLanes)
+	{
+		Vector::store(result + pos, applyVectorOperation<operation, Vector>(Vector::load(lhs + pos), rhsVector));
+	}
+	for(; pos < length; pos++)
+	{
+		result[pos] = applyElementwiseOperation<operation>(lhs[pos], rhs);
+	}
+}
+
+/// Computes result[i] = lhs op rhs[i].
+template <typename ValueType, ElementwiseOperation operation>
+MLCORE_KERNEL_TARGET void scalarWithBinaryKernel(const size_t length, const ValueType lhs, const ValueType* rhs, ValueType* result)
+{
+	using Vector = VectorOps<ValueType>;
+
+	const auto lhsVector = Vector::broadcast(lhs);
+
+	size_t pos = 0;
+	for(; pos + Vector::kLanes <= length; pos += Vector::kLanes)
+	{
+		Vector::store(result + pos, applyVectorOperation<operation, Vector>(lhsVector, Vector::load(rhs + pos)));
+	}
+	for(; pos < length; pos++)
+	{
+		result[pos] = applyElementwiseOperation<operation>(lhs, rhs[pos]);
+	}
+}
+
+/// Computes a kMicroRows x (2 * kLanes) tile of matmul, keeping the accumulators in two vectors per row.
+template <typename ValueType>
+MLCORE_KERNEL_TARGET void microKernel(const size_t depth,
+									  const ValueType* packedLhs,
+									  const ValueType* packedRhs,
+									  ValueType* const result,
+									  const size_t resultRowStride,
+									  const size_t nValidRows,
+									  const size_t nValidCols,
+									  const bool accumulate)
+{
+	using Vector = VectorOps<ValueType>;
+
+	constexpr size_t kMicroRows = Vector::kMicroRows;
+	constexpr size_t kLanes = Vector::kLanes;
+	constexpr size_t kMicroCols = 2 * kLanes;
+
+	typename Vector::Type tile[kMicroRows][2];
+
+	for(auto& row : tile)
+	{
+		row[0] = Vector::zero();
+		row[1] = Vector::zero();
+	}
+
+	for(size_t depthIter = 0; depthIter < depth; depthIter++)
+	{
+		const auto rhsLow = Vector::load(packedRhs);
+		const auto rhsHigh = Vector::load(packedRhs + kLanes);
+
+		for(size_t rowIter = 0; rowIter < kMicroRows; rowIter++)
+		{
+			const auto lhsValue = Vector::broadcast(packedLhs[rowIter]);
+
+			tile[rowIter][0] = Vector::multiplyAdd(lhsValue, rhsLow, tile[rowIter][0]);
+			tile[rowIter][1] = Vector::multiplyAdd(lhsValue, rhsHigh, tile[rowIter][1]);
+		}
+
+		packedLhs += kMicroRows;
+		packedRhs += kMicroCols;
+	}
+
+	if((nValidRows == kMicroRows) && (nValidCols == kMicroCols))
+	{
+		for(size_t rowIter = 0; rowIter < kMicroRows; rowIter++)
+		{
+			ValueType* const resultRow = result + rowIter * resultRowStride;
+
+			if(accumulate)
+			{
+				tile[rowIter][0] = Vector::add(tile[rowIter][0], Vector::load(resultRow));
+				tile[rowIter][1] = Vector::add(tile[rowIter][1], Vector::load(resultRow + kLanes));
+			}
+
+			Vector::store(resultRow, tile[rowIter][0]);
+			Vector::store(resultRow + kLanes, tile[rowIter][1]);
+		}
+
+		return;
+	}
+
+	// edge tiles are spilled and only their valid part is copied
+	ValueType spilledTile[kMicroRows][kMicroCols];
+
+	for(size_t rowIter = 0; rowIter < kMicroRows; rowIter++)
+	{
+		Vector::store(spilledTile[rowIter], tile[rowIter][0]);
+		Vector::store(spilledTile[rowIter] + kLanes, tile[rowIter][1]);
+	}
+
+	for(size_t rowIter = 0; rowIter < nValidRows; rowIter++)
+	{
+		ValueType* const resultRow = result + rowIter * resultRowStride;
+
+		for(size_t colIter = 0; colIter < nValidCols; colIter++)
+		{
+			resultRow[colIter] = accumulate ? resultRow[colIter] + spilledTile[rowIter][colIter] : spilledTile[rowIter][colIter];
+		}
+	}
+}
+
+/// Gathers the kernels compiled for the given type.
+template <typename ValueType>
+KernelTable<ValueType> createVectorizedKernelTable(const InstructionSet instructionSet)
+{
+	return {.instructionSet = instructionSet,
+			.microRows = VectorOps<ValueType>::kMicroRows,
+			.microCols = 2 * VectorOps<ValueType>::kLanes,
+			.microKernel = microKernel<ValueType>,
+			.binary = {binaryKernel<ValueType, ElementwiseOperation::ADD>,
+					   binaryKernel<ValueType, ElementwiseOperation::SUBTRACT>,
+					   binaryKernel<ValueType, ElementwiseOperation::MULTIPLY>,
+					   binaryKernel<ValueType, ElementwiseOperation::DIVIDE>},
+			.binaryWithScalar = {binaryWithScalarKernel<ValueType, ElementwiseOperation::ADD>,
+								 binaryWithScalarKernel<ValueType, ElementwiseOperation::SUBTRACT>,
+								 binaryWithScalarKernel<ValueType, ElementwiseOperation::MULTIPLY>,
+								 binaryWithScalarKernel<ValueType, ElementwiseOperation::DIVIDE>},
+			.scalarWithBinary = {scalarWithBinaryKernel<ValueType, ElementwiseOperation::ADD>,
+								 scalarWithBinaryKernel<ValueType, ElementwiseOperation::SUBTRACT>,
+								 scalarWithBinaryKernel<ValueType, ElementwiseOperation::MULTIPLY>,
+								 scalarWithBinaryKernel<ValueType, ElementwiseOperation::DIVIDE>}};
+}
+} // namespace
+} // namespace mlCore
+
+#endif
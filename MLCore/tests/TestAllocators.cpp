@@ -0,0 +1,332 @@
+/**********************
+ * Test suite for 'ai_projects'
+ *
+ * Copyright (c) 2023
+ *
+ * by Wiktor Prosowicz
+ **********************/
+
+#include <MLCore/Allocation.h>
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <AutoDiff/ComputationGraph.h>
+#include <AutoDiff/GraphOperations.h>
+#include <MLCore/Allocators/ArenaAllocator.h>
+#include <MLCore/Allocators/BufferAllocator.h>
+#include <MLCore/Allocators/HeapAllocator.h>
+#include <MLCore/Allocators/PoolAllocator.h>
+#include <MLCore/BasicTensor.h>
+
+namespace
+{
+/*****************************
+ *
+ * Common data structures
+ *
+ *****************************/
+
+/// Allocator passing the requests to the heap and counting them.
+class CountingAllocator : public mlCore::allocators::HeapAllocator
+{
+public:
+	void* allocate(const size_t nBytes) override
+	{
+		nAllocations++;
+		return HeapAllocator::allocate(nBytes);
+	}
+
+	void deallocate(void* const memory, const size_t nBytes) override
+	{
+		nDeallocations++;
+		HeapAllocator::deallocate(memory, nBytes);
+	}
+
+	std::atomic<size_t> nAllocations = 0;
+	std::atomic<size_t> nDeallocations = 0;
+};
+
+/*****************************
+ *
+ * Test Fixture
+ *
+ *****************************/
+
+class TestAllocators : public testing::Test
+{
+protected:
+	/// Checks if the memory is aligned to kAllocationAlignment.
+	static bool isAligned(const void* const memory)
+	{
+		return reinterpret_cast<uintptr_t>(memory) % mlCore::allocators::kAllocationAlignment == 0;
+	}
+};
+
+/*****************************
+ *
+ * Particular test calls
+ *
+ *****************************/
+
+TEST_F(TestAllocators, testAlignment)
+{
+	const std::vector<mlCore::allocators::AllocatorPtr> allocators{std::make_shared<mlCore::allocators::HeapAllocator>(),
+																   std::make_shared<mlCore::allocators::PoolAllocator>(),
+																   std::make_shared<mlCore::allocators::ArenaAllocator>(1024)};
+
+	for(const auto& allocator : allocators)
+	{
+		std::vector<std::pair<void*, size_t>> blocks;
+
+		for(const size_t nBytes : std::initializer_list<size_t>{1, 8, 63, 64, 65, 1000, 5000, 100000})
+		{
+			blocks.emplace_back(allocator->allocate(nBytes), nBytes);
+			ASSERT_TRUE(isAligned(blocks.back().first));
+		}
+
+		for(const auto& [block, nBytes] : blocks)
+		{
+			allocator->deallocate(block, nBytes);
+		}
+
+		const mlCore::AllocatorScope scope(allocator);
+		const mlCore::Tensor tensor({3, 7}, 1.0);
+
+		ASSERT_TRUE(isAligned(&*tensor.begin()));
+	}
+}
+
+TEST_F(TestAllocators, testPoolReusesBlocks)
+{
+	mlCore::allocators::PoolAllocator pool;
+
+	ASSERT_EQ(mlCore::allocators::PoolAllocator::getBlockSize(1), 64);
+	ASSERT_EQ(mlCore::allocators::PoolAllocator::getBlockSize(1000), 1024);
+	ASSERT_EQ(mlCore::allocators::PoolAllocator::getBlockSize(1024), 1024);
+
+	void* const block = pool.allocate(1000);
+	pool.deallocate(block, 1000);
+
+	ASSERT_EQ(pool.getCachedBytes(), 1024);
+
+	// requests of the same size class are served with the cached block
+	ASSERT_EQ(pool.allocate(900), block);
+	ASSERT_EQ(pool.getCachedBytes(), 0);
+
+	pool.deallocate(block, 900);
+	pool.release();
+
+	ASSERT_EQ(pool.getCachedBytes(), 0);
+
+	// blocks bigger than the limit are not cached
+	mlCore::allocators::PoolAllocator smallPool(size_t(1) << 20, 4096);
+
+	smallPool.deallocate(smallPool.allocate(5000), 5000);
+	ASSERT_EQ(smallPool.getCachedBytes(), 0);
+}
+
+TEST_F(TestAllocators, testPoolSharesBlocksBetweenThreads)
+{
+	// with no per-thread cache all blocks go through the shared lists
+	mlCore::allocators::PoolAllocator pool(0);
+
+	void* const block = pool.allocate(256);
+
+	std::thread([&pool, block]() { pool.deallocate(block, 256); }).join();
+
+	ASSERT_EQ(pool.getCachedBytes(), 256);
+	ASSERT_EQ(pool.allocate(256), block);
+
+	pool.deallocate(block, 256);
+
+	// blocks cached by a thread are released on its exit, even if they were allocated by another one
+	mlCore::allocators::PoolAllocator cachingPool;
+
+	std::vector<void*> blocks;
+	for(size_t blockIdx = 0; blockIdx < 8; blockIdx++)
+	{
+		blocks.push_back(cachingPool.allocate(128));
+	}
+
+	std::thread([&cachingPool, &blocks]() {
+		for(auto* const cachedBlock : blocks)
+		{
+			cachingPool.deallocate(cachedBlock, 128);
+		}
+
+		ASSERT_EQ(cachingPool.getCachedBytes(), 8 * 128);
+	}).join();
+
+	ASSERT_EQ(cachingPool.getCachedBytes(), 0);
+
+	// tensors can be freed concurrently
+	const auto sharedPool = std::make_shared<mlCore::allocators::PoolAllocator>();
+
+	std::vector<std::thread> workers;
+	for(size_t workerIdx = 0; workerIdx < 4; workerIdx++)
+	{
+		workers.emplace_back([&sharedPool]() {
+			const mlCore::AllocatorScope scope(sharedPool);
+
+			for(size_t iteration = 0; iteration < 1000; iteration++)
+			{
+				const mlCore::Tensor tensor({16, 16}, 1.0);
+				const auto sum = tensor + tensor;
+
+				ASSERT_DOUBLE_EQ(*sum.begin(), 2.0);
+			}
+		});
+	}
+
+	for(auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+TEST_F(TestAllocators, testArena)
+{
+	mlCore::allocators::ArenaAllocator arena(1024);
+
+	auto* const firstBlock = static_cast<std::byte*>(arena.allocate(100));
+	auto* const secondBlock = static_cast<std::byte*>(arena.allocate(10));
+
+	// consecutive blocks are carved out of the same chunk
+	ASSERT_EQ(secondBlock, firstBlock + 128);
+	ASSERT_EQ(arena.getUsedBytes(), 192);
+	ASSERT_EQ(arena.getCapacity(), 1024);
+
+	// requests not fitting in the chunk get a new one
+	void* const bigBlock = arena.allocate(2000);
+	ASSERT_EQ(arena.getCapacity(), 1024 + 2048);
+
+	ASSERT_THROW(arena.reset(), std::runtime_error);
+
+	arena.deallocate(firstBlock, 100);
+	arena.deallocate(secondBlock, 10);
+	arena.deallocate(bigBlock, 2000);
+
+	// after the reset the chunks are merged, so that the same requests fit in one chunk
+	arena.reset();
+
+	ASSERT_EQ(arena.getUsedBytes(), 0);
+	ASSERT_EQ(arena.getCapacity(), 1024 + 2048);
+
+	arena.allocate(100);
+	arena.allocate(10);
+	arena.allocate(2000);
+
+	ASSERT_EQ(arena.getCapacity(), 1024 + 2048);
+}
+
+TEST_F(TestAllocators, testBufferAllocator)
+{
+	const auto fallback = std::make_shared<CountingAllocator>();
+
+	{
+		mlCore::allocators::BufferAllocator allocator(256, fallback);
+
+		// the buffer is taken from the fallback allocator on its first use
+		void* const firstBlock = allocator.allocate(200);
+
+		ASSERT_TRUE(isAligned(firstBlock));
+		ASSERT_TRUE(allocator.isLent());
+		ASSERT_EQ(fallback->nAllocations, 1);
+
+		// the requests coming while the buffer is lent or not fitting it are passed to the fallback allocator
+		void* const secondBlock = allocator.allocate(100);
+		void* const bigBlock = allocator.allocate(1000);
+
+		ASSERT_NE(secondBlock, firstBlock);
+		ASSERT_EQ(fallback->nAllocations, 3);
+
+		allocator.deallocate(firstBlock, 200);
+
+		ASSERT_FALSE(allocator.isLent());
+		ASSERT_EQ(allocator.allocate(256), firstBlock);
+		ASSERT_EQ(fallback->nAllocations, 3);
+
+		allocator.deallocate(firstBlock, 256);
+		allocator.deallocate(secondBlock, 100);
+		allocator.deallocate(bigBlock, 1000);
+
+		ASSERT_EQ(fallback->nDeallocations, 2);
+	}
+
+	// the buffer is given back together with the allocator
+	ASSERT_EQ(fallback->nDeallocations, 3);
+}
+
+TEST_F(TestAllocators, testAllocatorSelection)
+{
+	const auto globalAllocator = std::make_shared<CountingAllocator>();
+	const auto scopedAllocator = std::make_shared<CountingAllocator>();
+
+	mlCore::setGlobalAllocator(globalAllocator);
+	ASSERT_EQ(mlCore::getCurrentAllocator(), globalAllocator);
+
+	{
+		const mlCore::Tensor globalTensor({4, 4});
+
+		const mlCore::AllocatorScope scope(scopedAllocator);
+		ASSERT_EQ(mlCore::getCurrentAllocator(), scopedAllocator);
+
+		const mlCore::Tensor scopedTensor({4, 4});
+
+		{
+			// nullptr brings back the heap within the scope
+			const mlCore::AllocatorScope nestedScope(nullptr);
+			ASSERT_EQ(std::dynamic_pointer_cast<CountingAllocator>(mlCore::getCurrentAllocator()), nullptr);
+		}
+
+		ASSERT_EQ(mlCore::getCurrentAllocator(), scopedAllocator);
+		ASSERT_EQ(globalAllocator->nAllocations, 1);
+		ASSERT_EQ(scopedAllocator->nAllocations, 1);
+	}
+
+	// tensors give the memory back to the allocators they have been created with
+	ASSERT_EQ(globalAllocator->nDeallocations, 1);
+	ASSERT_EQ(scopedAllocator->nDeallocations, 1);
+
+	mlCore::setGlobalAllocator(nullptr);
+	ASSERT_EQ(std::dynamic_pointer_cast<CountingAllocator>(mlCore::getCurrentAllocator()), nullptr);
+}
+
+TEST_F(TestAllocators, testGraphAllocator)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto allocator = std::make_shared<CountingAllocator>();
+
+	const auto input = std::make_shared<Variable>(mlCore::Tensor({2, 2}, 3.0));
+	const auto output = binaryOperations::multiply(input, input);
+
+	ComputationGraph graph;
+	graph.setAllocator(allocator);
+	ASSERT_EQ(graph.getAllocator(), allocator);
+
+	graph.activate();
+	graph.addNode(input);
+	graph.addNode(output);
+
+	graph.forwardPass();
+
+	const size_t nForwardAllocations = allocator->nAllocations;
+	ASSERT_GT(nForwardAllocations, 0);
+
+	graph.computeGradients(output);
+
+	ASSERT_GT(allocator->nAllocations, nForwardAllocations);
+	ASSERT_DOUBLE_EQ(*graph.getGradientByNodeId(input->getIndex()).begin(), 6.0);
+
+	// the graph's allocator is not used outside of its passes
+	const size_t nAllocations = allocator->nAllocations;
+	const mlCore::Tensor tensor({2, 2});
+
+	ASSERT_EQ(allocator->nAllocations, nAllocations);
+}
+
+} // namespace
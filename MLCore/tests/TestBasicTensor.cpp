@@ -8,12 +8,14 @@
 
 #include <MLCore/BasicTensor.h>
 
+#include <functional>
 #include <iostream>
 
 #include <gtest/gtest.h>
 #include <fmt/format.h>
 
 #include <LoggingLib/LoggingLib.hpp>
+#include <MLCore/Parallelism.h>
 #include <MLCore/TensorInitializers/RangeTensorInitializer.hpp>
 
 namespace
@@ -263,6 +265,56 @@ TEST_F(TestBasicTensor, testCopy)
 	checkTensorEquality(tensor1, tensor3);
 }
 
+TEST_F(TestBasicTensor, testCopyOnWrite)
+{
+	using mlCore::tensorInitializers::RangeTensorInitializer;
+
+	// pointer to the first element obtained without detaching the storage
+	auto storageOf = [](const mlCore::Tensor& tensor) { return &*tensor.begin(); };
+
+	mlCore::Tensor original({2, 3});
+	original.fill(RangeTensorInitializer<double>(0));
+
+	const mlCore::Tensor expectedOriginal({2, 3}, {0, 1, 2, 3, 4, 5});
+
+	// each kind of modification should detach the modified copy and leave the others intact
+	const std::vector<std::pair<std::function<void(mlCore::Tensor&)>, mlCore::Tensor>> modifications{
+		{[](mlCore::Tensor& tensor) { tensor.assign({{0, 1}}, {7}, true); }, mlCore::Tensor({2, 3}, {7, 7, 7, 3, 4, 5})},
+		{[](mlCore::Tensor& tensor) { tensor.fill({1, 2}, true); }, mlCore::Tensor({2, 3}, {1, 2, 1, 2, 1, 2})},
+		{[](mlCore::Tensor& tensor) { tensor += tensor; }, mlCore::Tensor({2, 3}, {0, 2, 4, 6, 8, 10})},
+		{[](mlCore::Tensor& tensor) { tensor *= mlCore::Tensor(2.0); }, mlCore::Tensor({2, 3}, {0, 2, 4, 6, 8, 10})},
+		{[](mlCore::Tensor& tensor) { tensor -= mlCore::Tensor({3}, {1, 1, 1}); }, mlCore::Tensor({2, 3}, {-1, 0, 1, 2, 3, 4})},
+		{[](mlCore::Tensor& tensor) { *tensor.begin() = 10; }, mlCore::Tensor({2, 3}, {10, 1, 2, 3, 4, 5})}};
+
+	for(const auto& [modify, expected] : modifications)
+	{
+		mlCore::Tensor copy = original;
+		mlCore::Tensor secondCopy;
+		secondCopy = copy;
+
+		ASSERT_EQ(storageOf(copy), storageOf(original));
+		ASSERT_EQ(storageOf(secondCopy), storageOf(original));
+		ASSERT_TRUE(copy.sharesStorage(original));
+
+		modify(copy);
+
+		ASSERT_NE(storageOf(copy), storageOf(original));
+		ASSERT_EQ(storageOf(secondCopy), storageOf(original));
+		ASSERT_FALSE(copy.sharesStorage(original));
+		ASSERT_TRUE(secondCopy.sharesStorage(original));
+
+		checkTensorEquality(copy, expected);
+		checkTensorEquality(original, expectedOriginal);
+		checkTensorEquality(secondCopy, expectedOriginal);
+	}
+
+	// the only owner of the storage modifies it in place
+	const auto* const storageBefore = storageOf(original);
+	original += original;
+
+	ASSERT_EQ(storageOf(original), storageBefore);
+}
+
 TEST_F(TestBasicTensor, testMove)
 {
 	using mlCore::tensorInitializers::RangeTensorInitializer;
@@ -410,6 +462,90 @@ TEST_F(TestBasicTensor, testOperatorsWithBroadcastingInPlace)
 	checkTensorValues(tensor1, resValues);
 }
 
+TEST_F(TestBasicTensor, testOperatorsWithBroadcastingVariousShapes)
+{
+	using mlCore::tensorInitializers::RangeTensorInitializer;
+
+	// bias-like, scalar-like, interleaved and unit-dimension patterns
+	const std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> shapes{{{4, 5}, {5}},
+																				  {{5}, {4, 5}},
+																				  {{4, 5}, {4, 1}},
+																				  {{3, 1, 6}, {2, 1}},
+																				  {{2, 3, 4}, {1, 3, 1}},
+																				  {{}, {7}},
+																				  {{1}, {2, 3}}};
+
+	for(const auto& [firstShape, secondShape] : shapes)
+	{
+		mlCore::Tensor firstTensor(firstShape);
+		mlCore::Tensor secondTensor(secondShape);
+
+		firstTensor.fill(RangeTensorInitializer<double>(1.0));
+		secondTensor.fill(RangeTensorInitializer<double>(2.0, 0.5));
+
+		const std::vector<double> firstValues(firstTensor.begin(), firstTensor.end());
+		const std::vector<double> secondValues(secondTensor.begin(), secondTensor.end());
+
+		const size_t nDims = std::max(firstShape.size(), secondShape.size());
+		std::vector<size_t> firstPadded(nDims - firstShape.size(), 1);
+		std::vector<size_t> secondPadded(nDims - secondShape.size(), 1);
+		firstPadded.insert(firstPadded.end(), firstShape.begin(), firstShape.end());
+		secondPadded.insert(secondPadded.end(), secondShape.begin(), secondShape.end());
+
+		std::vector<size_t> resultShape(nDims);
+		size_t resultSize = 1;
+		for(size_t dim = 0; dim < nDims; dim++)
+		{
+			resultShape[dim] = std::max(firstPadded[dim], secondPadded[dim]);
+			resultSize *= resultShape[dim];
+		}
+
+		// naive reference computed from the multi-dimensional index of each output element
+		auto elementAt = [&resultShape, nDims](
+							 const std::vector<double>& values, const std::vector<size_t>& paddedShape, size_t pos) {
+			size_t offset = 0;
+			size_t factor = 1;
+			for(size_t dim = nDims - 1; dim < nDims; dim--)
+			{
+				const size_t index = pos % resultShape[dim];
+				pos /= resultShape[dim];
+				offset += (paddedShape[dim] == 1 ? 0 : index) * factor;
+				factor *= paddedShape[dim];
+			}
+			return values[offset];
+		};
+
+		const std::vector<std::pair<mlCore::Tensor, std::function<double(double, double)>>> results{
+			{firstTensor + secondTensor, std::plus<double>()},
+			{firstTensor - secondTensor, std::minus<double>()},
+			{firstTensor * secondTensor, std::multiplies<double>()},
+			{firstTensor / secondTensor, std::divides<double>()}};
+
+		for(const auto& [result, operation] : results)
+		{
+			ASSERT_EQ(result.shape(), resultShape);
+
+			std::vector<double> expectedValues;
+			for(size_t pos = 0; pos < resultSize; pos++)
+			{
+				expectedValues.push_back(
+					operation(elementAt(firstValues, firstPadded, pos), elementAt(secondValues, secondPadded, pos)));
+			}
+
+			checkTensorValues(result, expectedValues);
+		}
+	}
+}
+
+TEST_F(TestBasicTensor, testOperatorsWithIncompatibleShapes)
+{
+	const mlCore::Tensor firstTensor(std::vector<size_t>{2, 3});
+	const mlCore::Tensor secondTensor(std::vector<size_t>{4});
+
+	EXPECT_THROW(firstTensor + secondTensor, std::runtime_error);
+	EXPECT_THROW(secondTensor * firstTensor, std::runtime_error);
+}
+
 TEST_F(TestBasicTensor, testOperationsWithScalarTensor)
 {
 	const std::vector<size_t> shape{2, 3};
@@ -430,6 +566,63 @@ TEST_F(TestBasicTensor, testOperationsWithScalarTensor)
 	checkTensorValues(tensor, expectedValues);
 }
 
+TEST_F(TestBasicTensor, testOperatorsReusingExpiringOperands)
+{
+	// pointer to the first element obtained without detaching the storage
+	auto storageOf = [](const mlCore::Tensor& tensor) { return &*tensor.begin(); };
+
+	const mlCore::Tensor first({2, 3}, {1, 2, 3, 4, 5, 6});
+	const mlCore::Tensor second({2, 3}, {6, 5, 4, 3, 2, 1});
+	const mlCore::Tensor row({3}, {1, 2, 4});
+
+	// the expiring left operand holds the result
+	auto product = first * second;
+	const auto* const productStorage = storageOf(product);
+
+	const auto sum = std::move(product) + row;
+
+	ASSERT_EQ(storageOf(sum), productStorage);
+	checkTensorValues(sum, {7, 12, 16, 13, 12, 10});
+
+	// the expiring right operand holds the result, also for non-commutative operations
+	auto quotient = second / first;
+	const auto* const quotientStorage = storageOf(quotient);
+
+	const auto difference = row - std::move(quotient);
+
+	ASSERT_EQ(storageOf(difference), quotientStorage);
+	checkTensorValues(difference, {-5, -0.5, 4 - 4.0 / 3, 0.25, 1.6, 4 - 1.0 / 6});
+
+	// both operands expiring
+	auto lhs = first + first;
+	auto rhs = second + second;
+	const auto* const lhsStorage = storageOf(lhs);
+
+	const auto both = std::move(lhs) - std::move(rhs);
+
+	ASSERT_EQ(storageOf(both), lhsStorage);
+	checkTensorValues(both, {-10, -6, -2, 2, 6, 10});
+
+	// operands which would have to be stretched or whose storage is shared are not overwritten
+	auto expiringRow = row * 2.0;
+	const auto* const rowStorage = storageOf(expiringRow);
+
+	const auto stretched = std::move(expiringRow) + first;
+
+	ASSERT_NE(storageOf(stretched), rowStorage);
+	checkTensorValues(stretched, {3, 6, 11, 6, 9, 14});
+
+	mlCore::Tensor copy = first;
+	const auto fromCopy = std::move(copy) * second;
+
+	ASSERT_NE(storageOf(fromCopy), storageOf(first));
+	checkTensorValues(first, {1, 2, 3, 4, 5, 6});
+	checkTensorValues(fromCopy, {6, 10, 12, 12, 10, 6});
+
+	// chained expression
+	checkTensorValues(first * second + row - first / second, {6.0 + 1 - 1.0 / 6, 12 - 0.4, 16 - 0.75, 13 - 4.0 / 3, 12 - 2.5, 10 - 6});
+}
+
 TEST_F(TestBasicTensor, testMatrixMultiplicationClassicMatrices)
 {
 	using mlCore::tensorInitializers::RangeTensorInitializer;
@@ -466,6 +659,125 @@ TEST_F(TestBasicTensor, testMatrixMultiplicationExtended)
 	checkTensorValues(result, expectedValues);
 }
 
+TEST_F(TestBasicTensor, testMatrixMultiplicationBlocked)
+{
+	using mlCore::tensorInitializers::RangeTensorInitializer;
+
+	// shapes crossing the micro-tile and cache blocks boundaries, including batch broadcasting between different ranks
+	const std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> shapes{
+		{{130, 300}, {300, 21}}, {{2, 3, 37, 41}, {3, 41, 19}}, {{3, 1, 45, 33}, {2, 33, 50}}};
+
+	for(const auto& [firstShape, secondShape] : shapes)
+	{
+		mlCore::Tensor firstTensor(firstShape);
+		mlCore::Tensor secondTensor(secondShape);
+
+		firstTensor.fill(RangeTensorInitializer<double>(-1.0, 1e-3));
+		secondTensor.fill(RangeTensorInitializer<double>(1.0, -1e-3));
+
+		const auto result = firstTensor.matmul(secondTensor);
+
+		const size_t nDims = result.nDimensions();
+		const size_t nRows = result.shape()[nDims - 2];
+		const size_t nCols = result.shape()[nDims - 1];
+		const size_t adjacent = *firstShape.rbegin();
+
+		// naive reference computed frame by frame with broadcasting of the batch dimensions
+		std::vector<double> expectedValues;
+		std::vector<size_t> batchPath(nDims - 2, 0);
+		const std::vector<double> firstValues(firstTensor.begin(), firstTensor.end());
+		const std::vector<double> secondValues(secondTensor.begin(), secondTensor.end());
+
+		auto frameOffset = [&batchPath, nDims](const std::vector<size_t>& shape) {
+			const size_t padding = nDims - shape.size();
+			size_t offset = 0;
+			for(size_t i = padding; i < nDims - 2; i++)
+			{
+				offset = offset * shape[i - padding] + (shape[i - padding] == 1 ? 0 : batchPath[i]);
+			}
+			return offset * shape[shape.size() - 1] * shape[shape.size() - 2];
+		};
+
+		for(size_t frame = 0; frame < result.size() / (nRows * nCols); frame++)
+		{
+			const size_t firstOffset = frameOffset(firstShape);
+			const size_t secondOffset = frameOffset(secondShape);
+
+			for(size_t row = 0; row < nRows; row++)
+			{
+				for(size_t col = 0; col < nCols; col++)
+				{
+					double sum = 0;
+					for(size_t mul = 0; mul < adjacent; mul++)
+					{
+						sum += firstValues[firstOffset + row * adjacent + mul] * secondValues[secondOffset + mul * nCols + col];
+					}
+					expectedValues.push_back(sum);
+				}
+			}
+
+			for(size_t i = nDims - 3; i < nDims - 2; i--)
+			{
+				if(++batchPath[i] < result.shape()[i])
+				{
+					break;
+				}
+				batchPath[i] = 0;
+			}
+		}
+
+		ASSERT_EQ(result.size(), expectedValues.size());
+
+		auto expectedIter = expectedValues.cbegin();
+		for(const auto value : result)
+		{
+			ASSERT_NEAR(value, *expectedIter, 1e-9);
+			expectedIter++;
+		}
+	}
+}
+
+TEST_F(TestBasicTensor, testMatrixMultiplicationMultithreaded)
+{
+	using mlCore::tensorInitializers::RangeTensorInitializer;
+
+	// single frame split into row/column tiles and a batch of small frames
+	const std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> shapes{{{300, 257}, {257, 1100}},
+																				  {{8, 40, 50}, {50, 60}}};
+
+	const auto globalPool = std::make_shared<utilities::ThreadPool>(4);
+	const auto scopedPool = std::make_shared<utilities::ThreadPool>(3);
+
+	for(const auto& [firstShape, secondShape] : shapes)
+	{
+		mlCore::Tensor firstTensor(firstShape);
+		mlCore::Tensor secondTensor(secondShape);
+
+		firstTensor.fill(RangeTensorInitializer<double>(-1.0, 1e-4));
+		secondTensor.fill(RangeTensorInitializer<double>(1.0, -1e-4));
+
+		const auto serialResult = firstTensor.matmul(secondTensor);
+
+		mlCore::setGlobalThreadPool(globalPool);
+		const auto globalPoolResult = firstTensor.matmul(secondTensor);
+
+		{
+			mlCore::ThreadPoolScope scope(scopedPool);
+			ASSERT_EQ(mlCore::getCurrentThreadPool(), scopedPool);
+
+			const auto scopedPoolResult = firstTensor.matmul(secondTensor);
+
+			// the results should not depend on the number of threads
+			ASSERT_TRUE(std::equal(serialResult.begin(), serialResult.end(), scopedPoolResult.begin()));
+		}
+
+		ASSERT_EQ(mlCore::getCurrentThreadPool(), globalPool);
+		mlCore::setGlobalThreadPool(nullptr);
+
+		ASSERT_TRUE(std::equal(serialResult.begin(), serialResult.end(), globalPoolResult.begin()));
+	}
+}
+
 TEST_F(TestBasicTensor, testTransposition)
 {
 	using mlCore::tensorInitializers::RangeTensorInitializer;
@@ -488,4 +800,55 @@ TEST_F(TestBasicTensor, testTransposition)
 	checkTensorValues(tensor.transposed(), expectedValues);
 }
 
+TEST_F(TestBasicTensor, testOtherValueTypes)
+{
+	// float
+	const mlCore::FloatTensor floatMatrix({2, 3}, {1, 2, 3, 4, 5, 6});
+	const mlCore::FloatTensor floatRow({3}, {0.5F, -1, 2});
+
+	const auto floatResult = (floatMatrix + floatRow) / floatRow;
+	const std::vector<float> expectedFloat{3, -1, 2.5F, 9, -4, 4};
+
+	ASSERT_TRUE(std::equal(floatResult.begin(), floatResult.end(), expectedFloat.begin()));
+
+	const auto floatProduct = floatMatrix.matmul(floatMatrix.transposed());
+	const std::vector<float> expectedFloatProduct{14, 32, 32, 77};
+
+	ASSERT_TRUE(std::equal(floatProduct.begin(), floatProduct.end(), expectedFloatProduct.begin()));
+
+	// int32
+	mlCore::Int32Tensor intMatrix({2, 2}, {7, -8, 9, 10});
+	intMatrix /= mlCore::Int32Tensor(3);
+	intMatrix += mlCore::Int32Tensor({2}, {1, 2});
+
+	const std::vector<int32_t> expectedInt{3, 0, 4, 5};
+
+	ASSERT_TRUE(std::equal(intMatrix.begin(), intMatrix.end(), expectedInt.begin()));
+
+	const auto intProduct = intMatrix.matmul(intMatrix);
+	const std::vector<int32_t> expectedIntProduct{9, 0, 32, 25};
+
+	ASSERT_TRUE(std::equal(intProduct.begin(), intProduct.end(), expectedIntProduct.begin()));
+
+	// bfloat16 is rounded to 8 bits of precision, ties to even
+	ASSERT_EQ(float(mlCore::BFloat16(1.0F + 1.0F / 256)), 1.0F);
+	ASSERT_EQ(float(mlCore::BFloat16(1.0F + 3.0F / 256)), 1.0F + 4.0F / 256);
+	ASSERT_EQ(float(-mlCore::BFloat16(2.5F)), -2.5F);
+
+	const mlCore::BFloat16Tensor bfloatTensor({3}, {1.5F, -2, 4});
+	const auto bfloatResult = bfloatTensor * bfloatTensor - mlCore::BFloat16Tensor(0.25F);
+	const std::vector<float> expectedBFloat{2, 3.75F, 15.75F};
+
+	ASSERT_TRUE(std::equal(bfloatResult.begin(),
+						   bfloatResult.end(),
+						   expectedBFloat.begin(),
+						   [](const mlCore::BFloat16 value, const float expected) { return float(value) == expected; }));
+
+	// the products are accumulated in float - in bfloat16 the sum would stop growing at 256
+	const mlCore::BFloat16Tensor ones({1, 1000}, 1.0F);
+	const auto dotProduct = ones.matmul(ones.transposed());
+
+	ASSERT_EQ(float(*dotProduct.begin()), 1000.0F);
+}
+
 } // namespace
\ No newline at end of file
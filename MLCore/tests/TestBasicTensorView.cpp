@@ -0,0 +1,207 @@
+/**********************
+ * Test suite for 'ai_projects'
+ *
+ * Copyright (c) 2023
+ *
+ * by Wiktor Prosowicz
+ **********************/
+
+#include <MLCore/BasicTensorView.h>
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <MLCore/TensorInitializers/RangeTensorInitializer.hpp>
+
+namespace
+{
+
+/*****************************
+ *
+ * Test Fixture
+ *
+ *****************************/
+
+class TestBasicTensorView : public testing::Test
+{
+protected:
+	/// Checks if the view contains the expected values in row-major order.
+	static void checkViewContents(const mlCore::TensorView& view,
+								  const std::vector<size_t>& expectedShape,
+								  const std::vector<double>& expectedValues)
+	{
+		ASSERT_EQ(view.shape(), expectedShape);
+		ASSERT_EQ(view.size(), expectedValues.size());
+
+		const auto materialized = view.contiguous();
+
+		ASSERT_EQ(materialized.shape(), expectedShape);
+		ASSERT_TRUE(std::equal(materialized.begin(), materialized.end(), expectedValues.begin()));
+	}
+
+	/// Checks if tensors have equal shapes and contents.
+	static void checkTensorEquality(const mlCore::Tensor& tensor1, const mlCore::Tensor& tensor2)
+	{
+		ASSERT_EQ(tensor1.shape(), tensor2.shape());
+
+		for(auto iter1 = tensor1.begin(), iter2 = tensor2.begin(); iter1 < tensor1.end(); iter1++, iter2++)
+		{
+			EXPECT_DOUBLE_EQ(*iter1, *iter2);
+		}
+	}
+
+	/// Creates tensor filled with consecutive values starting from 0.
+	static mlCore::Tensor makeRangeTensor(const std::vector<size_t>& shape)
+	{
+		mlCore::Tensor tensor(shape);
+		tensor.fill(mlCore::tensorInitializers::RangeTensorInitializer<double>(0.0));
+
+		return tensor;
+	}
+};
+
+/*****************************
+ *
+ * Particular test calls
+ *
+ *****************************/
+
+TEST_F(TestBasicTensorView, testViewSharesStorage)
+{
+	auto tensor = makeRangeTensor({2, 3});
+	const mlCore::TensorView view(tensor);
+
+	ASSERT_EQ(view.data(), &*std::as_const(tensor).begin());
+	ASSERT_TRUE(view.isContiguous());
+	ASSERT_EQ(view.strides(), std::vector<size_t>({3, 1}));
+
+	const auto transposed = view.transposed();
+	const auto sliced = view.sliced(1, 1, 3);
+
+	ASSERT_EQ(transposed.data(), view.data());
+	ASSERT_EQ(sliced.data(), view.data() + 1);
+	ASSERT_FALSE(transposed.isContiguous());
+	ASSERT_FALSE(sliced.isContiguous());
+
+	// the modified tensor gets its own copy of the storage, so the views are not affected
+	tensor.assign({{1, 2}, {2, 3}}, {100.0});
+	ASSERT_NE(view.data(), &*std::as_const(tensor).begin());
+	ASSERT_DOUBLE_EQ(transposed.at({2, 1}), 5.0);
+	ASSERT_DOUBLE_EQ(sliced.at({1, 1}), 5.0);
+
+	// the views keep the storage alive
+	tensor = mlCore::Tensor();
+	checkViewContents(transposed, {3, 2}, {0, 3, 1, 4, 2, 5});
+}
+
+TEST_F(TestBasicTensorView, testViewOperations)
+{
+	const auto tensor = makeRangeTensor({2, 3, 4});
+	const mlCore::TensorView view(tensor);
+
+	checkViewContents(
+		view.transposed(), {2, 4, 3}, {0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11, 12, 16, 20, 13, 17, 21, 14, 18, 22, 15, 19, 23});
+
+	checkViewContents(view.permuted({2, 0, 1}),
+					  {4, 2, 3},
+					  {0, 4, 8, 12, 16, 20, 1, 5, 9, 13, 17, 21, 2, 6, 10, 14, 18, 22, 3, 7, 11, 15, 19, 23});
+
+	checkViewContents(view.sliced(2, 1, 3), {2, 3, 2}, {1, 2, 5, 6, 9, 10, 13, 14, 17, 18, 21, 22});
+	checkViewContents(view.sliced(0, 1, 2).squeezed(0).sliced(0, 2, 3), {1, 4}, {20, 21, 22, 23});
+
+	checkViewContents(view.sliced(1, 0, 1).squeezed(1), {2, 4}, {0, 1, 2, 3, 12, 13, 14, 15});
+	checkViewContents(view.sliced(1, 0, 1).squeezed(1).unsqueezed(0), {1, 2, 4}, {0, 1, 2, 3, 12, 13, 14, 15});
+
+	checkViewContents(view.sliced(2, 0, 1).squeezed(2).sliced(0, 0, 1).broadcastedTo({2, 2, 3}),
+					  {2, 2, 3},
+					  {0, 4, 8, 0, 4, 8, 0, 4, 8, 0, 4, 8});
+
+	// reshaping a contiguous view does not copy the data
+	const auto reshaped = view.reshaped({6, 4});
+	ASSERT_EQ(reshaped.data(), view.data());
+	ASSERT_TRUE(reshaped.isContiguous());
+
+	// reshaping a non-contiguous view has to materialize it first
+	checkViewContents(view.sliced(2, 3, 4).reshaped({3, 2}), {3, 2}, {3, 7, 11, 15, 19, 23});
+}
+
+TEST_F(TestBasicTensorView, testOperatorsOnViews)
+{
+	const auto lhs = makeRangeTensor({3, 2});
+	const auto rhs = makeRangeTensor({2, 3});
+
+	const auto rhsTransposed = mlCore::TensorView(rhs).transposed();
+
+	checkTensorEquality(mlCore::TensorView(lhs) + rhsTransposed, lhs + rhs.transposed());
+	checkTensorEquality(mlCore::TensorView(lhs) - rhsTransposed, lhs - rhs.transposed());
+	checkTensorEquality(mlCore::TensorView(lhs) * rhsTransposed, lhs * rhs.transposed());
+	checkTensorEquality(rhsTransposed / mlCore::TensorView(lhs).sliced(1, 1, 2),
+						rhs.transposed() / mlCore::Tensor({3, 1}, {1, 3, 5}));
+
+	// broadcasting of a strided operand
+	checkTensorEquality(rhsTransposed.sliced(1, 0, 1) + mlCore::TensorView(lhs),
+						mlCore::Tensor({3, 2}, {0, 1, 3, 4, 6, 7}));
+}
+
+TEST_F(TestBasicTensorView, testMatrixMultiplicationWithTransposedViews)
+{
+	const std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> shapes{
+		{{5, 7}, {9, 7}}, {{3, 40, 50}, {60, 50}}, {{2, 1, 4, 3}, {3, 5, 3}}, {{70, 80}, {90, 80}}};
+
+	for(const auto& [lhsShape, rhsShape] : shapes)
+	{
+		auto lhs = makeRangeTensor(lhsShape);
+		auto rhs = makeRangeTensor(rhsShape);
+
+		const auto viewResult = lhs.matmul(mlCore::TensorView(rhs).transposed());
+		const auto copyResult = lhs.matmul(rhs.transposed());
+
+		checkTensorEquality(viewResult, copyResult);
+
+		// both operands transposed
+		auto lhsTransposed = lhs.transposed();
+		checkTensorEquality(mlCore::TensorView(lhsTransposed).transposed().matmul(mlCore::TensorView(rhs).transposed()),
+							copyResult);
+	}
+
+	// broadcast batch dimension expressed with a zero stride
+	const auto lhs = makeRangeTensor({4, 3});
+	const auto rhs = makeRangeTensor({3, 2});
+
+	const auto batchedResult = mlCore::TensorView(lhs).unsqueezed(0).broadcastedTo({3, 4, 3}).matmul(rhs);
+	const auto frameResult = lhs.matmul(rhs);
+
+	ASSERT_EQ(batchedResult.shape(), std::vector<size_t>({3, 4, 2}));
+
+	for(size_t frame = 0; frame < 3; frame++)
+	{
+		const auto frameBegin = std::next(batchedResult.begin(), static_cast<ptrdiff_t>(frame * frameResult.size()));
+
+		ASSERT_TRUE(std::equal(frameResult.begin(), frameResult.end(), frameBegin));
+	}
+}
+
+TEST_F(TestBasicTensorView, testInvalidViewOperations)
+{
+	const auto tensor = makeRangeTensor({2, 3});
+	const mlCore::TensorView view(tensor);
+
+	ASSERT_THROW(view.at({0}), std::out_of_range);
+	ASSERT_THROW(view.at({2, 0}), std::out_of_range);
+	ASSERT_THROW(view.sliced(2, 0, 1), std::out_of_range);
+	ASSERT_THROW(view.sliced(1, 2, 4), std::out_of_range);
+	ASSERT_THROW(view.sliced(1, 2, 2), std::out_of_range);
+	ASSERT_THROW(view.permuted({0, 0}), std::out_of_range);
+	ASSERT_THROW(view.unsqueezed(3), std::out_of_range);
+	ASSERT_THROW(view.reshaped({4, 2}), std::out_of_range);
+
+	ASSERT_THROW(view.squeezed(0), std::runtime_error);
+	ASSERT_THROW(view.broadcastedTo({3}), std::runtime_error);
+	ASSERT_THROW(view.broadcastedTo({2, 2}), std::runtime_error);
+	ASSERT_THROW(view.sliced(0, 0, 1).squeezed(0).transposed(), std::runtime_error);
+	ASSERT_THROW(view.matmul(view), std::runtime_error);
+	ASSERT_THROW(view + view.transposed(), std::runtime_error);
+}
+
+} // namespace
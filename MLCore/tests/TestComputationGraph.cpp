@@ -8,14 +8,17 @@
 #include <AutoDiff/ComputationGraph.h>
 
 #include <sstream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
 #include <AutoDiff/BinaryOperators/BinaryOperator.h>
 #include <AutoDiff/UnaryOperators/UnaryOperator.h>
 #include <AutoDiff/GraphOperations.h>
+#include <MLCore/Allocation.h>
 #include <MLCore/TensorInitializers/RangeTensorInitializer.hpp>
 #include <MLCore/TensorInitializers/GaussianInitializer.hpp>
+#include <MLCore/TensorOperations.h>
 
 namespace
 {
@@ -679,4 +682,1202 @@ TEST_F(TestComputationGraph, testGradientDescentSimulation)
 	performGradientDescent(wrappedTree, trainableWeights, input);
 }
 
-} // namespace
\ No newline at end of file
+TEST_F(TestComputationGraph, testCompiledExecutionPlan)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2}, {0.5, -1.0}));
+	const auto product = binaryOperations::multiply(input, weight);
+	const auto activation = nodesActivations::sigmoid(product);
+	const auto output = unaryOperations::ln(activation);
+
+	graph_->activate();
+
+	for(const auto& node : std::vector<NodePtr>{output, weight, activation, input, product})
+	{
+		graph_->addNode(node);
+	}
+
+	const auto& instructions = graph_->compile().getInstructions();
+
+	ASSERT_EQ(instructions.size(), 3);
+	ASSERT_EQ(instructions[0].opCode, OpCode::MULTIPLY);
+	ASSERT_EQ(instructions[1].opCode, OpCode::SIGMOID);
+	ASSERT_EQ(instructions[2].opCode, OpCode::LN);
+	ASSERT_EQ(instructions[1].inputs[0], instructions[0].output);
+	ASSERT_EQ(instructions[2].inputs[0], instructions[1].output);
+
+	const mlCore::Tensor inputValue({2}, {1.0, 2.0});
+
+	graph_->forwardPass({{input, inputValue}});
+	graph_->computeGradients(output);
+
+	// d/dw ln(sigmoid(x * w)) = (1 - sigmoid(x * w)) * x
+	const mlCore::Tensor expectedGradient = (mlCore::Tensor(1.0) - activation->getValue()) * inputValue;
+	const auto& weightGradient = graph_->getGradientByNodeId(weight->getIndex());
+
+	ASSERT_EQ(weightGradient.shape(), expectedGradient.shape());
+
+	for(auto gradIter = weightGradient.begin(), expectedIter = expectedGradient.begin(); gradIter < weightGradient.end();
+		gradIter++, expectedIter++)
+	{
+		ASSERT_NEAR(*gradIter, *expectedIter, 1e-12);
+	}
+
+	// adding a node invalidates the plan
+	graph_->addNode(binaryOperations::add(output, weight));
+
+	ASSERT_EQ(graph_->compile().getInstructions().size(), 4);
+}
+
+TEST_F(TestComputationGraph, testSortingSharedAndDeepGraphs)
+{
+	using namespace mlCore::autoDiff;
+
+	// each level uses the previous one twice, so there are 2^40 paths from the root to the input
+	const auto input = std::make_shared<Variable>(mlCore::Tensor({2}, {1.0, -2.0}));
+	std::vector<NodePtr> diamondNodes{input};
+
+	for(size_t level = 0; level < 40; level++)
+	{
+		diamondNodes.push_back(binaryOperations::add(diamondNodes.back(), diamondNodes.back()));
+	}
+
+	graph_->activate();
+
+	// the root is added first, so the order is built by the sorting
+	for(auto node = diamondNodes.crbegin(); node != diamondNodes.crend(); node++)
+	{
+		graph_->addNode(*node);
+	}
+
+	graph_->forwardPass();
+	graph_->computeGradients(diamondNodes.back());
+
+	const auto& gradient = graph_->getGradientByNodeId(input->getIndex());
+
+	for(const auto value : gradient)
+	{
+		ASSERT_DOUBLE_EQ(value, std::pow(2.0, 40));
+	}
+
+	// a long chain added in order extends the compiled plan
+	graph_->reset();
+
+	const auto chainInput = std::make_shared<Variable>(mlCore::Tensor({1}, {1.0}));
+	NodePtr chainOutput = chainInput;
+
+	graph_->addNode(chainInput);
+	graph_->compile();
+
+	for(size_t pos = 0; pos < 20000; pos++)
+	{
+		chainOutput = binaryOperations::multiply(chainOutput, chainInput);
+		graph_->addNode(chainOutput);
+	}
+
+	const auto& plan = graph_->compile();
+
+	ASSERT_EQ(plan.getInstructions().size(), 20000);
+	ASSERT_EQ(plan.getInstructions().back().output, *plan.findSlot(chainOutput.get()));
+
+	graph_->forwardPass();
+
+	ASSERT_DOUBLE_EQ(*chainOutput->getValue().begin(), 1.0);
+}
+
+TEST_F(TestComputationGraph, testGradientAccumulation)
+{
+	using namespace mlCore::autoDiff;
+
+	// y = x * x + x, so dy/dx = 2x + 1 is collected from three uses of x
+	const auto input = std::make_shared<Variable>(mlCore::Tensor({3}, {1.0, -2.0, 0.5}));
+	const auto square = binaryOperations::multiply(input, input);
+	const auto output = binaryOperations::add(square, input);
+
+	graph_->activate();
+	graph_->addNode(input);
+	graph_->addNode(square);
+	graph_->addNode(output);
+
+	graph_->forwardPass();
+
+	const auto checkGradient = [this, &input](const std::vector<double>& expected) {
+		const auto& gradient = graph_->getGradientByNodeId(input->getIndex());
+
+		ASSERT_TRUE(std::equal(gradient.begin(), gradient.end(), expected.begin(), expected.end()));
+	};
+
+	graph_->computeGradients(output);
+	checkGradient({3.0, -3.0, 2.0});
+
+	// gradients of the consecutive passes are summed up until cleared
+	graph_->computeGradients(output);
+	checkGradient({6.0, -6.0, 4.0});
+
+	graph_->clearGradients();
+	graph_->computeGradients(output);
+	checkGradient({3.0, -3.0, 2.0});
+
+	// the inputs' values are not modified by the accumulation
+	ASSERT_TRUE(std::equal(input->getValue().begin(), input->getValue().end(), std::vector<double>{1.0, -2.0, 0.5}.begin()));
+}
+
+TEST_F(TestComputationGraph, testGradientPruning)
+{
+	using namespace mlCore::autoDiff;
+
+	// the logarithm of the negative base would make the exponent's gradient NaN
+	const auto base = std::make_shared<Variable>(mlCore::Tensor({2}, {-2.0, 3.0}));
+	const auto exponent = std::make_shared<Constant>(mlCore::Tensor({2}, {2.0, 2.0}));
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2}, {0.5, 4.0}));
+	const auto power = binaryOperations::power(base, exponent);
+	const auto scaled = binaryOperations::multiply(input, weight);
+	const auto output = binaryOperations::add(power, scaled);
+
+	graph_->activate();
+
+	for(const auto& node : std::vector<NodePtr>{base, exponent, input, weight, power, scaled, output})
+	{
+		graph_->addNode(node);
+	}
+
+	graph_->forwardPass({{input, mlCore::Tensor({2}, {1.0, -1.0})}});
+
+	const auto checkGradient = [this](const NodePtr& node, const std::vector<double>& expected) {
+		ASSERT_TRUE(graph_->hasGradient(node->getIndex()));
+
+		const auto& gradient = graph_->getGradientByNodeId(node->getIndex());
+
+		ASSERT_TRUE(std::equal(gradient.begin(), gradient.end(), expected.begin(), expected.end()));
+	};
+
+	// placeholders and constants do not require gradient
+	graph_->computeGradients(output);
+
+	checkGradient(base, {-4.0, 6.0});
+	checkGradient(weight, {1.0, -1.0});
+	ASSERT_FALSE(graph_->hasGradient(exponent->getIndex()));
+	ASSERT_FALSE(graph_->hasGradient(input->getIndex()));
+
+	// only the subgraph leading to the requested nodes is visited
+	graph_->clearGradients();
+	graph_->computeGradients(output, {input});
+
+	checkGradient(input, {0.5, 4.0});
+	ASSERT_FALSE(graph_->hasGradient(base->getIndex()));
+	ASSERT_FALSE(graph_->hasGradient(weight->getIndex()));
+	ASSERT_FALSE(graph_->hasGradient(power->getIndex()));
+
+	// disabling the gradient of an operator stops the backpropagation
+	graph_->clearGradients();
+	scaled->setRequiresGrad(false);
+	graph_->computeGradients(output);
+
+	checkGradient(base, {-4.0, 6.0});
+	ASSERT_FALSE(graph_->hasGradient(weight->getIndex()));
+}
+
+TEST_F(TestComputationGraph, testGradientLookup)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2}, {1.0, 2.0}));
+	const auto bias = std::make_shared<Variable>(mlCore::Tensor({2}, {3.0, 4.0}));
+	const auto product = binaryOperations::multiply(weight, weight);
+	const auto output = binaryOperations::add(product, bias);
+
+	weight->setName("weight");
+
+	graph_->activate();
+
+	for(const auto& node : std::vector<NodePtr>{weight, bias, product, output})
+	{
+		graph_->addNode(node);
+	}
+
+	// the node is renamed after being added to the graph
+	bias->setName("bias");
+
+	graph_->forwardPass();
+	graph_->computeGradients(output);
+
+	ASSERT_TRUE(graph_->hasGradient("weight"));
+	ASSERT_TRUE(graph_->hasGradient("bias"));
+	ASSERT_FALSE(graph_->hasGradient("missing"));
+	ASSERT_TRUE(graph_->hasGradient(bias->getIndex()));
+
+	const auto& weightGradient = graph_->getGradientByNodeName("weight");
+	const auto& biasGradient = graph_->getGradientByNodeId(bias->getIndex());
+
+	ASSERT_TRUE(std::equal(weightGradient.begin(), weightGradient.end(), std::vector<double>{2.0, 4.0}.begin()));
+	ASSERT_TRUE(std::equal(biasGradient.begin(), biasGradient.end(), std::vector<double>{1.0, 1.0}.begin()));
+
+	// all gradients in the order of adding the nodes
+	const auto gradients = graph_->getGradients();
+
+	ASSERT_EQ(gradients.size(), 4);
+	ASSERT_EQ(gradients[0].first, weight);
+	ASSERT_EQ(&gradients[0].second.get(), &weightGradient);
+	ASSERT_EQ(gradients[1].first, bias);
+	ASSERT_EQ(gradients[3].first, output);
+
+	graph_->clearGradients();
+
+	ASSERT_FALSE(graph_->hasGradient("weight"));
+	ASSERT_TRUE(graph_->getGradients().empty());
+	ASSERT_THROW(graph_->getGradientByNodeId(weight->getIndex()), std::runtime_error);
+}
+
+TEST_F(TestComputationGraph, testConcurrentScheduling)
+{
+	using namespace mlCore::autoDiff;
+
+	// independent towers sharing the weight, so that its gradient is accumulated from concurrently run operators
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2, 2}, {0.5, -1.0, 2.0, 0.25}));
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 2});
+
+	std::vector<NodePtr> nodes{weight, input};
+	NodePtr output = nullptr;
+
+	for(size_t towerIdx = 0; towerIdx < 16; towerIdx++)
+	{
+		const auto bias = std::make_shared<Variable>(mlCore::Tensor({2, 2}, static_cast<double>(towerIdx) / 8.0));
+		const auto product = binaryOperations::matmul(input, weight);
+		const auto shifted = binaryOperations::add(product, bias);
+		const auto activation = nodesActivations::sigmoid(shifted);
+
+		output = output ? binaryOperations::add(output, activation) : activation;
+
+		nodes.insert(nodes.end(), {bias, product, shifted, activation, output});
+	}
+
+	graph_->activate();
+
+	for(const auto& node : nodes)
+	{
+		graph_->addNode(node);
+	}
+
+	const mlCore::Tensor inputValue({2, 2}, {1.0, -2.0, 0.5, 3.0});
+
+	// runs both passes and collects the output and the gradients in the order of the nodes
+	const auto runPasses = [this, &input, &output, &inputValue]() {
+		graph_->clearGradients();
+		graph_->forwardPass({{input, inputValue}});
+		graph_->computeGradients(output);
+
+		std::vector<mlCore::Tensor> results{output->getValue()};
+
+		for(const auto& [node, gradient] : graph_->getGradients())
+		{
+			results.push_back(gradient.get());
+		}
+
+		return results;
+	};
+
+	const auto expected = runPasses();
+
+	const auto threadPool = std::make_shared<utilities::ThreadPool>(4);
+	graph_->setInterOpThreadPool(threadPool);
+	graph_->setIntraOpThreadPool(threadPool);
+
+	ASSERT_EQ(graph_->getInterOpThreadPool(), threadPool);
+	ASSERT_EQ(graph_->getIntraOpThreadPool(), threadPool);
+
+	for(size_t runIdx = 0; runIdx < 10; runIdx++)
+	{
+		const auto results = runPasses();
+
+		ASSERT_EQ(results.size(), expected.size());
+
+		for(size_t resultIdx = 0; resultIdx < results.size(); resultIdx++)
+		{
+			ASSERT_EQ(results[resultIdx].shape(), expected[resultIdx].shape());
+
+			for(auto resultIter = results[resultIdx].begin(), expectedIter = expected[resultIdx].begin();
+				resultIter < results[resultIdx].end();
+				resultIter++, expectedIter++)
+			{
+				ASSERT_NEAR(*resultIter, *expectedIter, 1e-12);
+			}
+		}
+	}
+
+	// the placeholder's shape mismatch is reported by the concurrently run operators to the caller
+	ASSERT_ANY_THROW(graph_->forwardPass({{input, mlCore::Tensor({3, 3}, 1.0)}}));
+}
+
+TEST_F(TestComputationGraph, testExecutionContexts)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{1, 2});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2, 2}, {0.5, -1.0, 2.0, 0.25}));
+	const auto bias = std::make_shared<Variable>(mlCore::Tensor({1, 2}, {0.1, -0.2}));
+	const auto product = binaryOperations::matmul(input, weight);
+	const auto shifted = binaryOperations::add(product, bias);
+	const auto output = nodesActivations::sigmoid(shifted);
+
+	graph_->activate();
+
+	for(const auto& node : std::vector<NodePtr>{input, weight, bias, product, shifted, output})
+	{
+		graph_->addNode(node);
+	}
+
+	ExecutionContext context;
+
+	// the graph has to be compiled before it is shared by the runs
+	ASSERT_THROW(graph_->forwardPass(context), std::runtime_error);
+
+	graph_->compile();
+
+	// computes the expected results with the values kept in the nodes
+	const auto computeExpected = [this, &input, &output, &weight](const double inputScale) {
+		graph_->clearGradients();
+		graph_->forwardPass({{input, mlCore::Tensor({1, 2}, {inputScale, -inputScale})}});
+		graph_->computeGradients(output);
+
+		return std::make_pair(output->getValue(), graph_->getGradientByNodeId(weight->getIndex()));
+	};
+
+	const auto checkEqual = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+	};
+
+	std::vector<std::pair<mlCore::Tensor, mlCore::Tensor>> expected;
+
+	for(size_t threadIdx = 0; threadIdx < 8; threadIdx++)
+	{
+		expected.push_back(computeExpected(static_cast<double>(threadIdx)));
+	}
+
+	const auto nodeValue = output->getValue();
+
+	// each thread runs the shared graph several times with its own context
+	std::vector<std::pair<mlCore::Tensor, mlCore::Tensor>> results(expected.size());
+	std::vector<std::thread> threads;
+
+	for(size_t threadIdx = 0; threadIdx < expected.size(); threadIdx++)
+	{
+		threads.emplace_back([this, threadIdx, &results, &input, &output, &weight]() {
+			ExecutionContext threadContext;
+			const mlCore::Tensor inputValue({1, 2}, {static_cast<double>(threadIdx), -static_cast<double>(threadIdx)});
+
+			for(size_t runIdx = 0; runIdx < 20; runIdx++)
+			{
+				threadContext.clearGradients();
+				graph_->forwardPass(threadContext, {{input, inputValue}});
+				graph_->computeGradients(threadContext, output);
+			}
+
+			results[threadIdx] = {threadContext.getValue(output), threadContext.getGradient(weight)};
+		});
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	for(size_t threadIdx = 0; threadIdx < expected.size(); threadIdx++)
+	{
+		checkEqual(results[threadIdx].first, expected[threadIdx].first);
+		checkEqual(results[threadIdx].second, expected[threadIdx].second);
+	}
+
+	// the nodes are not modified by the runs with the contexts
+	checkEqual(output->getValue(), nodeValue);
+
+	// the context keeps the fed placeholders and accumulates the gradients until cleared
+	graph_->forwardPass(context, {{input, mlCore::Tensor({1, 2}, {3.0, -3.0})}});
+	graph_->computeGradients(context, output);
+	graph_->forwardPass(context);
+	graph_->computeGradients(context, output);
+
+	checkEqual(context.getValue(output), expected[3].first);
+	checkEqual(context.getGradient(weight), expected[3].second * mlCore::Tensor(2.0));
+	checkEqual(context.getValue(weight), weight->getValue());
+	ASSERT_FALSE(context.hasGradient(input));
+
+	context.clearGradients();
+
+	ASSERT_FALSE(context.hasGradient(weight));
+	ASSERT_THROW(context.getGradient(weight), std::runtime_error);
+}
+
+TEST_F(TestComputationGraph, testMemoryEstimate)
+{
+	using namespace mlCore::autoDiff;
+
+	// relu reads its input during backpropagation, while sigmoid reads its own value
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 3});
+	const auto doubled = binaryOperations::add(input, input);
+	const auto firstRelu = nodesActivations::relu(doubled);
+	const auto firstSigmoid = nodesActivations::sigmoid(firstRelu);
+	const auto secondRelu = nodesActivations::relu(firstSigmoid);
+	const auto output = nodesActivations::sigmoid(secondRelu);
+
+	graph_->activate();
+
+	for(const auto& node : std::vector<NodePtr>{input, doubled, firstRelu, firstSigmoid, secondRelu, output})
+	{
+		graph_->addNode(node);
+	}
+
+	constexpr size_t valueBytes = 6 * sizeof(double);
+
+	// each value dies right after its consumer, so two buffers are used in turns
+	const auto inferencePlan = graph_->estimateMemory(LivenessMode::INFERENCE);
+
+	ASSERT_EQ(inferencePlan.totalBytes, 5 * valueBytes);
+	ASSERT_EQ(inferencePlan.peakBytes, 2 * valueBytes);
+	ASSERT_EQ(inferencePlan.bufferBytes.size(), 2);
+	ASSERT_EQ(inferencePlan.getBuffersBytes(), 2 * valueBytes);
+	ASSERT_EQ(inferencePlan.bufferIndices[graph_->compile().findSlot(input.get()).value()], MemoryEstimate::NO_BUFFER);
+
+	// the values read by the derivatives outlive the forward pass
+	const auto trainingPlan = graph_->estimateMemory(LivenessMode::TRAINING);
+
+	ASSERT_EQ(trainingPlan.peakBytes, 4 * valueBytes);
+	ASSERT_EQ(trainingPlan.bufferBytes.size(), 4);
+
+	// the shapes are inferred from the placeholders' shapes
+	const auto resizedPlan = graph_->estimateMemory(LivenessMode::INFERENCE, {{input, {4, 3}}});
+
+	ASSERT_EQ(resizedPlan.peakBytes, 4 * valueBytes);
+
+	const auto& plan = graph_->compile();
+	const auto shapes = plan.inferShapes({{plan.findSlot(input.get()).value(), {4, 3}}});
+
+	ASSERT_EQ(shapes[plan.findSlot(output.get()).value()], std::vector<size_t>({4, 3}));
+
+	const mlCore::Tensor inputValue({2, 3}, {-1.0, 0.5, 2.0, -0.25, 3.0, 0.0});
+
+	ExecutionContext fullContext;
+	graph_->forwardPass(fullContext, {{input, inputValue}});
+	graph_->computeGradients(fullContext, output, {input});
+
+	// the contexts drop the dead values during the runs
+	ExecutionContext inferenceContext;
+	inferenceContext.setLivenessMode(LivenessMode::INFERENCE);
+	graph_->forwardPass(inferenceContext, {{input, inputValue}});
+
+	ASSERT_TRUE(std::equal(inferenceContext.getValue(output).begin(),
+						   inferenceContext.getValue(output).end(),
+						   fullContext.getValue(output).begin()));
+	ASSERT_THROW(inferenceContext.getValue(doubled), std::runtime_error);
+	ASSERT_THROW(inferenceContext.getValue(secondRelu), std::runtime_error);
+
+	ExecutionContext trainingContext;
+	trainingContext.setLivenessMode(LivenessMode::TRAINING);
+	graph_->forwardPass(trainingContext, {{input, inputValue}});
+
+	ASSERT_NO_THROW(trainingContext.getValue(doubled));
+	ASSERT_THROW(trainingContext.getValue(firstRelu), std::runtime_error);
+
+	graph_->computeGradients(trainingContext, output, {input});
+
+	ASSERT_TRUE(std::equal(trainingContext.getGradient(input).begin(),
+						   trainingContext.getGradient(input).end(),
+						   fullContext.getGradient(input).begin()));
+
+	// the backward pass drops the values after their last readers and the gradients of the operators
+	ASSERT_THROW(trainingContext.getValue(doubled), std::runtime_error);
+	ASSERT_NO_THROW(trainingContext.getValue(output));
+	ASSERT_TRUE(fullContext.hasGradient(firstRelu));
+	ASSERT_FALSE(trainingContext.hasGradient(firstRelu));
+
+	// the passes keeping the values in the nodes drop them as well, also when run concurrently
+	graph_->setLivenessMode(LivenessMode::TRAINING);
+
+	for(const auto& threadPool : {std::shared_ptr<utilities::ThreadPool>(), std::make_shared<utilities::ThreadPool>(2)})
+	{
+		graph_->setInterOpThreadPool(threadPool);
+		graph_->clearGradients();
+		graph_->forwardPass({{input, inputValue}});
+
+		ASSERT_TRUE(firstRelu->getValue().shape().empty());
+		ASSERT_EQ(doubled->getValue().shape(), std::vector<size_t>({2, 3}));
+
+		graph_->computeGradients(output, {input});
+
+		ASSERT_TRUE(doubled->getValue().shape().empty());
+		ASSERT_TRUE(std::equal(output->getValue().begin(), output->getValue().end(), fullContext.getValue(output).begin()));
+		ASSERT_TRUE(std::equal(graph_->getGradientByNodeId(input->getIndex()).begin(),
+							   graph_->getGradientByNodeId(input->getIndex()).end(),
+							   fullContext.getGradient(input).begin()));
+		ASSERT_FALSE(graph_->hasGradient(firstRelu->getIndex()));
+	}
+}
+
+TEST_F(TestComputationGraph, testGradientCheckpointing)
+{
+	using namespace mlCore::autoDiff;
+
+	// a deep chain with a skip connection crossing the segments between the checkpoints
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3}, {0.5, -1.5, 2.0}));
+
+	std::vector<NodePtr> chain{binaryOperations::multiply(input, weight)};
+
+	for(size_t layerIdx = 1; layerIdx < 48; layerIdx++)
+	{
+		const auto& previous = chain.back();
+
+		chain.push_back((layerIdx % 2 == 0) ? binaryOperations::multiply(previous, weight) : nodesActivations::sigmoid(previous));
+	}
+
+	const auto output = binaryOperations::add(chain.back(), chain[5]);
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->compile();
+
+	const mlCore::Tensor inputValue({3}, {1.0, -0.5, 0.25});
+
+	ExecutionContext fullContext;
+	graph_->forwardPass(fullContext, {{input, inputValue}});
+	graph_->computeGradients(fullContext, output);
+
+	const auto checkEqual = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+	};
+
+	// the recomputed values are the same, so are the gradients
+	const auto checkRun = [&](ExecutionContext& context, const std::vector<NodePtr>& keptNodes) {
+		graph_->forwardPass(context, {{input, inputValue}});
+
+		checkEqual(context.getValue(output), fullContext.getValue(output));
+
+		const auto hasValue = [&context](const NodePtr& node) {
+			try
+			{
+				context.getValue(node);
+				return true;
+			}
+			catch(const std::runtime_error&)
+			{
+				return false;
+			}
+		};
+
+		// only the checkpoints and the outputs are kept after the forward pass
+		for(const auto& node : chain)
+		{
+			const bool isKept = std::find(keptNodes.cbegin(), keptNodes.cend(), node) != keptNodes.cend();
+
+			ASSERT_EQ(hasValue(node), isKept);
+		}
+
+		graph_->computeGradients(context, output);
+
+		checkEqual(context.getGradient(weight), fullContext.getGradient(weight));
+		ASSERT_THROW(context.getValue(chain[22]), std::runtime_error);
+	};
+
+	ExecutionContext manualContext;
+	manualContext.setCheckpointing(CheckpointPolicy::MANUAL, {chain[15], chain[30]});
+	checkRun(manualContext, {chain[15], chain[30]});
+
+	// 49 operators give a checkpoint every 7 of them
+	ExecutionContext automaticContext;
+	automaticContext.setCheckpointing(CheckpointPolicy::SQRT_N);
+
+	std::vector<NodePtr> automaticCheckpoints;
+
+	for(size_t instructionIdx = 6; instructionIdx < chain.size(); instructionIdx += 7)
+	{
+		automaticCheckpoints.push_back(chain[instructionIdx]);
+	}
+
+	checkRun(automaticContext, automaticCheckpoints);
+
+	// the values recomputed for a dropped root are dropped after the pass as well
+	graph_->computeGradients(manualContext, chain[40]);
+
+	ASSERT_THROW(manualContext.getValue(chain[40]), std::runtime_error);
+	ASSERT_THROW(manualContext.getValue(chain[35]), std::runtime_error);
+	ASSERT_NO_THROW(manualContext.getValue(chain[30]));
+
+	ExecutionContext invalidContext;
+	invalidContext.setCheckpointing(CheckpointPolicy::MANUAL, {std::make_shared<Variable>(mlCore::Tensor({1}, 1.0))});
+
+	ASSERT_THROW(graph_->forwardPass(invalidContext, {{input, inputValue}}), std::runtime_error);
+}
+
+TEST_F(TestComputationGraph, testElementwiseFusion)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3, 3}, {0.5, -1.5, 2.0, 1.0, 0.25, -0.5, -1.0, 0.75, 1.5}));
+	const auto bias = std::make_shared<Variable>(mlCore::Tensor({2, 3}, {0.1, -0.2, 0.3, -0.4, 0.5, -0.6}));
+	const auto exponent = std::make_shared<Variable>(mlCore::Tensor({2, 3}, {0.5, 1.0, 1.5, 2.0, 0.75, 1.25}));
+	const auto scale = std::make_shared<Variable>(mlCore::Tensor({3}, {2.0, -1.0, 0.5}));
+	const auto rowBias = std::make_shared<Variable>(mlCore::Tensor({3}, {0.5, -0.25, 1.0}));
+
+	const auto hidden = binaryOperations::matmul(input, weight);
+
+	// the activation is read by two operators, so it ends its own chain
+	const auto activation = nodesActivations::sigmoid(binaryOperations::add(hidden, bias));
+	const auto logarithm = unaryOperations::ln(binaryOperations::add(binaryOperations::power(activation, exponent), exponent));
+	const auto flatOutput = binaryOperations::divide(
+		nodesActivations::relu(binaryOperations::subtract(logarithm, activation)), exponent);
+
+	// the broadcasted scale and `[N, M] + [M]` bias are read with zero strides by the same loops
+	const auto broadcastOutput = binaryOperations::multiply(nodesActivations::sigmoid(hidden), scale);
+	const auto biasedOutput =
+		nodesActivations::relu(binaryOperations::multiply(binaryOperations::add(input, rowBias), rowBias));
+
+	graph_->activate();
+	graph_->addNode(flatOutput);
+	graph_->addNode(broadcastOutput);
+	graph_->addNode(biasedOutput);
+
+	const mlCore::Tensor inputValue({2, 3}, {1.0, -0.5, 0.25, 0.75, 2.0, -1.25});
+	const std::vector<NodePtr> variables{weight, bias, exponent, scale, rowBias};
+
+	// values of the outputs followed by the gradients of the variables
+	const auto run = [&]() {
+		graph_->clearGradients();
+		graph_->forwardPass({{input, inputValue}});
+		graph_->computeGradients(flatOutput);
+		graph_->computeGradients(broadcastOutput);
+		graph_->computeGradients(biasedOutput);
+
+		std::vector<mlCore::Tensor> results{flatOutput->getValue(), broadcastOutput->getValue(), biasedOutput->getValue()};
+
+		for(const auto& variable : variables)
+		{
+			results.push_back(graph_->getGradientByNodeId(variable->getIndex()));
+		}
+
+		return results;
+	};
+
+	const auto checkNear = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+
+		for(auto resultIter = result.begin(), expectedIter = expected.begin(); resultIter != result.end();
+			resultIter++, expectedIter++)
+		{
+			ASSERT_NEAR(*resultIter, *expectedIter, 1e-12);
+		}
+	};
+
+	const auto expectedResults = run();
+
+	graph_->setCompileOptions({.fuseElementwise = true});
+
+	const auto& plan = graph_->compile();
+	const auto& instructions = plan.getInstructions();
+
+	ASSERT_EQ(instructions.size(), 5);
+	ASSERT_EQ(std::count_if(instructions.cbegin(),
+							instructions.cend(),
+							[](const Instruction& instruction) { return instruction.opCode == OpCode::FUSED; }),
+			  4);
+
+	const auto& kernels = plan.getFusedKernels();
+	const auto longestKernel = std::max_element(kernels.cbegin(), kernels.cend(), [](const auto& lhs, const auto& rhs) {
+		return lhs.getSteps().size() < rhs.getSteps().size();
+	});
+
+	ASSERT_EQ(longestKernel->getSteps().size(), 6);
+	ASSERT_EQ(longestKernel->getInputs().size(), 2);
+
+	const auto fusedResults = run();
+
+	for(size_t resultIdx = 0; resultIdx < expectedResults.size(); resultIdx++)
+	{
+		checkNear(fusedResults[resultIdx], expectedResults[resultIdx]);
+	}
+
+	// the runs with a context give the same results and compute no values inside of the chains
+	ExecutionContext context;
+	graph_->forwardPass(context, {{input, inputValue}});
+	graph_->computeGradients(context, flatOutput);
+	graph_->computeGradients(context, broadcastOutput);
+	graph_->computeGradients(context, biasedOutput);
+
+	checkNear(context.getValue(flatOutput), expectedResults[0]);
+	checkNear(context.getValue(broadcastOutput), expectedResults[1]);
+	checkNear(context.getValue(biasedOutput), expectedResults[2]);
+
+	for(size_t variableIdx = 0; variableIdx < variables.size(); variableIdx++)
+	{
+		checkNear(context.getGradient(variables[variableIdx]), expectedResults[3 + variableIdx]);
+	}
+
+	checkNear(context.getValue(activation), activation->getValue());
+	ASSERT_THROW(context.getValue(logarithm), std::runtime_error);
+}
+
+TEST_F(TestComputationGraph, testConstantFoldingAndCommonSubexpressions)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3}, {0.5, -1.5, 2.0}));
+	const auto offset = std::make_shared<Constant>(mlCore::Tensor({3}, {1.0, 2.0, 3.0}));
+	const auto shift = std::make_shared<Constant>(mlCore::Tensor({3}, {0.5, 0.25, 0.125}));
+
+	const auto folded = unaryOperations::ln(binaryOperations::add(offset, shift));
+
+	// the duplicates are found regardless of the order of the multiplication's operands
+	const auto activation = nodesActivations::sigmoid(binaryOperations::multiply(input, weight));
+	const auto duplicate = nodesActivations::sigmoid(binaryOperations::multiply(weight, input));
+	const auto output =
+		binaryOperations::add(binaryOperations::add(activation, duplicate), binaryOperations::multiply(input, folded));
+
+	graph_->activate();
+	graph_->addNode(output);
+
+	const mlCore::Tensor inputValue({3}, {1.0, -0.5, 0.25});
+
+	ASSERT_EQ(graph_->compile().getInstructions().size(), 9);
+
+	graph_->forwardPass({{input, inputValue}});
+	graph_->computeGradients(output);
+
+	const auto expectedOutput = output->getValue();
+	const auto expectedGradient = graph_->getGradientByNodeId(weight->getIndex());
+	const auto expectedFolded = folded->getValue();
+
+	// the folded value is computed by the compilation
+	folded->getValue() = mlCore::Tensor({3}, 0.0);
+
+	graph_->clearGradients();
+	graph_->setCompileOptions({.foldConstants = true, .eliminateCommonSubexpressions = true});
+
+	// two folded operators and two duplicates are removed
+	const auto& plan = graph_->compile();
+
+	ASSERT_EQ(plan.getInstructions().size(), 5);
+	ASSERT_EQ(plan.findSlot(duplicate.get()), plan.findSlot(activation.get()));
+
+	const auto checkEqual = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+	};
+
+	checkEqual(folded->getValue(), expectedFolded);
+
+	graph_->forwardPass({{input, inputValue}});
+	graph_->computeGradients(output);
+
+	checkEqual(output->getValue(), expectedOutput);
+	checkEqual(graph_->getGradientByNodeId(weight->getIndex()), expectedGradient);
+	checkEqual(graph_->getGradientByNodeId(duplicate->getIndex()), graph_->getGradientByNodeId(activation->getIndex()));
+	ASSERT_FALSE(graph_->hasGradient(folded->getIndex()));
+
+	ExecutionContext context;
+	graph_->forwardPass(context, {{input, inputValue}});
+	graph_->computeGradients(context, output);
+
+	checkEqual(context.getValue(output), expectedOutput);
+	checkEqual(context.getValue(duplicate), context.getValue(activation));
+	checkEqual(context.getGradient(weight), expectedGradient);
+}
+
+TEST_F(TestComputationGraph, testIncrementalForwardPass)
+{
+	using namespace mlCore::autoDiff;
+
+	// a frozen feature extractor feeding a small head
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{3});
+	const auto target = std::make_shared<Placeholder>(std::vector<size_t>{3});
+	const auto extractorWeight = std::make_shared<Variable>(mlCore::Tensor({3}, {0.5, -1.5, 2.0}));
+	const auto headWeight = std::make_shared<Variable>(mlCore::Tensor({3}, {1.0, 2.0, -1.0}));
+
+	const auto features = nodesActivations::sigmoid(binaryOperations::multiply(input, extractorWeight));
+	const auto output = binaryOperations::add(binaryOperations::multiply(features, headWeight), target);
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->setIncrementalForward(true);
+	graph_->setInterOpThreadPool(std::make_shared<utilities::ThreadPool>(2));
+
+	ASSERT_TRUE(graph_->isIncrementalForward());
+
+	const mlCore::Tensor inputValue({3}, {1.0, -0.5, 0.25});
+
+	graph_->forwardPass({{input, inputValue}, {target, mlCore::Tensor({3}, 0.0)}});
+
+	const auto checkEqual = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+	};
+
+	const auto computeOutput = [&]() { return features->getValue() * headWeight->getValue() + target->getValue(); };
+	const auto expectedFeatures = features->getValue();
+
+	// the weight changed without being marked shows which operators are run
+	extractorWeight->getValue() = mlCore::Tensor({3}, {1.0, 1.0, 1.0});
+
+	// the input fed again shares its storage with the placeholder's value, so it is not compared element by element
+	ASSERT_TRUE(input->getValue().sharesStorage(inputValue));
+
+	graph_->forwardPass({{input, inputValue}, {target, mlCore::Tensor({3}, 1.0)}});
+
+	checkEqual(features->getValue(), expectedFeatures);
+	checkEqual(output->getValue(), computeOutput());
+
+	extractorWeight->markChanged();
+	graph_->forwardPass();
+
+	checkEqual(features->getValue(), mlCore::TensorOperations::sigmoid(inputValue));
+	checkEqual(output->getValue(), computeOutput());
+
+	// the full pass runs all operators regardless of the changes
+	headWeight->getValue() = mlCore::Tensor({3}, 2.0);
+
+	graph_->forwardPass();
+	checkEqual(output->getValue(), mlCore::Tensor({3}, {1.0, 2.0, -1.0}) * features->getValue() + target->getValue());
+
+	graph_->forwardPass({}, true);
+	checkEqual(output->getValue(), computeOutput());
+
+	// a node added to the graph is computed by the next pass
+	const auto loss = binaryOperations::multiply(output, output);
+	graph_->addNode(loss);
+	graph_->forwardPass();
+
+	checkEqual(loss->getValue(), output->getValue() * output->getValue());
+}
+
+TEST_F(TestComputationGraph, testLazyConstruction)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3, 4}, 0.5));
+	const auto unknownInput = std::make_shared<Placeholder>();
+
+	NodePtr hidden;
+	NodePtr activation;
+	NodePtr unknown;
+
+	{
+		const ConstructionModeScope scope(ConstructionMode::LAZY);
+
+		ASSERT_EQ(getCurrentConstructionMode(), ConstructionMode::LAZY);
+
+		hidden = binaryOperations::matmul(input, weight);
+		activation = nodesActivations::sigmoid(hidden);
+		unknown = binaryOperations::add(unknownInput, weight);
+
+		// the shapes are checked while building the graph
+		ASSERT_THROW(binaryOperations::add(hidden, std::make_shared<Variable>(mlCore::Tensor({3}, 1.0))),
+					 std::runtime_error);
+		ASSERT_THROW(binaryOperations::matmul(weight, input), std::runtime_error);
+	}
+
+	ASSERT_EQ(getCurrentConstructionMode(), ConstructionMode::EAGER);
+
+	ASSERT_TRUE(activation->isDeferred());
+	ASSERT_EQ(activation->getDeferredShape(), std::vector<size_t>({2, 4}));
+	ASSERT_TRUE(unknown->isDeferred());
+	ASSERT_FALSE(unknown->getDeferredShape());
+
+	// the operators built eagerly on the deferred ones are deferred as well
+	const auto output = binaryOperations::multiply(activation, activation);
+
+	ASSERT_TRUE(output->isDeferred());
+	ASSERT_EQ(output->getDeferredShape(), std::vector<size_t>({2, 4}));
+
+	graph_->activate();
+	graph_->addNode(output);
+
+	const mlCore::Tensor inputValue({2, 3}, {1.0, -0.5, 0.25, 0.75, 2.0, -1.25});
+
+	graph_->forwardPass({{input, inputValue}});
+
+	ASSERT_FALSE(output->isDeferred());
+	ASSERT_FALSE(hidden->isDeferred());
+
+	const auto expectedActivation = nodesActivations::sigmoid(binaryOperations::matmul(input, weight))->getValue();
+	const auto expectedOutput = expectedActivation * expectedActivation;
+
+	ASSERT_EQ(output->getValue().shape(), expectedOutput.shape());
+	ASSERT_TRUE(std::equal(output->getValue().begin(), output->getValue().end(), expectedOutput.begin()));
+}
+
+TEST_F(TestComputationGraph, testProfiling)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3, 4}, 0.5));
+
+	const auto hidden = binaryOperations::matmul(input, weight);
+	hidden->setName("hidden");
+	const auto activation = nodesActivations::relu(hidden);
+	const auto loss = binaryOperations::multiply(activation, activation);
+
+	const auto profiler = std::make_shared<GraphProfiler>();
+
+	graph_->activate();
+	graph_->addNode(loss);
+	graph_->setProfiler(profiler);
+
+	ASSERT_EQ(graph_->getProfiler(), profiler);
+
+	graph_->forwardPass({{input, mlCore::Tensor({2, 3}, 1.0)}});
+	graph_->computeGradients(loss);
+
+	const auto events = profiler->getEvents();
+
+	ASSERT_EQ(events.size(), 6);
+
+	const auto findEvent = [&events](const ProfiledPass pass, const std::string& opName) {
+		const auto event = std::find_if(events.cbegin(), events.cend(), [pass, &opName](const ProfileEvent& event) {
+			return (event.pass == pass) && (event.opName == opName);
+		});
+
+		EXPECT_NE(event, events.cend());
+
+		return *event;
+	};
+
+	const auto forwardMatmul = findEvent(ProfiledPass::FORWARD, "MATMUL");
+
+	ASSERT_EQ(forwardMatmul.nodeName, "hidden");
+	ASSERT_EQ(forwardMatmul.nodeId, hidden->getIndex());
+	ASSERT_EQ(forwardMatmul.inputShapes, (std::vector<std::vector<size_t>>{{2, 3}, {3, 4}}));
+	ASSERT_EQ(forwardMatmul.outputShape, (std::vector<size_t>{2, 4}));
+	ASSERT_GE(forwardMatmul.allocatedBytes, 2 * 4 * sizeof(double));
+
+	// only the derivative with respect to the weight is computed
+	const auto backwardMatmul = findEvent(ProfiledPass::BACKWARD, "MATMUL");
+
+	ASSERT_EQ(backwardMatmul.inputShapes, (std::vector<std::vector<size_t>>{{3, 4}}));
+	ASSERT_EQ(backwardMatmul.outputShape, (std::vector<size_t>{2, 4}));
+	ASSERT_GE(findEvent(ProfiledPass::FORWARD, "RELU").start, forwardMatmul.start + forwardMatmul.duration);
+
+	std::ostringstream trace;
+	profiler->writeChromeTrace(trace);
+
+	ASSERT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+	ASSERT_NE(trace.str().find("\"name\": \"hidden\", \"cat\": \"backward\", \"ph\": \"X\""), std::string::npos);
+	ASSERT_NE(trace.str().find("\"inputShapes\": \"(2, 3) (3, 4)\""), std::string::npos);
+	ASSERT_NE(trace.str().find("\"name\": \"RELU#" + std::to_string(activation->getIndex()) + "\""), std::string::npos);
+
+	std::ostringstream summary;
+	profiler->writeSummary(summary);
+
+	ASSERT_NE(summary.str().find("MATMUL"), std::string::npos);
+	ASSERT_NE(summary.str().find(fmt::format("hidden #{} (MATMUL)", hidden->getIndex())), std::string::npos);
+
+	// the disabled profiler records nothing
+	profiler->clear();
+	graph_->setProfiler(nullptr);
+	graph_->forwardPass({{input, mlCore::Tensor({2, 3}, 2.0)}});
+
+	ASSERT_TRUE(profiler->getEvents().empty());
+}
+
+TEST_F(TestComputationGraph, testPlanCache)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{4, 3});
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({3, 2}, 0.5));
+	const auto output = nodesActivations::relu(binaryOperations::matmul(input, weight));
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->setPlanCacheOptions({.capacity = 2, .batchBuckets = {32, 8}});
+
+	const auto& planCache = graph_->getPlanCache();
+	const size_t outputSlot = *graph_->compile().findSlot(output.get());
+
+	ASSERT_EQ(planCache.getOptions().batchBuckets, (std::vector<size_t>{8, 32}));
+	ASSERT_EQ(planCache.padShape({5, 3}), (std::vector<size_t>{8, 3}));
+	ASSERT_EQ(planCache.padShape({100, 3}), (std::vector<size_t>{100, 3}));
+
+	const auto checkPlan = [&](const size_t batchSize, const size_t paddedSize, const size_t nHits, const size_t nMisses) {
+		const auto& shapedPlan = graph_->getShapedPlan(LivenessMode::INFERENCE, {{input, {batchSize, 3}}});
+
+		ASSERT_EQ(shapedPlan.shapes[outputSlot], (std::vector<size_t>{paddedSize, 2}));
+		ASSERT_EQ(shapedPlan.memoryEstimate.peakBytes,
+				  graph_->compile().estimateMemory(shapedPlan.shapes, LivenessMode::INFERENCE).peakBytes);
+		ASSERT_EQ(planCache.getHitsCount(), nHits);
+		ASSERT_EQ(planCache.getMissesCount(), nMisses);
+	};
+
+	// the batches falling into one bucket share the plan
+	checkPlan(5, 8, 0, 1);
+	checkPlan(7, 8, 1, 1);
+	checkPlan(20, 32, 1, 2);
+
+	// the least recently used plan is evicted
+	checkPlan(100, 100, 1, 3);
+	checkPlan(32, 32, 2, 3);
+	checkPlan(8, 8, 2, 4);
+
+	ASSERT_EQ(planCache.getSize(), 2);
+
+	// the modes are cached separately
+	graph_->estimateMemory(LivenessMode::TRAINING, {{input, {8, 3}}});
+	ASSERT_EQ(planCache.getMissesCount(), 5);
+
+	// the structure's change drops the cached plans
+	graph_->addNode(binaryOperations::multiply(output, output));
+	ASSERT_EQ(planCache.getSize(), 0);
+}
+
+TEST_F(TestComputationGraph, testCommonSubexpressionsWithChangedInputs)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2}, {1.0, 2.0}));
+	const auto square = binaryOperations::multiply(weight, weight);
+	const auto duplicate = binaryOperations::multiply(weight, weight);
+	const auto output = binaryOperations::add(square, duplicate);
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->setCompileOptions({.eliminateCommonSubexpressions = true});
+
+	ASSERT_EQ(graph_->compile().getInstructions().size(), 2);
+
+	const auto checkEqual = [](const mlCore::Tensor& result, const mlCore::Tensor& expected) {
+		ASSERT_EQ(result.shape(), expected.shape());
+		ASSERT_TRUE(std::equal(result.begin(), result.end(), expected.begin(), expected.end()));
+	};
+
+	graph_->forwardPass();
+	checkEqual(output->getValue(), mlCore::Tensor({2}, {2.0, 8.0}));
+
+	// the consumers of the removed duplicate read the value computed in the plan
+	weight->setValue(mlCore::Tensor({2}, {3.0, 4.0}));
+	graph_->forwardPass();
+
+	checkEqual(output->getValue(), mlCore::Tensor({2}, {18.0, 32.0}));
+	checkEqual(duplicate->getValue(), mlCore::Tensor({2}, {9.0, 16.0}));
+
+	graph_->computeGradients(output);
+
+	checkEqual(graph_->getGradientByNodeId(weight->getIndex()), mlCore::Tensor({2}, {12.0, 16.0}));
+	checkEqual(graph_->getGradientByNodeId(duplicate->getIndex()), graph_->getGradientByNodeId(square->getIndex()));
+
+	const auto gradients = graph_->getGradients();
+	const auto hasGradient = [&gradients](const NodePtr& node) {
+		return std::any_of(gradients.cbegin(), gradients.cend(), [&node](const auto& nodeGradient) {
+			return nodeGradient.first == node;
+		});
+	};
+
+	ASSERT_TRUE(hasGradient(square));
+	ASSERT_TRUE(hasGradient(duplicate));
+}
+
+TEST_F(TestComputationGraph, testStopGradientWithRequestedNodes)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto weight = std::make_shared<Variable>(mlCore::Tensor({2}, {1.0, 2.0}));
+	const auto stopped = binaryOperations::multiply(weight, weight);
+	stopped->setRequiresGrad(false);
+	const auto output = binaryOperations::add(stopped, weight);
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->forwardPass();
+
+	const auto checkGradient = [this, &weight]() {
+		const auto& gradient = graph_->getGradientByNodeId(weight->getIndex());
+		const mlCore::Tensor expected({2}, 1.0);
+
+		ASSERT_TRUE(std::equal(gradient.begin(), gradient.end(), expected.begin(), expected.end()));
+	};
+
+	graph_->computeGradients(output);
+	checkGradient();
+
+	// requesting the gradient explicitly does not pass through the stopped operator either
+	graph_->clearGradients();
+	graph_->computeGradients(output, {weight});
+	checkGradient();
+}
+
+TEST_F(TestComputationGraph, testPlanCacheWithUnbatchedPlaceholders)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{4, 3});
+	const auto scale = std::make_shared<Placeholder>(std::vector<size_t>{3});
+	const auto output = binaryOperations::multiply(input, scale);
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->setPlanCacheOptions({.batchBuckets = {8}});
+
+	// only the shapes given for the batched placeholders are padded
+	const auto& shapedPlan = graph_->getShapedPlan(LivenessMode::INFERENCE, {{input, {5, 3}}});
+	const auto& plan = graph_->compile();
+
+	ASSERT_EQ(shapedPlan.shapes[*plan.findSlot(scale.get())], (std::vector<size_t>{3}));
+	ASSERT_EQ(shapedPlan.shapes[*plan.findSlot(output.get())], (std::vector<size_t>{8, 3}));
+	ASSERT_NO_THROW(graph_->estimateMemory(LivenessMode::INFERENCE, {{input, {5, 3}}}));
+}
+
+TEST_F(TestComputationGraph, testPlanCacheBuffers)
+{
+	using namespace mlCore::autoDiff;
+
+	const auto input = std::make_shared<Placeholder>(std::vector<size_t>{2, 3});
+	const auto output =
+		nodesActivations::sigmoid(nodesActivations::relu(nodesActivations::sigmoid(nodesActivations::relu(input))));
+
+	const auto allocator = std::make_shared<TrackingAllocator>(mlCore::getGlobalAllocator());
+
+	graph_->activate();
+	graph_->addNode(output);
+	graph_->setAllocator(allocator);
+	graph_->setLivenessMode(LivenessMode::INFERENCE);
+	graph_->setPlanCacheOptions({.batchBuckets = {8}});
+
+	const double expected = 1.0 / (1.0 + std::exp(-1.0 / (1.0 + std::exp(-0.5))));
+
+	const auto runBatch = [&](const size_t batchSize) {
+		const size_t startBytes = allocator->getAllocatedBytes();
+
+		graph_->forwardPass({{input, mlCore::Tensor({batchSize, 3}, 0.5)}});
+
+		EXPECT_EQ(output->getValue().shape(), (std::vector<size_t>{batchSize, 3}));
+		EXPECT_TRUE(std::all_of(output->getValue().begin(), output->getValue().end(), [expected](const double value) {
+			return std::abs(value - expected) < 1e-12;
+		}));
+
+		return allocator->getAllocatedBytes() - startBytes;
+	};
+
+	// the first batch of the bucket allocates the buffers of the bucket's plan
+	const size_t firstBytes = runBatch(5);
+
+	ASSERT_EQ(graph_->getPlanCache().getMissesCount(), 1);
+
+	// the next batches of the bucket compute the values in the same buffers, except for the output still held
+	const size_t secondBytes = runBatch(7);
+	const size_t thirdBytes = runBatch(6);
+
+	ASSERT_EQ(graph_->getPlanCache().getHitsCount(), 2);
+	ASSERT_LT(secondBytes, firstBytes);
+	ASSERT_LT(thirdBytes, firstBytes);
+
+	// a batch of another bucket gets its own plan
+	runBatch(20);
+
+	ASSERT_EQ(graph_->getPlanCache().getMissesCount(), 2);
+}
+
+} // namespace
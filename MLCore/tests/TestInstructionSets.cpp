@@ -0,0 +1,150 @@
+/**********************
+ * Test suite for 'ai_projects'
+ *
+ * Copyright (c) 2023
+ *
+ * by Wiktor Prosowicz
+ **********************/
+
+#include <MLCore/InstructionSet.h>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+
+#include <MLCore/BasicTensor.h>
+#include <MLCore/TensorInitializers/RangeTensorInitializer.hpp>
+
+namespace
+{
+
+/*****************************
+ *
+ * Test Fixture
+ *
+ *****************************/
+
+class TestInstructionSets : public testing::Test
+{
+protected:
+	void TearDown() override
+	{
+		mlCore::resetInstructionSet();
+	}
+
+	/**
+	 * @brief Checks if tensors have equal shapes and their contents differ at most by relative tolerance.
+	 *
+	 * @param tensor Tested tensor.
+	 * @param reference Tensor computed with plain scalar kernels.
+	 * @param instructionSet Instruction set used to compute the tested tensor.
+	 * @param tolerance Allowed difference relative to the reference value.
+	 */
+	template <typename ValueType>
+	static void checkTensorsClose(const mlCore::BasicTensor<ValueType>& tensor,
+								  const mlCore::BasicTensor<ValueType>& reference,
+								  const mlCore::InstructionSet instructionSet,
+								  const double tolerance)
+	{
+		ASSERT_EQ(tensor.shape(), reference.shape());
+
+		for(auto [tensorIter, referenceIter] = std::tuple{tensor.begin(), reference.begin()}; tensorIter != tensor.end();
+			tensorIter++, referenceIter++)
+		{
+			// fused multiply-add rounds differently than separate operations
+			ASSERT_NEAR(*tensorIter, *referenceIter, tolerance * std::max(1.0, std::abs(double(*referenceIter))))
+				<< fmt::format("Instruction set: '{}'", mlCore::stringifyInstructionSet(instructionSet));
+		}
+	}
+
+	/// Computes matmul and elementwise operations with each of the supported instruction sets and compares the results
+	/// with the ones of the scalar kernels.
+	template <typename ValueType>
+	static void checkKernelsMatchScalarImplementation(const double tolerance)
+	{
+		using mlCore::tensorInitializers::RangeTensorInitializer;
+
+		mlCore::BasicTensor<ValueType> firstTensor(std::vector<size_t>{2, 67, 131});
+		mlCore::BasicTensor<ValueType> secondTensor(std::vector<size_t>{2, 131, 45});
+		mlCore::BasicTensor<ValueType> sameShapeTensor(std::vector<size_t>{2, 67, 131});
+		const mlCore::BasicTensor<ValueType> scalarTensor(ValueType(2.5));
+
+		firstTensor.fill(RangeTensorInitializer<ValueType>(ValueType(-3.0), ValueType(1e-3)));
+		secondTensor.fill(RangeTensorInitializer<ValueType>(ValueType(2.0), ValueType(-1e-3)));
+		sameShapeTensor.fill(RangeTensorInitializer<ValueType>(ValueType(0.5), ValueType(1e-4)));
+
+		auto computeAll = [&]() {
+			return std::vector<mlCore::BasicTensor<ValueType>>{firstTensor.matmul(secondTensor),
+															   firstTensor + sameShapeTensor,
+															   firstTensor - sameShapeTensor,
+															   firstTensor * sameShapeTensor,
+															   firstTensor / sameShapeTensor,
+															   firstTensor + scalarTensor,
+															   firstTensor - scalarTensor,
+															   firstTensor * scalarTensor,
+															   firstTensor / scalarTensor};
+		};
+
+		mlCore::setInstructionSet(mlCore::InstructionSet::SCALAR);
+		const auto references = computeAll();
+
+		for(const auto instructionSet : mlCore::getSupportedInstructionSets())
+		{
+			mlCore::setInstructionSet(instructionSet);
+			const auto results = computeAll();
+
+			for(size_t resultIdx = 0; resultIdx < results.size(); resultIdx++)
+			{
+				checkTensorsClose(results[resultIdx], references[resultIdx], instructionSet, tolerance);
+			}
+		}
+	}
+};
+
+/*****************************
+ *
+ * Particular test calls
+ *
+ *****************************/
+
+TEST_F(TestInstructionSets, testDetectedInstructionSetIsUsedByDefault)
+{
+	const auto supported = mlCore::getSupportedInstructionSets();
+
+	ASSERT_FALSE(supported.empty());
+	ASSERT_EQ(supported.front(), mlCore::InstructionSet::SCALAR);
+	ASSERT_EQ(supported.back(), mlCore::detectInstructionSet());
+
+	if(std::getenv("MLCORE_INSTRUCTION_SET") == nullptr)
+	{
+		ASSERT_EQ(mlCore::getInstructionSet(), mlCore::detectInstructionSet());
+	}
+}
+
+TEST_F(TestInstructionSets, testForcingInstructionSet)
+{
+	for(const auto instructionSet : mlCore::getSupportedInstructionSets())
+	{
+		mlCore::setInstructionSet(instructionSet);
+		ASSERT_EQ(mlCore::getInstructionSet(), instructionSet);
+	}
+
+	if(mlCore::detectInstructionSet() != mlCore::InstructionSet::AVX512)
+	{
+		ASSERT_THROW(mlCore::setInstructionSet(mlCore::InstructionSet::AVX512), std::runtime_error);
+	}
+}
+
+TEST_F(TestInstructionSets, testKernelsMatchScalarImplementation)
+{
+	checkKernelsMatchScalarImplementation<double>(1e-9);
+}
+
+TEST_F(TestInstructionSets, testFloatKernelsMatchScalarImplementation)
+{
+	checkKernelsMatchScalarImplementation<float>(1e-4);
+}
+
+} // namespace
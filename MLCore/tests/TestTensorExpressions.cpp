@@ -0,0 +1,121 @@
+/**********************
+ * Test suite for 'ai_projects'
+ *
+ * Copyright (c) 2023
+ *
+ * by Wiktor Prosowicz
+ **********************/
+
+#include <MLCore/TensorExpressions.h>
+
+#include <gtest/gtest.h>
+
+#include <MLCore/TensorInitializers/RangeTensorInitializer.hpp>
+
+namespace
+{
+
+/*****************************
+ *
+ * Test Fixture
+ *
+ *****************************/
+
+class TestTensorExpressions : public testing::Test
+{
+protected:
+	/// Checks if tensors have equal shapes and contents.
+	static void checkTensorEquality(const mlCore::Tensor& tensor1, const mlCore::Tensor& tensor2)
+	{
+		ASSERT_EQ(tensor1.shape(), tensor2.shape());
+
+		for(auto iter1 = tensor1.begin(), iter2 = tensor2.begin(); iter1 < tensor1.end(); iter1++, iter2++)
+		{
+			EXPECT_DOUBLE_EQ(*iter1, *iter2);
+		}
+	}
+
+	/// Creates tensor filled with consecutive values starting from `start`.
+	static mlCore::Tensor makeRangeTensor(const std::vector<size_t>& shape, const double start = 1.0)
+	{
+		mlCore::Tensor tensor(shape);
+		tensor.fill(mlCore::tensorInitializers::RangeTensorInitializer<double>(start));
+
+		return tensor;
+	}
+};
+
+/*****************************
+ *
+ * Particular test calls
+ *
+ *****************************/
+
+TEST_F(TestTensorExpressions, testEvaluationMatchesEagerOperators)
+{
+	using mlCore::expressions::lazy;
+
+	const auto first = makeRangeTensor({4, 5});
+	const auto second = makeRangeTensor({4, 5}, 3.0);
+	const auto third = makeRangeTensor({4, 5}, -7.0);
+
+	const mlCore::Tensor fused = -lazy(first) / (lazy(second) * second) + third * lazy(first) - 2.0;
+
+	checkTensorEquality(fused, -first / (second * second) + third * first - 2.0);
+
+	// scalars on both sides
+	const mlCore::Tensor withScalars = 1.0 / lazy(second) * 3.0 - (2.0 - lazy(first));
+
+	checkTensorEquality(withScalars, mlCore::Tensor(1.0) / second * 3.0 - (mlCore::Tensor(2.0) - first));
+
+	// assignment to an existing tensor
+	mlCore::Tensor assigned({1});
+	assigned = lazy(first) * first;
+
+	checkTensorEquality(assigned, first * first);
+
+	// scalar tensors
+	const mlCore::Tensor scalar(5.0);
+	const mlCore::Tensor scalarResult = lazy(scalar) * scalar + 1.0;
+
+	ASSERT_TRUE(scalarResult.shape().empty());
+	ASSERT_DOUBLE_EQ(*scalarResult.begin(), 26.0);
+}
+
+TEST_F(TestTensorExpressions, testBroadcasting)
+{
+	using mlCore::expressions::lazy;
+
+	const auto matrix = makeRangeTensor({2, 3, 4});
+	const auto row = makeRangeTensor({4}, -2.0);
+	const auto column = makeRangeTensor({3, 1}, 0.5);
+	const auto single = makeRangeTensor({1, 1, 1}, 3.0);
+
+	checkTensorEquality(lazy(matrix) + row, matrix + row);
+	checkTensorEquality(lazy(column) * row - matrix, column * row - matrix);
+	checkTensorEquality(lazy(row) / single + column, row / single + column);
+	checkTensorEquality(-(lazy(column) - mlCore::Tensor(2.0)), -(column - mlCore::Tensor(2.0)));
+
+	// the shapes are checked when the expression is built
+	const auto incompatible = makeRangeTensor({2, 3});
+
+	ASSERT_THROW(lazy(matrix) + incompatible, std::runtime_error);
+}
+
+TEST_F(TestTensorExpressions, testExpressionOwnsOperands)
+{
+	using mlCore::expressions::lazy;
+
+	auto tensor = makeRangeTensor({3});
+
+	// operands created within the expression outlive the statement
+	const auto expression = lazy(makeRangeTensor({3})) * makeRangeTensor({3}) + tensor;
+
+	// modifying the tensor after building the expression does not affect it
+	tensor += tensor;
+
+	checkTensorEquality(expression.evaluate(), mlCore::Tensor({3}, {2, 6, 12}));
+	checkTensorEquality(tensor, mlCore::Tensor({3}, {2, 4, 6}));
+}
+
+} // namespace